@@ -5,7 +5,12 @@
 /****************************************************************************************/
 
 /** Constructor. **/
-Data::Data(const std::string &parameter_file) : params(parameter_file)
+Data::Data(const std::string &parameter_file) : Data(Input(parameter_file))
+{
+}
+
+/** Constructor. **/
+Data::Data(const Input& input) : params(input), network(new Topology())
 {
 	std::cout << "=> Defining data ..." << std::endl;
 	readNodeFile(params.getNodeFile());
@@ -20,14 +25,38 @@ Data::Data(const std::string &parameter_file) : params(parameter_file)
 	
 }
 
+/** Constructor. **/
+Data::Data(const Data& topology, const Input& input) : params(input), network(topology.network)
+{
+	std::cout << "=> Defining data on a known topology ..." << std::endl;
+	readDemandFile(params.getDemandFile());
+
+	computeMaxPathPerDemand();
+	std::cout << "\t Data was correctly constructed !" << std::endl;
+}
+
+/** Constructor. **/
+Data::Data(const Data& data, const std::vector<int>& demands) : params(data.getInput()), network(data.network)
+{
+	for (unsigned int j = 0; j < demands.size(); j++){
+		const Demand& demand = data.getDemand(demands[j]);
+		this->tabDemands.push_back(Demand((int)j, demand.getName(), demand.getSource(), demand.getTarget(), demand.getMaxLatency(), demand.getBandwidth(), demand.getAvailability()));
+		for (int i = 0; i < demand.getNbVNFs(); i++){
+			tabDemands[j].addVNF(demand.getVNF_i(i));
+		}
+	}
+
+	computeMaxPathPerDemand();
+}
+
 /****************************************************************************************/
 /*										Getters 										*/
 /****************************************************************************************/
 /* Returns the id from the node with the given name. */
 int Data::getIdFromNodeName(const std::string name) const
 {
-	auto search = hashNode.find(name);
-    if (search != hashNode.end()) {
+	auto search = network->hashNode.find(name);
+    if (search != network->hashNode.end()) {
         return search->second;
     } 
 	else {
@@ -40,7 +69,7 @@ int Data::getIdFromNodeName(const std::string name) const
 /* Returns the id from the vnf with the given name. */
 int Data::getIdFromVnfName(const std::string name) const
 {
-	for( const auto& it : hashVnf ) {
+	for( const auto& it : network->hashVnf ) {
 		if (it.first == name){
 			return it.second;
 		}
@@ -110,8 +139,8 @@ void Data::readNodeFile(const std::string filename)
 		double capacity = atof(dataList[i][3].c_str());
 		double avail = atof(dataList[i][4].c_str());
 		double cost = atof(dataList[i][5].c_str());
-		this->tabNodes.push_back(Node(nodeId, nodeName, nodeX, nodeY, capacity, avail, cost));
-		hashNode.insert({nodeName, nodeId});
+		network->tabNodes.push_back(Node(nodeId, nodeName, nodeX, nodeY, capacity, avail, cost));
+		network->hashNode.insert({nodeName, nodeId});
 	}
 
 }
@@ -136,7 +165,7 @@ void Data::readLinkFile(const std::string filename)
 		int target = getIdFromNodeName(dataList[i][2]);
 		double delay = atof(dataList[i][3].c_str());;
 		double bandwidth = atof(dataList[i][4].c_str());
-		this->tabLinks.push_back(Link(linkId, linkName, source, target, delay, bandwidth));
+		network->tabLinks.push_back(Link(linkId, linkName, source, target, delay, bandwidth));
 	}
 }
 
@@ -159,8 +188,8 @@ void Data::readVnfFile(const std::string filename)
 		int vnfId = (int)i - 1;
 		std::string vnfName = dataList[i][0];
 		double resource_consumption = atof(dataList[i][1].c_str());
-		this->tabVnfs.push_back(VNF(vnfId, vnfName, resource_consumption));
-		hashVnf.insert({vnfName, vnfId});
+		network->tabVnfs.push_back(VNF(vnfId, vnfName, resource_consumption));
+		network->hashVnf.insert({vnfName, vnfId});
 	}
 }
 
@@ -201,26 +230,26 @@ void Data::readDemandFile(const std::string filename)
 /* Builds the availability ranking of nodes. */
 void Data::buildNodeRank()
 {
-	availNodeRank.resize(tabNodes.size());
-	for (unsigned int i = 0; i < availNodeRank.size(); i++){
-		availNodeRank[i] = i;
+	network->availNodeRank.resize(network->tabNodes.size());
+	for (unsigned int i = 0; i < network->availNodeRank.size(); i++){
+		network->availNodeRank[i] = i;
 	}
 
     // One by one move boundary of unsorted subarray  
-    for (int i = 0; i < (int)availNodeRank.size()-1; i++)  {  
+    for (int i = 0; i < (int)network->availNodeRank.size()-1; i++)  {  
         
 		// Find the minimum element in unsorted array  
         int min = i;  
-        for (int j = i+1; j < (int)availNodeRank.size(); j++){
-        	if (isMoreAvailable(getNode(availNodeRank[j]), getNode(availNodeRank[min]))){
+        for (int j = i+1; j < (int)network->availNodeRank.size(); j++){
+        	if (isMoreAvailable(getNode(network->availNodeRank[j]), getNode(network->availNodeRank[min]))){
 				min = j;
 			}  
 		}
 
         // Swap the found minimum element with the first element  
-        int temp = availNodeRank[min];  
-		availNodeRank[min] = availNodeRank[i];  
-		availNodeRank[i] = temp;  
+        int temp = network->availNodeRank[min];  
+		network->availNodeRank[min] = network->availNodeRank[i];  
+		network->availNodeRank[i] = temp;  
     }  
 	//printNodeRank();
 }
@@ -231,37 +260,31 @@ void Data::buildGraph()
 	
 	std::cout << "\t Creating graph..." << std::endl;
 	/* Dymanic allocation of graph */
-    graph = new Graph();
-	nodeId = new NodeMap(*graph);
-	lemonNodeId = new NodeMap(*graph);
-	arcId = new ArcMap(*graph);
-	lemonArcId = new ArcMap(*graph);
+    network->graph = new Graph();
+	network->nodeId = new NodeMap(*network->graph);
+	network->lemonNodeId = new NodeMap(*network->graph);
+	network->arcId = new ArcMap(*network->graph);
+	network->lemonArcId = new ArcMap(*network->graph);
 	
-	/* Define nodes */
-	for (unsigned int i = 0; i < tabNodes.size(); i++){
-        Graph::Node n = graph->addNode();
-        setNodeId(n, tabNodes[i].getId());
-        setLemonNodeId(n, graph->id(n));
+	/* Define nodes, indexed by their id so that arcs find their endpoints directly */
+	std::unordered_map<int, Graph::Node> lemonNode;
+	for (unsigned int i = 0; i < network->tabNodes.size(); i++){
+        Graph::Node n = network->graph->addNode();
+        setNodeId(n, network->tabNodes[i].getId());
+        setLemonNodeId(n, network->graph->id(n));
+        lemonNode[network->tabNodes[i].getId()] = n;
     }
 
 	/* Define arcs */
-	for (unsigned int i = 0; i < tabLinks.size(); i++){
-        int source = tabLinks[i].getSource();
-        int target = tabLinks[i].getTarget();
-        Graph::Node sourceNode = lemon::INVALID;
-        Graph::Node targetNode = lemon::INVALID;
-        for (NodeIt v(getGraph()); v != lemon::INVALID; ++v){
-            if(getNodeId(v) == source){
-                sourceNode = v;
-            }
-            if(getNodeId(v) == target){
-                targetNode = v;
-            }
-        }
-        if (targetNode != lemon::INVALID && sourceNode != lemon::INVALID){
-            Arc a = graph->addArc(sourceNode, targetNode);
-            setLemonArcId(a, graph->id(a));
-            setArcId(a, tabLinks[i].getId());
+	for (unsigned int i = 0; i < network->tabLinks.size(); i++){
+        std::unordered_map<int, Graph::Node>::const_iterator source = lemonNode.find(network->tabLinks[i].getSource());
+        std::unordered_map<int, Graph::Node>::const_iterator target = lemonNode.find(network->tabLinks[i].getTarget());
+        if (source != lemonNode.end() && target != lemonNode.end()){
+            Graph::Node sourceNode = source->second;
+            Graph::Node targetNode = target->second;
+            Arc a = network->graph->addArc(sourceNode, targetNode);
+            setLemonArcId(a, network->graph->id(a));
+            setArcId(a, network->tabLinks[i].getId());
         }
     }
 }
@@ -269,8 +292,8 @@ void Data::buildGraph()
 /* Returns the node position on availability ranking. */
 const int Data::getNodeRankPosition (int id) const
 {
-	for (unsigned int i = 0; i < availNodeRank.size(); i++){
-		if (availNodeRank[i] == id)	return i;
+	for (unsigned int i = 0; i < network->availNodeRank.size(); i++){
+		if (network->availNodeRank[i] == id)	return i;
 	}
 	return -1;
 }
@@ -283,12 +306,12 @@ const int Data::getMinNbNodes(double av, double B) const
 	int nb = 0;
 	int i = 0;
 	//std::cout << "Required availability: " << av << std::endl;
-	while(av_prob < av && i < (int)availNodeRank.size()){
-		if (getNode(availNodeRank[i]).getAvailability() <= B){
-			fail_prob *= (1 - getNode(availNodeRank[i]).getAvailability());
+	while(av_prob < av && i < (int)network->availNodeRank.size()){
+		if (getNode(network->availNodeRank[i]).getAvailability() <= B){
+			fail_prob *= (1 - getNode(network->availNodeRank[i]).getAvailability());
 			nb++;
 			av_prob = 1.0 - fail_prob;
-			//std::cout << "Add node " << getNode(availNodeRank[i]).getId() << " with availability " << getNode(availNodeRank[i]).getAvailability() << std::endl;
+			//std::cout << "Add node " << getNode(network->availNodeRank[i]).getId() << " with availability " << getNode(network->availNodeRank[i]).getAvailability() << std::endl;
 		}
 		i++;
 	}
@@ -310,26 +333,61 @@ void Data::computeMaxPathPerDemand()
 	const int NB_DEMANDS = getNbDemands();
 	maxPathsPerDemand.resize(NB_DEMANDS);
 	for (int k = 0; k < NB_DEMANDS; k++){
-		maxPathsPerDemand[k] = getNbNodes();
+		computeMaxPathPerDemand(k);
 	}
+}
+
+/* Builds the upper bound on the number of paths that should route a given demand. */
+void Data::computeMaxPathPerDemand(const int k)
+{
+	maxPathsPerDemand[k] = getNbNodes();
 	if (getInput().getNbPathsUpperBound() == Input::NB_PATHS_UPPER_BOUND_ON){
-		for (int k = 0; k < NB_DEMANDS; k++){
-			const int NB_VNFS = getDemand(k).getNbVNFs();
-			const double REQUIRED_AVAIL = getDemand(k).getAvailability();
-			std::vector<int> least_available_nodes = getNLeastAvailableNodes(NB_VNFS);
-			const double MIN_PATH_AVAIL = getChainAvailability(least_available_nodes);
-
-			double chain_avail = MIN_PATH_AVAIL;
-			//std::cout << "Min path avail"  << ": " << MIN_PATH_AVAIL << std::endl;
-			int nbPaths = 1;
-			while (chain_avail < REQUIRED_AVAIL){
-				nbPaths++;
-				chain_avail = 1 - std::pow(1.0 - MIN_PATH_AVAIL, nbPaths);
-			}
-			maxPathsPerDemand[k] = std::min(maxPathsPerDemand[k], nbPaths);
-			//std::cout << "Max nb paths for demand " << k << ": " << nbPaths << ", " << maxPathsPerDemand[k] << std::endl;
+		const int NB_VNFS = getDemand(k).getNbVNFs();
+		const double REQUIRED_AVAIL = getDemand(k).getAvailability();
+		std::vector<int> least_available_nodes = getNLeastAvailableNodes(NB_VNFS);
+		const double MIN_PATH_AVAIL = getChainAvailability(least_available_nodes);
+
+		double chain_avail = MIN_PATH_AVAIL;
+		//std::cout << "Min path avail"  << ": " << MIN_PATH_AVAIL << std::endl;
+		int nbPaths = 1;
+		while (chain_avail < REQUIRED_AVAIL){
+			nbPaths++;
+			chain_avail = 1 - std::pow(1.0 - MIN_PATH_AVAIL, nbPaths);
 		}
+		maxPathsPerDemand[k] = std::min(maxPathsPerDemand[k], nbPaths);
+		//std::cout << "Max nb paths for demand " << k << ": " << nbPaths << ", " << maxPathsPerDemand[k] << std::endl;
+	}
+}
+
+/* Adds a demand, whose id is set to its position. */
+int Data::addDemand(const Demand& demand)
+{
+	const int k = getNbDemands();
+	this->tabDemands.push_back(Demand(k, demand.getName(), demand.getSource(), demand.getTarget(), demand.getMaxLatency(), demand.getBandwidth(), demand.getAvailability()));
+	for (int i = 0; i < demand.getNbVNFs(); i++){
+		tabDemands[k].addVNF(demand.getVNF_i(i));
+	}
+	maxPathsPerDemand.push_back(0);
+	computeMaxPathPerDemand(k);
+	return k;
+}
+
+/* Removes a demand: it keeps its id, but requests nothing and may not be routed. */
+void Data::removeDemand(const int k)
+{
+	tabDemands[k].setAvailability(0.0);
+	maxPathsPerDemand[k] = 0;
+}
+
+/* Changes the availability requested by a demand and updates its bound on the number of paths. */
+void Data::setDemandAvailability(const int k, const double availability)
+{
+	if (isDemandRemoved(k)){
+		std::cerr << "ERROR: Cannot change the availability of removed demand " << k << "." << std::endl;
+		exit(EXIT_FAILURE);
 	}
+	tabDemands[k].setAvailability(availability);
+	computeMaxPathPerDemand(k);
 }
 
 /* Returns the availability obtained from the placement of a set of nodes in parallel.*/
@@ -347,11 +405,11 @@ const double Data::getParallelAvailability(const std::vector<int>& nodes) const
 /* Returns a vector containing the ids of the n most available nodes. */
 const std::vector<int> Data::getNMostAvailableNodes(int n) const
 {
-	n = std::min(n, (int)availNodeRank.size());
+	n = std::min(n, (int)network->availNodeRank.size());
 	std::vector<int> nodes;
 	nodes.resize(n);
 	for (int i = 0; i < n; i++){
-		nodes[i] = availNodeRank[i];
+		nodes[i] = network->availNodeRank[i];
 	}
 	return nodes;
 }
@@ -364,8 +422,8 @@ const std::vector<int> Data::getNMostAvailableNodes(int n, const std::vector<boo
 	int nb_selected = 0;
 	int i = 0;
 	while (nb_selected < n){
-		if (NODES[availNodeRank[i]] == true){
-			selected_nodes[nb_selected] = availNodeRank[i];
+		if (NODES[network->availNodeRank[i]] == true){
+			selected_nodes[nb_selected] = network->availNodeRank[i];
 			nb_selected++;
 		}
 		i++;
@@ -376,12 +434,12 @@ const std::vector<int> Data::getNMostAvailableNodes(int n, const std::vector<boo
 /* Returns a vector containing the ids of the n least available nodes. */
 const std::vector<int> Data::getNLeastAvailableNodes(int n) const
 {
-	int size = (int)availNodeRank.size();
+	int size = (int)network->availNodeRank.size();
 	n = std::min(n, size);
 	std::vector<int> nodes;
 	nodes.resize(n);
 	for (int i = 0; i < n; i++){
-		nodes[i] = availNodeRank[size-1-i];
+		nodes[i] = network->availNodeRank[size-1-i];
 	}
 	return nodes;
 }
@@ -395,8 +453,8 @@ const std::vector<int> Data::getNLeastAvailableNodes(int n, const std::vector<bo
 	int nb_selected = 0;
 	int i = (int)NODES.size() - 1;
 	while (nb_selected < n){
-		if (NODES[availNodeRank[i]] == true){
-			selected_nodes[nb_selected] = availNodeRank[i];
+		if (NODES[network->availNodeRank[i]] == true){
+			selected_nodes[nb_selected] = network->availNodeRank[i];
 			nb_selected++;
 		}
 		i--;
@@ -477,21 +535,21 @@ void Data::print(){
 
 
 void Data::printNodes(){
-	for (unsigned int i = 0; i < tabNodes.size(); i++){
-        tabNodes[i].print();
+	for (unsigned int i = 0; i < network->tabNodes.size(); i++){
+        network->tabNodes[i].print();
     }
 	std::cout << std::endl;
 }
 void Data::printLinks(){
-	for (unsigned int i = 0; i < tabLinks.size(); i++){
-        tabLinks[i].print();
+	for (unsigned int i = 0; i < network->tabLinks.size(); i++){
+        network->tabLinks[i].print();
     }
 	std::cout << std::endl;
 }
 
 void Data::printVnfs(){
-	for (unsigned int i = 0; i < tabVnfs.size(); i++){
-        tabVnfs[i].print();
+	for (unsigned int i = 0; i < network->tabVnfs.size(); i++){
+        network->tabVnfs[i].print();
     }
 	std::cout << std::endl;
 }
@@ -504,8 +562,8 @@ void Data::printDemands(){
 
 void Data::printNodeRank(){
 	std::cout << "Node ranking: " << std::endl;
-	for (unsigned int i = 0; i < availNodeRank.size(); i++){
-		getNode(availNodeRank[i]).print();
+	for (unsigned int i = 0; i < network->availNodeRank.size(); i++){
+		getNode(network->availNodeRank[i]).print();
 	}
 }
 
@@ -517,14 +575,5 @@ void Data::printNodeRank(){
 /** Desstructor. **/
 Data::~Data()
 {
-    this->tabLinks.clear();
-    this->tabNodes.clear();
-	this->hashNode.clear();
 	this->tabDemands.clear();
-	this->tabVnfs.clear();
-	delete nodeId;
-	delete lemonNodeId;
-	delete arcId;
-	delete lemonArcId;
-	delete graph;
 }
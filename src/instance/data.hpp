@@ -11,6 +11,7 @@
 #include <unordered_map>
 #include <algorithm>
 #include <cmath>
+#include <memory>
 
 /*** LEMON Libraries ***/     
 #include <lemon/list_graph.h>
@@ -42,17 +43,13 @@ typedef Graph::NodeMap<int> NodeMap;
 typedef Graph::ArcMap<int> ArcMap;
 
 /********************************************************************************************
- * This class stores the data needed for modeling an instance of the Resilient SFC routing 
- * and VNF placement problem. This consists of a network graph, 											
+ * The part of an instance read from the node, link and VNF files. It is left untouched once
+ * built, so that the instances differing only by their demands share it.
 ********************************************************************************************/
-class Data {
-
-private:
-	Input 				params;						/**< Input parameters. **/
+struct Topology {
     std::vector<Node> 	tabNodes;         			/**< Set of nodes. **/
 	std::vector<Link> 	tabLinks;					/**< Set of links. **/
 	std::vector<VNF> 	tabVnfs;					/**< Set of VNFs. **/
-	std::vector<Demand> tabDemands;					/**< Set of demands. **/
 
 	Graph* 				graph;						/**< The network graph. **/
 	NodeMap* 			nodeId;						/**< A map storing the nodes' ids. **/
@@ -64,6 +61,25 @@ private:
 	std::unordered_map<std::string, int> hashVnf; 	/**< A map for locating vnf id's from its name. **/
 
 	std::vector<int>	availNodeRank;				/**< A vector containing the ids of nodes in decreasing order of availability. **/
+
+	/** Constructor. The graph is built by Data::buildGraph. **/
+	Topology() : graph(NULL), nodeId(NULL), lemonNodeId(NULL), arcId(NULL), lemonArcId(NULL) {}
+	Topology(const Topology&) = delete;
+	/** Destructor. Deletes the graph and its maps. **/
+	~Topology() { delete nodeId; delete lemonNodeId; delete arcId; delete lemonArcId; delete graph; }
+};
+
+/********************************************************************************************
+ * This class stores the data needed for modeling an instance of the Resilient SFC routing 
+ * and VNF placement problem. This consists of a network graph, 											
+********************************************************************************************/
+class Data {
+
+private:
+	Input 				params;						/**< Input parameters. **/
+	std::shared_ptr<Topology> network;				/**< The nodes, links, VNFs and graph, shared by the instances built on the same topology. **/
+	std::vector<Demand> tabDemands;					/**< Set of demands. **/
+
 	std::vector<int>	maxPathsPerDemand;			/**< A vector storing an upper bound on the number of paths dedicated to each demand. **/
 public:
 
@@ -74,6 +90,15 @@ public:
 	/** Constructor initializes the object with the information of an Input. @param parameter_file The parameters file.**/
 	Data(const std::string &parameter_file);
 
+	/** Constructor initializes the object with the information of an already read Input. @param input The input parameters.**/
+	Data(const Input& input);
+
+	/** Constructor builds an instance on the topology of another one, whose nodes, links, VNFs and graph are shared rather than read and built again. Only the demand file of the input is read. @param topology An instance read from the same node, link and VNF files. @param input The input parameters. **/
+	Data(const Data& topology, const Input& input);
+
+	/** Constructor builds the sub-instance made of a subset of the demands of an instance, sharing its topology. @param data The instance. @param demands The ids of the demands to be kept, which are renumbered in this order. **/
+	Data(const Data& data, const std::vector<int>& demands);
+
 
 
 	/****************************************************************************************/
@@ -81,29 +106,29 @@ public:
 	/****************************************************************************************/
 
 	const Input& 			 	getInput 		 () const { return params; }		/**< Returns a reference to the data's Input. */
-	const Graph& 			 	getGraph     	 () const { return *graph; }		/**< Returns a reference to the data's Graph. */
-	const NodeMap& 			 	getNodeIds   	 () const { return *nodeId; }		/**< Returns a reference to the map storing the nodes' ids. */
-	const NodeMap& 			 	getLemonNodeIds  () const { return *lemonNodeId; }	/**< Returns a reference to the map storing the nodes' lemon ids. */
-	const ArcMap& 			 	getArcIds    	 () const { return *arcId; }		/**< Returns a reference to the map storing the arcs' ids. */
-	const ArcMap& 			 	getLemonArcIds   () const { return *lemonArcId; }	/**< Returns a reference to the map storing the arcs' lemon ids. */
-	const std::vector<Node>& 	getNodes     	 () const { return tabNodes; }		/**< Returns a reference to the vector of nodes. */
-	const std::vector<Link>& 	getLinks     	 () const { return tabLinks; }		/**< Returns a reference to the vector of arcs. */
-	const std::vector<VNF>&  	getVnfs     	 () const { return tabVnfs; }		/**< Returns a reference to the vector of vnfs. */
+	const Graph& 			 	getGraph     	 () const { return *network->graph; }		/**< Returns a reference to the data's Graph. */
+	const NodeMap& 			 	getNodeIds   	 () const { return *network->nodeId; }		/**< Returns a reference to the map storing the nodes' ids. */
+	const NodeMap& 			 	getLemonNodeIds  () const { return *network->lemonNodeId; }	/**< Returns a reference to the map storing the nodes' lemon ids. */
+	const ArcMap& 			 	getArcIds    	 () const { return *network->arcId; }		/**< Returns a reference to the map storing the arcs' ids. */
+	const ArcMap& 			 	getLemonArcIds   () const { return *network->lemonArcId; }	/**< Returns a reference to the map storing the arcs' lemon ids. */
+	const std::vector<Node>& 	getNodes     	 () const { return network->tabNodes; }		/**< Returns a reference to the vector of nodes. */
+	const std::vector<Link>& 	getLinks     	 () const { return network->tabLinks; }		/**< Returns a reference to the vector of arcs. */
+	const std::vector<VNF>&  	getVnfs     	 () const { return network->tabVnfs; }		/**< Returns a reference to the vector of vnfs. */
 	const std::vector<Demand>&  getDemands     	 () const { return tabDemands; }	/**< Returns a reference to the vector of sfc demands. */
-	const std::vector<int>&  	getAvailNodeRank () const { return availNodeRank; }	/**< Returns the ranking of most available nodes identified by their id. */
+	const std::vector<int>&  	getAvailNodeRank () const { return network->availNodeRank; }	/**< Returns the ranking of most available nodes identified by their id. */
 
-	const VNF& 		getVnf    (const int i) 		const { return tabVnfs[i]; }	/**< Returns a reference to the i-th vnf. */
+	const VNF& 		getVnf    (const int i) 		const { return network->tabVnfs[i]; }	/**< Returns a reference to the i-th vnf. */
 	const Demand& 	getDemand (const int i) 		const { return tabDemands[i]; }	/**< Returns a reference to the i-th demand. */
-	const Link& 	getLink   (const int i) 		const { return tabLinks[i]; }	/**< Returns a reference to the i-th arc. */
-	const Node& 	getNode   (const int i) 		const { return tabNodes[i]; }	/**< Returns a reference to the i-th node. */
+	const Link& 	getLink   (const int i) 		const { return network->tabLinks[i]; }	/**< Returns a reference to the i-th arc. */
+	const Node& 	getNode   (const int i) 		const { return network->tabNodes[i]; }	/**< Returns a reference to the i-th node. */
 
-	const int  getNbNodes     () 					 const { return (int)tabNodes.size(); }		/**< Returns the number of nodes. */
-	const int  getNbVnfs      () 					 const { return (int)tabVnfs.size(); }		/**< Returns the number of vnfs. */
+	const int  getNbNodes     () 					 const { return (int)network->tabNodes.size(); }		/**< Returns the number of nodes. */
+	const int  getNbVnfs      () 					 const { return (int)network->tabVnfs.size(); }		/**< Returns the number of vnfs. */
 	const int  getNbDemands   () 					 const { return (int)tabDemands.size(); }	/**< Returns the number of sfc demands. */
-	const int& getNodeId   	  (const Graph::Node& v) const { return (*nodeId)[v]; }				/**< Returns the id of a given node. */
-	const int& getLemonNodeId (const Graph::Node& v) const { return (*lemonNodeId)[v]; }		/**< Returns the lemon id of a given node. */
-	const int& getArcId    	  (const Arc& a) 		 const { return (*arcId)[a]; }				/**< Returns the id of a given arc. */
-	const int& getLemonArcId  (const Arc& a) 		 const { return (*lemonArcId)[a]; }			/**< Returns the lemon id of a given arc. */
+	const int& getNodeId   	  (const Graph::Node& v) const { return (*network->nodeId)[v]; }				/**< Returns the id of a given node. */
+	const int& getLemonNodeId (const Graph::Node& v) const { return (*network->lemonNodeId)[v]; }		/**< Returns the lemon id of a given node. */
+	const int& getArcId    	  (const Arc& a) 		 const { return (*network->arcId)[a]; }				/**< Returns the id of a given arc. */
+	const int& getLemonArcId  (const Arc& a) 		 const { return (*network->lemonArcId)[a]; }			/**< Returns the lemon id of a given arc. */
 
 	/** Returns the id from the node with the given name. @param name The node name. **/
 	int	 	   getIdFromNodeName(const std::string name) const;
@@ -111,6 +136,12 @@ public:
 	/** Returns the id from the vnf with the given name. @param name The vnf name. **/
 	int	 	   getIdFromVnfName(const std::string name) const;
 
+	/** Returns true if a node has the given name. @param name The node name. **/
+	bool 	   hasNodeName(const std::string& name) const { return network->hashNode.find(name) != network->hashNode.end(); }
+
+	/** Returns true if a vnf has the given name. @param name The vnf name. **/
+	bool 	   hasVnfName(const std::string& name) const { return network->hashVnf.find(name) != network->hashVnf.end(); }
+
     /** Returns the probability that a set of nodes fail simoustaneously. @param nodes The set of nodes to fail. **/
     const double getFailureProb(const std::vector<int>& nodes) const;
     
@@ -156,13 +187,25 @@ public:
 	/* Return an upper bound on the number of vnf-disjoint paths */
 	const int getNbPaths(int k) const { return maxPathsPerDemand[k]; } 
 
+	/** Returns true if a demand was removed, in which case it requests nothing and no path may route it. @param k The demand id. **/
+	const bool isDemandRemoved(int k) const { return maxPathsPerDemand[k] == 0; }
+
 	/****************************************************************************************/
 	/*										Setters											*/
 	/****************************************************************************************/
-	void setNodeId 		(const Graph::Node& v, const int &id) { (*nodeId)[v] = id; }		/**< Sets the id of a given node on the node map. */
-	void setLemonNodeId (const Graph::Node& v, const int &id) { (*lemonNodeId)[v] = id; }	/**< Sets the lemon id of a given node on the node map. */
-	void setArcId 		(const Graph::Arc& a, const int &id)  { (*arcId)[a] = id; }			/**< Sets the id of a given arc on the arc map. */
-	void setLemonArcId 	(const Graph::Arc& a, const int &id)  { (*lemonArcId)[a] = id; }	/**< Sets the lemon id of a given arc on the arc map. */
+	void setNodeId 		(const Graph::Node& v, const int &id) { (*network->nodeId)[v] = id; }		/**< Sets the id of a given node on the node map. */
+	void setLemonNodeId (const Graph::Node& v, const int &id) { (*network->lemonNodeId)[v] = id; }	/**< Sets the lemon id of a given node on the node map. */
+	void setArcId 		(const Graph::Arc& a, const int &id)  { (*network->arcId)[a] = id; }			/**< Sets the id of a given arc on the arc map. */
+	void setLemonArcId 	(const Graph::Arc& a, const int &id)  { (*network->lemonArcId)[a] = id; }	/**< Sets the lemon id of a given arc on the arc map. */
+
+	/** Adds a demand, whose id is set to its position. Returns its id. @param demand The demand to be added. **/
+	int addDemand(const Demand& demand);
+
+	/** Removes a demand: it then requests nothing and no path may route it. The ids of the other demands are kept. @param k The demand id. **/
+	void removeDemand(const int k);
+
+	/** Changes the availability requested by a demand and updates its bound on the number of paths. @param k The demand id. @param availability The new requested availability. **/
+	void setDemandAvailability(const int k, const double availability);
 
 
 	/****************************************************************************************/
@@ -190,6 +233,9 @@ public:
 	/** Builds the upper bounds on the number of paths that should route each demand. **/
 	void computeMaxPathPerDemand();
 
+	/** Builds the upper bound on the number of paths that should route a given demand. @param k The demand id. **/
+	void computeMaxPathPerDemand(const int k);
+
 
 	/****************************************************************************************/
 	/*										Display											*/
@@ -1,62 +1,125 @@
 #include "input.hpp"
+#include "../tools/reader.hpp"
 
 /****************************************************************************************/
 /*										Constructor										*/
 /****************************************************************************************/
 
 /** Constructor. **/
-Input::Input(const std::string filename) : parameters_file(filename){
+Input::Input(const std::string filename, const std::string nodeFile, const std::string demandFile) : parameters_file(filename){
     std::cout << "=> Reading parameters file: " << parameters_file << " ..." << std::endl;
-    
-    node_file   = getParameterValue("nodeFile=");
+    readParametersFile();
+
+    node_file   = nodeFile.empty() ? getParameterValue("nodeFile=") : nodeFile;
     link_file   = getParameterValue("linkFile=");
-    demand_file = getParameterValue("demandFile=");
+    demand_file = demandFile.empty() ? getParameterValue("demandFile=") : demandFile;
     vnf_file    = getParameterValue("vnfFile=");
 
     strong_node_capacity    = (Strong_Node_Capacity_Constraints)std::stoi(getParameterValue("strong_node_capacity="));
     section_failure_cuts    = (Section_Failure_Cuts)std::stoi(getParameterValue("section_failure="));
+    cover_cuts              = (Cover_Cuts)std::stoi(getOptionalParameterValue("cover_cuts=", "0"));
     nb_paths_ub             = (Nb_Paths_Upper_Bound)std::stoi(getParameterValue("nb_paths_upper_bound="));
     nb_paths_lb             = (Nb_Paths_Lower_Bound)std::stoi(getParameterValue("nb_paths_lower_bound="));
     approx_type             = (Approximation_Type)std::stoi(getParameterValue("availability_relax="));
 
+    solver_engine           = (Solver_Engine)std::stoi(getOptionalParameterValue("solver_engine=", "0"));
     linear_relaxation       = std::stoi(getParameterValue("linearRelaxation="));
     basic                   = std::stoi(getParameterValue("basic="));
     time_limit              = std::stoi(getParameterValue("timeLimit="));
     nb_breakpoints          = std::stoi(getParameterValue("nb_breakpoints="));
+    initial_heuristic       = (Initial_Heuristic)std::stoi(getOptionalParameterValue("initial_heuristic=", "0"));
+    lns                     = (Lns_Heuristic)std::stoi(getOptionalParameterValue("lns=", "0"));
+    lns_time_limit          = std::stoi(getOptionalParameterValue("lns_time_limit=", "5"));
+    lns_neighbourhood_size  = std::stoi(getOptionalParameterValue("lns_neighbourhood_size=", "2"));
+    repair_heuristic        = (Repair_Heuristic)std::stoi(getOptionalParameterValue("repair_heuristic=", "0"));
+    priority_z              = std::stoi(getOptionalParameterValue("priority_z=", "0"));
+    priority_alpha          = std::stoi(getOptionalParameterValue("priority_alpha=", "0"));
+    priority_y              = std::stoi(getOptionalParameterValue("priority_y=", "0"));
+    priority_x              = std::stoi(getOptionalParameterValue("priority_x=", "0"));
+    priority_f              = std::stoi(getOptionalParameterValue("priority_f=", "0"));
+    branching_callback      = (Branching_Callback)std::stoi(getOptionalParameterValue("branching_callback=", "0"));
+    propagation             = (Propagation)std::stoi(getOptionalParameterValue("propagation=", "0"));
+    availability_cuts       = (Availability_Cuts)std::stoi(getOptionalParameterValue("availability_cuts=", "0"));
+    pwl_encoding            = (Pwl_Encoding)std::stoi(getOptionalParameterValue("pwl_encoding=", "0"));
+    refinement_iterations   = std::stoi(getOptionalParameterValue("refinement_iterations=", "0"));
+    lagrangian_iterations   = std::stoi(getOptionalParameterValue("lagrangian_iterations=", "100"));
+    service_time_limit      = std::stod(getOptionalParameterValue("service_time_limit=", "1"));
+    separation_threads      = std::stoi(getOptionalParameterValue("separation_threads=", "1"));
 
     output_file             = getParameterValue("outputFile=");
+    export_format           = (Export_Format)std::stoi(getOptionalParameterValue("exportModel=", "0"));
+    export_file             = getOptionalParameterValue("exportFile=", "");
 
     print();
 }
 
 
 
-/* Returns the pattern value in the parameters file. */
-std::string Input::getParameterValue(std::string pattern){
+/* Reads the lines of the parameters file, which are then searched for each field. */
+void Input::readParametersFile(){
     std::string line;
-    std::string value = "";
     std::ifstream param_file (parameters_file.c_str());
-    if (param_file.is_open()) {
-        while ( std::getline (param_file, line) ) {
-            std::size_t pos = line.find(pattern);
-            if (pos != std::string::npos){
-                value = line.substr(pos + pattern.size());
-                value.erase(std::remove(value.begin(), value.end(), '\r'), value.end());
-                value.erase(std::remove(value.begin(), value.end(), '\n'), value.end());
-                if (value.empty()){
-                    std::cout << "WARNING: Field '" << pattern << "' is empty." << std::endl; 
-                }
+    if (!param_file.is_open()) {
+        std::cerr << "ERROR: Unable to open parameters file '" << parameters_file << "'." << std::endl; 
+        exit(EXIT_FAILURE);
+    }
+    while ( std::getline (param_file, line) ) {
+        line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+        parameters_lines.push_back(line);
+    }
+    param_file.close();
+}
+
+/* Returns the pattern value in the parameters file. */
+std::string Input::getParameterValue(std::string pattern){
+    for (unsigned int l = 0; l < parameters_lines.size(); l++){
+        std::size_t pos = parameters_lines[l].find(pattern);
+        if (pos != std::string::npos){
+            std::string value = parameters_lines[l].substr(pos + pattern.size());
+            if (value.empty()){
+                std::cout << "WARNING: Field '" << pattern << "' is empty." << std::endl; 
+            }
+            return value;
+        }
+    }
+    std::cout << "WARNING: Did not found field '" << pattern << "' inside parameters file." << std::endl; 
+    return "";
+}
+
+/* Returns the pattern value in the parameters file or a default value if the field is absent. */
+std::string Input::getOptionalParameterValue(const std::string pattern, const std::string default_value){
+    for (unsigned int l = 0; l < parameters_lines.size(); l++){
+        std::size_t pos = parameters_lines[l].find(pattern);
+        if (pos != std::string::npos){
+            std::string value = parameters_lines[l].substr(pos + pattern.size());
+            if (!value.empty()){
                 return value;
             }
         }
-        param_file.close();
     }
-    else {
-        std::cerr << "ERROR: Unable to open parameters file '" << parameters_file << "'." << std::endl; 
-        exit(EXIT_FAILURE);
+    return default_value;
+}
+
+/* Returns the instance name, built from the node and demand file names. */
+const std::string Input::getInstanceName() const{
+    std::string demand_name = getInBetweenString(demand_file, "/", ".");
+    std::string node_name = getInBetweenString(node_file, "/", ".");
+    return node_name + "_" + demand_name;
+}
+
+/* Returns the model export file, with the extension matching the export format. */
+const std::string Input::getExportFile() const{
+    std::string file = export_file.empty() ? getInstanceName() : export_file;
+    switch (export_format){
+        case EXPORT_FORMAT_LP:
+            return file + ".lp";
+        case EXPORT_FORMAT_MPS:
+            return file + ".mps";
+        case EXPORT_FORMAT_SAV:
+            return file + ".sav";
+        default:
+            return "";
     }
-    std::cout << "WARNING: Did not found field '" << pattern << "' inside parameters file." << std::endl; 
-    return value;
 }
 
 void Input::print(){
@@ -64,6 +127,15 @@ void Input::print(){
     std::cout << "\t Link File: " << link_file << std::endl;
     std::cout << "\t Service Chain Function File: " << demand_file << std::endl;
     std::cout << "\t Virtual Network Function File: " << vnf_file << std::endl;
+    if (solver_engine == SOLVER_ENGINE_COLUMN_GENERATION){
+        std::cout << "\t Solver engine: COLUMN GENERATION" << std::endl;
+    }
+    if (solver_engine == SOLVER_ENGINE_BENDERS){
+        std::cout << "\t Solver engine: BENDERS" << std::endl;
+    }
+    if (solver_engine == SOLVER_ENGINE_LAGRANGIAN){
+        std::cout << "\t Solver engine: LAGRANGIAN, " << lagrangian_iterations << " iterations at most" << std::endl;
+    }
     std::cout << "\t Linear Relaxation: ";
     if (linear_relaxation){
         std::cout << "TRUE" << std::endl;
@@ -75,6 +147,36 @@ void Input::print(){
     std::cout << "Number of paths upper bound: " << nb_paths_ub << std::endl;
     std::cout << "Number of paths lower bound: " << nb_paths_lb << std::endl;
     std::cout << "\t Number of breakpoints: " << nb_breakpoints << std::endl;
+    std::cout << "\t Initial heuristic: " << initial_heuristic << std::endl;
+    std::cout << "\t Repair heuristic: " << repair_heuristic << std::endl;
+    std::cout << "\t Branching priorities: z=" << priority_z << ", alpha=" << priority_alpha << ", y=" << priority_y << ", x=" << priority_x << ", f=" << priority_f << std::endl;
+    std::cout << "\t Branching callback: " << branching_callback << std::endl;
+    std::cout << "\t Availability propagation: " << propagation << std::endl;
+    if (isAvailabilityCutsOn()){
+        std::cout << "\t Availability: secant relaxation and path support cuts" << std::endl;
+    }
+    switch (pwl_encoding){
+        case PWL_ENCODING_SOS2:
+            std::cout << "\t Piecewise encoding: SOS2" << std::endl;
+            break;
+        case PWL_ENCODING_INCREMENTAL:
+            std::cout << "\t Piecewise encoding: INCREMENTAL" << std::endl;
+            break;
+        case PWL_ENCODING_LOGARITHMIC:
+            std::cout << "\t Piecewise encoding: LOGARITHMIC" << std::endl;
+            break;
+        default:
+            break;
+    }
+    if (isRefinementOn()){
+        std::cout << "\t Breakpoint refinement: " << refinement_iterations << " rounds at most" << std::endl;
+    }
+    if (lns != LNS_OFF){
+        std::cout << "\t LNS: " << lns_neighbourhood_size << " demands per neighbourhood, " << lns_time_limit << " seconds per neighbourhood" << std::endl;
+    }
     std::cout << "\t Time Limit: " << time_limit << " seconds" << std::endl;
     std::cout << "\t Output File: " << output_file << std::endl;
+    if (export_format != EXPORT_FORMAT_OFF){
+        std::cout << "\t Export File: " << getExportFile() << std::endl;
+    }
 }
\ No newline at end of file
@@ -35,15 +35,72 @@ public:
 		SECTION_FAILURE_CUTS_OFF = 0,  		
 		SECTION_FAILURE_CUTS_ON = 1 	        
 	};
+	/** States whether availability cover cuts are separated on fractional solutions.**/
+	enum Cover_Cuts {
+		COVER_CUTS_OFF = 0,  		
+		COVER_CUTS_ON = 1 	        
+	};
 	/** States wheter section failure cuts are activated.**/
 	enum Approximation_Type {
 		APPROXIMATION_TYPE_RESTRICTION = 0,  		
 		APPROXIMATION_TYPE_RELAXATION = 1 	        
 	};
+	/** Defines the file format in which the model is exported before solving.**/
+	enum Export_Format {
+		EXPORT_FORMAT_OFF = 0,  		
+		EXPORT_FORMAT_LP = 1,  		
+		EXPORT_FORMAT_MPS = 2,  		
+		EXPORT_FORMAT_SAV = 3 	        
+	};
+	/** Defines the formulation used for solving the problem.**/
+	enum Solver_Engine {
+		SOLVER_ENGINE_COMPACT = 0,  		
+		SOLVER_ENGINE_COLUMN_GENERATION = 1,  		
+		SOLVER_ENGINE_BENDERS = 2,  		
+		SOLVER_ENGINE_LAGRANGIAN = 3 	        
+	};
+	/** States whether a constructive heuristic solution is given to CPLEX as a MIP start.**/
+	enum Initial_Heuristic {
+		INITIAL_HEURISTIC_OFF = 0,  		
+		INITIAL_HEURISTIC_ON = 1 	        
+	};
+	/** States whether the availability approximation is replaced with cuts separated by the callback.**/
+	enum Availability_Cuts {
+		AVAILABILITY_CUTS_OFF = 0,  		
+		AVAILABILITY_CUTS_ON = 1 	        
+	};
+	/** Defines the MIP encoding of the piecewise linear availability approximation.**/
+	enum Pwl_Encoding {
+		PWL_ENCODING_NATIVE = 0,  		
+		PWL_ENCODING_SOS2 = 1,  		
+		PWL_ENCODING_INCREMENTAL = 2,  		
+		PWL_ENCODING_LOGARITHMIC = 3 	        
+	};
+	/** States whether the large neighbourhood search runs alongside CPLEX.**/
+	enum Lns_Heuristic {
+		LNS_OFF = 0,  		
+		LNS_ON = 1 	        
+	};
+	/** States whether candidates rejected for their availability are repaired into heuristic solutions.**/
+	enum Repair_Heuristic {
+		REPAIR_HEURISTIC_OFF = 0,  		
+		REPAIR_HEURISTIC_ON = 1 	        
+	};
+	/** States whether the callback takes the branching decisions, on path counts then on low-availability placements.**/
+	enum Branching_Callback {
+		BRANCHING_CALLBACK_OFF = 0,  		
+		BRANCHING_CALLBACK_ON = 1 	        
+	};
+	/** States whether the callback propagates the availability requirements on local bounds.**/
+	enum Propagation {
+		PROPAGATION_OFF = 0,  		
+		PROPAGATION_ON = 1 	        
+	};
 
 private:
     /***** Input file paths *****/
     const std::string   parameters_file;
+    std::vector<std::string> parameters_lines;          /**< The lines of the parameters file, read once. **/
     std::string         node_file;
     std::string         link_file;
     std::string         demand_file;
@@ -52,26 +109,48 @@ private:
     /***** Formulation parameters*****/
     Strong_Node_Capacity_Constraints        strong_node_capacity;           /**< Refers to the activation of strong node capacity constraints. **/
     Section_Failure_Cuts					section_failure_cuts; 			/**< Refers to the activation of section failure cuts. **/
+    Cover_Cuts								cover_cuts; 					/**< Refers to the activation of availability cover cuts. **/
 	Nb_Paths_Upper_Bound					nb_paths_ub; 					/**< Refers to the activation of upper bounds on the number of paths. **/
 	Nb_Paths_Lower_Bound					nb_paths_lb; 					/**< Refers to the activation of lower bounds on the number of paths. **/
     Approximation_Type                      approx_type;                    /**< Refers to the type of approximation used for modeling availability constraints. **/
 
 	/***** Optimization parameters*****/
+    Solver_Engine       solver_engine;                  /**< Refers to the formulation used for solving the problem. **/
     bool                linear_relaxation;
     bool                basic;
     int                 time_limit;
     int                 nb_breakpoints;
+    Initial_Heuristic   initial_heuristic;              /**< Refers to the activation of the constructive MIP start. **/
+    Lns_Heuristic       lns;                            /**< Refers to the activation of the large neighbourhood search. **/
+    int                 lns_time_limit;                 /**< Time limit in seconds of each neighbourhood solve. **/
+    int                 lns_neighbourhood_size;         /**< Number of demands freed in each demand neighbourhood. **/
+    Repair_Heuristic    repair_heuristic;               /**< Refers to the repair of candidates rejected for their availability. **/
+    int                 priority_z;                     /**< Branching priority of the global placement variables, 0 for none. **/
+    int                 priority_alpha;                 /**< Branching priority of the path activation variables, 0 for none. **/
+    int                 priority_y;                     /**< Branching priority of the path placement variables, 0 for none. **/
+    int                 priority_x;                     /**< Branching priority of the section placement variables, 0 for none. **/
+    int                 priority_f;                     /**< Branching priority of the flow variables, 0 for none. **/
+    Branching_Callback  branching_callback;             /**< Refers to the branching decisions taken by the callback. **/
+    Propagation         propagation;                    /**< Refers to the propagation of availability requirements on local bounds. **/
+    Availability_Cuts   availability_cuts;              /**< Refers to the replacement of the availability approximation with separated cuts. **/
+    Pwl_Encoding        pwl_encoding;                   /**< Refers to the MIP encoding of the piecewise linear availability approximation. **/
+    int                 refinement_iterations;          /**< Maximum number of breakpoint refinement rounds, 0 to disable. **/
+    int                 lagrangian_iterations;          /**< Maximum number of subgradient iterations of the Lagrangian engine. **/
+    double              service_time_limit;             /**< Time limit in seconds of each request of the admission service. **/
+    int                 separation_threads;             /**< Number of threads sharing the per-demand separation work of each callback invocation. **/
 
 
     /***** Output file paths *****/
     std::string         output_file;
+    Export_Format       export_format;                  /**< Refers to the format of the model export. **/
+    std::string         export_file;                    /**< Refers to the base name of the model export file. **/
     
 public:
 	/********************************************/
 	/*				Constructors				*/
 	/********************************************/
-	/** Constructor initializes the object with the information contained in the parameter file. @param file The address of the parameter file (usually the address of file 'parameters.txt'). **/
-    Input(const std::string file);
+	/** Constructor initializes the object with the information contained in the parameter file. @param file The address of the parameter file (usually the address of file 'parameters.txt'). @param nodeFile If not empty, replaces the node file declared in the parameter file. @param demandFile If not empty, replaces the demand file declared in the parameter file. **/
+    Input(const std::string file, const std::string nodeFile = "", const std::string demandFile = "");
     /** Constructor always need a parameter file. **/
     Input() = delete;
 
@@ -96,6 +175,8 @@ public:
     const Strong_Node_Capacity_Constraints &        getStrongNodeCapacity()         const { return strong_node_capacity; }
 	/** Returns whether section failure cuts are activated. **/ //TODO: To be implemented
     const Section_Failure_Cuts &                    getSectionFailureCuts()         const { return section_failure_cuts; }
+	/** Returns whether availability cover cuts are activated. **/ 
+    const Cover_Cuts &                              getCoverCuts()                  const { return cover_cuts; }
 	/** Returns whether number of paths upper bounds are activated. **/ 
     const Nb_Paths_Upper_Bound &                    getNbPathsUpperBound()         const { return nb_paths_ub; }
 	/** Returns whether number of paths lower bounds are activated. **/ 
@@ -104,6 +185,8 @@ public:
     const Approximation_Type &                      getApproximationType()         const { return approx_type; }
 	
 
+    /** Returns the formulation used for solving the problem. */
+    const Solver_Engine& getSolverEngine() const { return this->solver_engine; }
     /** Returns true if linear relaxation is to be applied. */
     const bool&        isRelaxation()      const { return this->linear_relaxation; }
     /** Returns true if the basic formulation is being applied. */
@@ -112,14 +195,64 @@ public:
     const int&         getTimeLimit()      const { return this->time_limit; }
     /** Returns the number of breakpoints to be used in the log approximation. */
     const int&         getNbBreakpoints() const { return this->nb_breakpoints; }
+    /** Returns whether a constructive heuristic solution is given as MIP start. */
+    const Initial_Heuristic& getInitialHeuristic() const { return this->initial_heuristic; }
+    /** Returns whether the large neighbourhood search runs alongside CPLEX. */
+    const Lns_Heuristic& getLns()          const { return this->lns; }
+    /** Returns the time limit in seconds of each neighbourhood solve. */
+    const int&         getLnsTimeLimit()   const { return this->lns_time_limit; }
+    /** Returns the number of demands freed in each demand neighbourhood. */
+    const int&         getLnsNeighbourhoodSize() const { return this->lns_neighbourhood_size; }
+    /** Returns whether candidates rejected for their availability are repaired into heuristic solutions. */
+    const Repair_Heuristic& getRepairHeuristic() const { return this->repair_heuristic; }
+    /** Returns the branching priority of the global placement variables. */
+    const int&         getPriorityZ()      const { return this->priority_z; }
+    /** Returns the branching priority of the path activation variables. */
+    const int&         getPriorityAlpha()  const { return this->priority_alpha; }
+    /** Returns the branching priority of the path placement variables. */
+    const int&         getPriorityY()      const { return this->priority_y; }
+    /** Returns the branching priority of the section placement variables. */
+    const int&         getPriorityX()      const { return this->priority_x; }
+    /** Returns the branching priority of the flow variables. */
+    const int&         getPriorityF()      const { return this->priority_f; }
+    /** Returns whether the callback takes the branching decisions. */
+    const Branching_Callback& getBranchingCallback() const { return this->branching_callback; }
+    /** Returns whether the callback propagates the availability requirements on local bounds. */
+    const Propagation& getPropagation()    const { return this->propagation; }
+    /** Returns whether the availability approximation is replaced with separated cuts. */
+    const Availability_Cuts& getAvailabilityCuts() const { return this->availability_cuts; }
+    /** Returns true if the availability approximation is replaced with secant relaxations and path support cuts separated by the callback. @note Only available with the relaxation approximation, whose candidates are checked exactly. */
+    const bool         isAvailabilityCutsOn() const { return (availability_cuts == AVAILABILITY_CUTS_ON && approx_type == APPROXIMATION_TYPE_RELAXATION && !basic); }
+    /** Returns the MIP encoding of the piecewise linear availability approximation. */
+    const Pwl_Encoding& getPwlEncoding() const { return this->pwl_encoding; }
+    /** Returns the maximum number of breakpoint refinement rounds. */
+    const int&         getRefinementIterations() const { return this->refinement_iterations; }
+    /** Returns true if the availability approximation starts coarse and is refined around violated demands. @note Only the relaxation approximation can be violated, hence refined. */
+    const bool         isRefinementOn()    const { return (refinement_iterations > 0 && approx_type == APPROXIMATION_TYPE_RELAXATION && !basic && availability_cuts == AVAILABILITY_CUTS_OFF); }
+    /** Returns the maximum number of subgradient iterations of the Lagrangian engine. */
+    const int&         getLagrangianIterations() const { return this->lagrangian_iterations; }
+    /** Returns the time limit in seconds of each request of the admission service. */
+    const double&      getServiceTimeLimit() const { return this->service_time_limit; }
+    /** Returns the number of threads sharing the per-demand separation work of each callback invocation. */
+    const int&         getSeparationThreads() const { return this->separation_threads; }
     /** Returns the output file. */
     const std::string& getOutputFile()     const { return this->output_file; }
+    /** Returns the format in which the model is exported. */
+    const Export_Format& getExportFormat() const { return this->export_format; }
+    /** Returns the model export file, with the extension matching the export format. @note Defaults to the instance name. */
+    const std::string   getExportFile()    const;
+    /** Returns the instance name, built from the node and demand file names. */
+    const std::string   getInstanceName()  const;
 
 	/********************************************/
 	/*				    Methods	    			*/
 	/********************************************/
+    /** Reads the lines of the parameters file. */
+    void readParametersFile();
     /** Returns the pattern value in the parameters file. */
     std::string getParameterValue(const std::string pattern);
+    /** Returns the pattern value in the parameters file or a default value if the field is absent. @param pattern The field to look for. @param default_value The value to be returned if the field is absent or empty. @note Used for fields that older parameter files do not declare. */
+    std::string getOptionalParameterValue(const std::string pattern, const std::string default_value);
 
 	/********************************************/
 	/*				    Output	    			*/
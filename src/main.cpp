@@ -1,69 +1,89 @@
-#include <ilcplex/ilocplex.h>
-ILOSTLBEGIN
-
-#include "tools/others.hpp"
-#include "instance/data.hpp"
-#include "solver/model.hpp"
-#include "piecewise/approximation.hpp"
-
-int main(int argc, char *argv[]) {
-    greetingMessage();
-    std::string parameterFile = getParameter(argc, argv);
-
-    /* Build data */
-    Data data(parameterFile);
-    data.print();
-
-    /* Build cplex environment */
-    IloEnv env;
-	
-    try
-    {
-        /* Build model */
-        Model model(env, data);
-
-        /* Run model */
-        model.run();
-
-        /* Print results */
-        model.printResult();
-        model.output();
-    }
-    catch (const IloException& e) { env.end(); std::cerr << "Exception caught: " << e << std::endl; return 1; }
-    catch (...) { env.end(); std::cerr << "Unknown exception caught!" << std::endl; return 1; }
-    
-
-    /*** Finalization ***/
-    env.end();
-
-   
-    Approximation equidistant_inner_approx(Piecewise::buildLogFunction(2000, 0.75, 1.0), Approximation::Direction::DIRECTION_FROM_BELOW, Approximation::Method::METHOD_EQUIDISTANT, 6);
-    Approximation billonnet_inner_approx(Piecewise::buildLogFunction(2000, 0.75, 1.0), Approximation::Direction::DIRECTION_FROM_BELOW, Approximation::Method::METHOD_BILLONNET, 6);
-    Approximation shortest_path_inner_approx(Piecewise::buildLogFunction(2000, 0.75, 1.0), Approximation::Direction::DIRECTION_FROM_BELOW, Approximation::Method::METHOD_SHORTEST_PATH, 6);
-
-
-
- 
-    Approximation equidistant_outer_approx(Piecewise::buildLogFunction(2000, 0.75, 1.0), Approximation::Direction::DIRECTION_FROM_ABOVE, Approximation::Method::METHOD_EQUIDISTANT, 6);
-    Approximation billonnet_outer_approx(Piecewise::buildLogFunction(2000, 0.75, 1.0), Approximation::Direction::DIRECTION_FROM_ABOVE, Approximation::Method::METHOD_BILLONNET, 6);
-    Approximation shortest_path_outer_approx(Piecewise::buildLogFunction(2000, 0.75, 1.0), Approximation::Direction::DIRECTION_FROM_ABOVE, Approximation::Method::METHOD_SHORTEST_PATH, 6);
-
-
-    std::cout << std::endl << std::endl << "RESULTS INNER APPROX : " << std::endl << std::endl;
-    equidistant_inner_approx.displayApprox();
-    std::cout << std::endl;
-    billonnet_inner_approx.displayApprox();
-    std::cout << std::endl;
-    shortest_path_inner_approx.displayApprox();
-    std::cout << std::endl;
-
-    std::cout << std::endl << std::endl << "RESULTS OUTER APPROX : " << std::endl << std::endl;
-    equidistant_outer_approx.displayApprox();
-    std::cout << std::endl;
-    billonnet_outer_approx.displayApprox();
-    std::cout << std::endl;
-    shortest_path_outer_approx.displayApprox();
-    std::cout << std::endl;
-    
-    return 0;
-}
+#include <ilcplex/ilocplex.h>
+ILOSTLBEGIN
+
+#include "tools/others.hpp"
+#include "instance/data.hpp"
+#include "solver/model.hpp"
+#include "solver/columngeneration.hpp"
+#include "solver/lagrangian.hpp"
+#include "runner/runner.hpp"
+#include "runner/service.hpp"
+#include "piecewise/approximation.hpp"
+
+int main(int argc, char *argv[]) {
+    /* Service mode: ./exec -service parameterFile.txt [socketPath] */
+    if ((argc == 3 || argc == 4) && std::string(argv[1]) == SERVICE_OPTION){
+        /* Without a socket, the standard output is left to the replies. */
+        std::ostream replies(std::cout.rdbuf());
+        if (argc == 3){
+            std::cout.rdbuf(std::cerr.rdbuf());
+        }
+        greetingMessage();
+        Data data(argv[2]);
+        Service service(data);
+        if (argc == 4){
+            service.serve(argv[3]);
+        }
+        else{
+            service.serve(std::cin, replies);
+        }
+        return 0;
+    }
+    greetingMessage();
+
+    /* Batch mode: ./exec -batch manifest.csv [threads [memoryMB]] */
+    if (argc >= 3 && argc <= 5 && std::string(argv[1]) == BATCH_OPTION){
+        const int    THREADS = (argc >= 4) ? std::atoi(argv[3]) : 0;
+        const double MEMORY  = (argc >= 5) ? std::atof(argv[4]) : 0.0;
+        Runner runner(argv[2], THREADS, MEMORY);
+        runner.run();
+        return 0;
+    }
+    std::string parameterFile = getParameter(argc, argv);
+
+    /* Build data */
+    Data data(parameterFile);
+    data.print();
+
+    /* Build cplex environment */
+    IloEnv env;
+	
+    if (!Runner::solve(env, data)){
+        env.end();
+        return 1;
+    }
+
+    /*** Finalization ***/
+    env.end();
+
+   
+    Approximation equidistant_inner_approx(Piecewise::buildLogFunction(2000, 0.75, 1.0), Approximation::Direction::DIRECTION_FROM_BELOW, Approximation::Method::METHOD_EQUIDISTANT, 6);
+    Approximation billonnet_inner_approx(Piecewise::buildLogFunction(2000, 0.75, 1.0), Approximation::Direction::DIRECTION_FROM_BELOW, Approximation::Method::METHOD_BILLONNET, 6);
+    Approximation shortest_path_inner_approx(Piecewise::buildLogFunction(2000, 0.75, 1.0), Approximation::Direction::DIRECTION_FROM_BELOW, Approximation::Method::METHOD_SHORTEST_PATH, 6);
+
+
+
+ 
+    Approximation equidistant_outer_approx(Piecewise::buildLogFunction(2000, 0.75, 1.0), Approximation::Direction::DIRECTION_FROM_ABOVE, Approximation::Method::METHOD_EQUIDISTANT, 6);
+    Approximation billonnet_outer_approx(Piecewise::buildLogFunction(2000, 0.75, 1.0), Approximation::Direction::DIRECTION_FROM_ABOVE, Approximation::Method::METHOD_BILLONNET, 6);
+    Approximation shortest_path_outer_approx(Piecewise::buildLogFunction(2000, 0.75, 1.0), Approximation::Direction::DIRECTION_FROM_ABOVE, Approximation::Method::METHOD_SHORTEST_PATH, 6);
+
+
+    std::cout << std::endl << std::endl << "RESULTS INNER APPROX : " << std::endl << std::endl;
+    equidistant_inner_approx.displayApprox();
+    std::cout << std::endl;
+    billonnet_inner_approx.displayApprox();
+    std::cout << std::endl;
+    shortest_path_inner_approx.displayApprox();
+    std::cout << std::endl;
+
+    std::cout << std::endl << std::endl << "RESULTS OUTER APPROX : " << std::endl << std::endl;
+    equidistant_outer_approx.displayApprox();
+    std::cout << std::endl;
+    billonnet_outer_approx.displayApprox();
+    std::cout << std::endl;
+    shortest_path_outer_approx.displayApprox();
+    std::cout << std::endl;
+    
+    return 0;
+}
@@ -23,7 +23,7 @@ class Demand{
 		const int				    target;		        /**< Demand target node id. **/
 		const double        		max_latency;     	/**< Demand maximum latency. **/
 		const double 				bandwidth;			/**< Demand requested bandwidth. **/
-		const double 				availability;		/**< Demand requested availability. **/
+		double 						availability;		/**< Demand requested availability. **/
         std::vector<int>            VNF_list;           /**< Demand VNF list. **/
 		std::vector<int>	        link_list;	        /**< List of the ids of links routing the demand. **/
 
@@ -73,6 +73,9 @@ class Demand{
 	/** Adds a requested VFN. @param id The VNF's id. **/
 	void addVNF(const int id) { this->VNF_list.push_back(id); }
 
+	/** Changes the requested availability. @param a The new requested availability. **/
+	void setAvailability(const double a) { this->availability = a; }
+
 	/****************************************************************************************/
 	/*										Display											*/
 	/****************************************************************************************/
@@ -0,0 +1,235 @@
+#include "runner.hpp"
+
+/* Serializes the reports of concurrent solves, so that they are not interleaved. */
+static std::mutex report_flag;
+
+/****************************************************************************************/
+/*										CONSTRUCTOR										*/
+/****************************************************************************************/
+
+Runner::Runner(const std::string manifest_, const int threadBudget_, const double memoryBudget_) : 
+                manifest(manifest_), threadBudget(threadBudget_), memoryBudget(memoryBudget_), 
+                nbSolved(0), nbFailed(0), reservedMemory(0.0), nbRunning(0)
+{
+}
+
+/****************************************************************************************/
+/*									MAIN OPERATIONS        								*/
+/****************************************************************************************/
+
+/* Solves every instance of the manifest. */
+void Runner::run()
+{
+    std::cout << "=> Running batch " << manifest << " ..." << std::endl;
+    Reader reader(manifest);
+    std::vector<std::vector<std::string> > dataList = reader.getData();
+    std::vector<Input> inputs;
+    // skip the first line (headers)
+    for (unsigned int i = 1; i < dataList.size(); i++){
+        if (dataList[i].empty()){
+            continue;
+        }
+        const std::string NODE_FILE   = (dataList[i].size() > 1) ? dataList[i][1] : "";
+        const std::string DEMAND_FILE = (dataList[i].size() > 2) ? dataList[i][2] : "";
+        inputs.push_back(Input(dataList[i][0], NODE_FILE, DEMAND_FILE));
+    }
+
+    if (threadBudget > 0){
+        runParallel(inputs);
+    }
+    else{
+        runSequential(inputs);
+    }
+    std::cout << "=> Batch over: " << nbSolved << " instances solved, " << nbFailed << " failed." << std::endl;
+}
+
+/* Solves the instances one after the other, in the order of the manifest. */
+void Runner::runSequential(const std::vector<Input>& inputs)
+{
+    for (unsigned int i = 0; i < inputs.size(); i++){
+        Data* data = buildData(inputs[i]);
+        if (solve(env, *data)){
+            nbSolved++;
+        }
+        else{
+            nbFailed++;
+        }
+        releaseData(data);
+    }
+}
+
+/* Solves the instances concurrently, largest first, within the thread and memory budgets. */
+void Runner::runParallel(const std::vector<Input>& inputs)
+{
+    /* Instances are built beforehand, so that topologies are read once and jobs can be sorted. */
+    std::vector<BatchJob> jobs(inputs.size());
+    std::vector<double> sizes(inputs.size());
+    for (unsigned int i = 0; i < inputs.size(); i++){
+        jobs[i].data   = buildData(inputs[i]);
+        jobs[i].size   = estimateSize(*jobs[i].data);
+        jobs[i].memory = jobs[i].size * SCHEDULER_BYTES_PER_VARIABLE / 1e6;
+        sizes[i] = jobs[i].size;
+    }
+    std::vector<int> order = getSortedIndexes_Desc(sizes);
+
+    const int NB_JOBS    = (int)jobs.size();
+    const int NB_WORKERS = std::max(1, std::min(NB_JOBS, threadBudget / SCHEDULER_THREADS_PER_JOB));
+    const int NB_THREADS = std::max(1, threadBudget / NB_WORKERS);
+    std::cout << "\t " << NB_WORKERS << " concurrent jobs with " << NB_THREADS << " threads each." << std::endl;
+
+    int next = 0;
+    auto work = [&](){
+        /* Concert environments are not thread safe: each worker owns one. */
+        IloEnv workerEnv;
+        while (true){
+            BatchJob job;
+            {
+                std::unique_lock<std::mutex> lock(thread_flag);
+                if (next >= NB_JOBS){
+                    break;
+                }
+                job = jobs[order[next++]];
+                released.wait(lock, [&](){ return nbRunning == 0 || memoryBudget <= 0.0 || reservedMemory + job.memory <= memoryBudget; });
+                reservedMemory += job.memory;
+                nbRunning++;
+            }
+            bool solved = solve(workerEnv, *job.data, NB_THREADS);
+            {
+                std::lock_guard<std::mutex> lock(thread_flag);
+                reservedMemory -= job.memory;
+                nbRunning--;
+                if (solved){
+                    nbSolved++;
+                }
+                else{
+                    nbFailed++;
+                }
+            }
+            released.notify_all();
+        }
+        workerEnv.end();
+    };
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < NB_WORKERS; w++){
+        workers.push_back(std::thread(work));
+    }
+    for (unsigned int w = 0; w < workers.size(); w++){
+        workers[w].join();
+    }
+    for (unsigned int i = 0; i < jobs.size(); i++){
+        releaseData(jobs[i].data);
+    }
+}
+
+/* Builds an instance, reusing its topology if it was already read. */
+Data* Runner::buildData(const Input& input)
+{
+    const std::string KEY = getTopologyKey(input);
+    std::map<std::string, Data*>::const_iterator it = topologies.find(KEY);
+    if (it != topologies.end()){
+        return new Data(*(it->second), input);
+    }
+    Data* data = new Data(input);
+    topologies[KEY] = data;
+    return data;
+}
+
+/* Deletes an instance unless it is a stored topology. */
+void Runner::releaseData(Data* data)
+{
+    std::map<std::string, Data*>::const_iterator it = topologies.find(getTopologyKey(data->getInput()));
+    if (it == topologies.end() || it->second != data){
+        delete data;
+    }
+}
+
+/* Solves an instance with the engine its parameters select, then prints and outputs the results. */
+bool Runner::solve(const IloEnv& env, const Data& data, const int nbThreads)
+{
+    try
+    {
+        if (data.getInput().getSolverEngine() == Input::SOLVER_ENGINE_COLUMN_GENERATION){
+            /* Build master */
+            ColumnGeneration master(env, data);
+
+            /* Run column generation, its Concert objects being ended from the shared environment even on failure */
+            try {
+                if (nbThreads > 0){
+                    master.setThreads(nbThreads);
+                }
+                master.run();
+
+                /* Print results */
+                std::lock_guard<std::mutex> lock(report_flag);
+                master.printResult();
+                master.output();
+            }
+            catch (...) { master.end(); throw; }
+            master.end();
+        }
+        else if (data.getInput().getSolverEngine() == Input::SOLVER_ENGINE_LAGRANGIAN){
+            /* Build subproblems */
+            Lagrangian lagrangian(data, nbThreads);
+
+            /* Run subgradient */
+            lagrangian.run();
+
+            /* Print results */
+            std::lock_guard<std::mutex> lock(report_flag);
+            lagrangian.printResult();
+            lagrangian.output();
+        }
+        else{
+            /* Build model */
+            Model model(env, data);
+
+            /* Run model, its Concert objects being ended from the shared environment even on failure */
+            try {
+                if (nbThreads > 0){
+                    model.setThreads(nbThreads);
+                }
+                model.run();
+
+                /* Print results */
+                std::lock_guard<std::mutex> lock(report_flag);
+                model.printResult();
+                model.output();
+            }
+            catch (...) { model.end(); throw; }
+            model.end();
+        }
+    }
+    catch (const IloException& e) { std::cerr << "Exception caught: " << e << std::endl; return false; }
+    catch (...) { std::cerr << "Unknown exception caught!" << std::endl; return false; }
+    return true;
+}
+
+/****************************************************************************************/
+/*									QUERY METHODS        								*/
+/****************************************************************************************/
+
+/* Returns the estimated number of variables of the compact model of an instance: flows dominate, then section and path placements, then global placements. */
+double Runner::estimateSize(const Data& data)
+{
+    const double NB_NODES = data.getNbNodes();
+    const double NB_ARCS  = (double)data.getLinks().size();
+    double size = NB_NODES * data.getNbVnfs();
+    for (int k = 0; k < data.getNbDemands(); k++){
+        const double NB_VNFS = data.getDemand(k).getNbVNFs();
+        size += data.getNbPaths(k) * ((NB_VNFS + 1) * NB_ARCS + (NB_VNFS + 1) * NB_NODES + 5);
+    }
+    return size;
+}
+
+/****************************************************************************************/
+/*										DESTRUCTOR										*/
+/****************************************************************************************/
+
+Runner::~Runner()
+{
+    for (std::map<std::string, Data*>::iterator it = topologies.begin(); it != topologies.end(); ++it){
+        delete it->second;
+    }
+    env.end();
+}
@@ -0,0 +1,118 @@
+#ifndef __runner__hpp
+#define __runner__hpp
+
+/****************************************************************************************/
+/*										LIBRARIES										*/
+/****************************************************************************************/
+
+/*** C++ Libraries ***/
+#include <map>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/*** CPLEX Libraries ***/
+#include <ilcplex/ilocplex.h>
+ILOSTLBEGIN
+
+/*** Own Libraries ***/
+#include "../tools/others.hpp"
+#include "../instance/data.hpp"
+#include "../solver/model.hpp"
+#include "../solver/columngeneration.hpp"
+#include "../solver/lagrangian.hpp"
+
+/****************************************************************************************/
+/*										DEFINES			    							*/
+/****************************************************************************************/
+#define BATCH_OPTION "-batch" 					// Command line option running a manifest of instances
+#define SCHEDULER_THREADS_PER_JOB 4 			// Threads each concurrent job should get at least
+#define SCHEDULER_BYTES_PER_VARIABLE 2048.0 	// Estimated memory footprint of a model variable with its share of rows, in bytes
+
+/********************************************************************************************
+ * A job of a parallel batch: an instance with the estimates used to schedule it.
+********************************************************************************************/
+struct BatchJob {
+	Data* 	data; 			/**< The instance. **/
+	double 	size; 			/**< The estimated number of variables of its model, a proxy of its solve time. **/
+	double 	memory; 		/**< The estimated memory footprint of its model, in MB. **/
+};
+
+/********************************************************************************************
+ * This class runs a batch of instances within a single process. The manifest is a .csv file
+ * whose first line holds headers and whose other lines are a parameters file, optionally
+ * followed by a node file and a demand file replacing those the parameters file declares.
+ * Each topology (node, link and VNF files) is read once and shared by the instances built
+ * on it. Results are appended to the output file of each instance as soon as it is solved.
+ * 
+ * Without a thread budget, instances are solved one after the other in a single CPLEX
+ * environment, each model being ended after its instance. With a thread budget, instances
+ * are solved concurrently by workers owning their environment. The budget is split evenly
+ * among workers through the CPLEX Threads parameter, the largest models are started first
+ * and a job waits until its estimated memory fits within the memory budget, unless nothing
+ * else is running.
+********************************************************************************************/
+class Runner {
+
+private:
+	const std::string 				manifest; 		/**< The manifest file. **/
+	int 							threadBudget; 	/**< Number of threads shared by concurrent jobs, 0 for a sequential batch. **/
+	double 							memoryBudget; 	/**< Memory in MB running jobs may reserve, 0 for no limit. **/
+	IloEnv 							env; 			/**< The environment shared by every model of a sequential batch. **/
+	std::map<std::string, Data*> 	topologies; 	/**< topologies[key] is the first instance read on the topology identified by key. **/
+	int 							nbSolved; 		/**< Number of instances solved. **/
+	int 							nbFailed; 		/**< Number of instances whose solve raised an exception. **/
+
+	/*** Parallel scheduling ***/
+	std::mutex 						thread_flag; 	/**< A mutex for synchronizing multi-thread operations. **/
+	std::condition_variable 		released; 		/**< Notified when a job ends and releases its memory. **/
+	double 							reservedMemory; /**< Estimated memory of the running jobs, in MB. **/
+	int 							nbRunning; 		/**< Number of running jobs. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. @param manifest The manifest file. @param threadBudget Number of threads shared by concurrent jobs, 0 for a sequential batch. @param memoryBudget Memory in MB running jobs may reserve, 0 for no limit. **/
+	Runner(const std::string manifest, const int threadBudget = 0, const double memoryBudget = 0.0);
+
+	/****************************************************************************************/
+	/*									Main operations  									*/
+	/****************************************************************************************/
+	/** Solves every instance of the manifest. **/
+	void run();
+
+	/** Solves the instances one after the other, in the order of the manifest. @param inputs The input parameters of each instance. **/
+	void runSequential(const std::vector<Input>& inputs);
+
+	/** Solves the instances concurrently, largest first, within the thread and memory budgets. @param inputs The input parameters of each instance. **/
+	void runParallel(const std::vector<Input>& inputs);
+
+	/** Builds an instance, reusing its topology if it was already read. @param input The input parameters. @note The returned instance must be released through releaseData. **/
+	Data* buildData(const Input& input);
+
+	/** Deletes an instance unless it is a stored topology. @param data The instance. **/
+	void releaseData(Data* data);
+
+	/** Solves an instance with the engine its parameters select, then prints and outputs the results. Returns false if an exception was raised. @param env The environment hosting the models, reusable afterwards. @param data The instance. @param nbThreads The number of threads CPLEX, or the Lagrangian subproblems, may use, 0 to leave it free. @note Reports of concurrent calls are not interleaved. **/
+	static bool solve(const IloEnv& env, const Data& data, const int nbThreads = 0);
+
+	/****************************************************************************************/
+	/*								      Query Methods	    	    	    				*/
+	/****************************************************************************************/
+	/** Returns the key identifying the topology of an input, made of its node, link and VNF files. **/
+	static std::string getTopologyKey(const Input& input) { return input.getNodeFile() + ";" + input.getLinkFile() + ";" + input.getVnfFile(); }
+
+	/** Returns the estimated number of variables of the compact model of an instance. **/
+	static double estimateSize(const Data& data);
+
+	/****************************************************************************************/
+	/*										Destructors			    						*/
+	/****************************************************************************************/
+	/** Destructor. Frees the topologies and ends the environment. **/
+	~Runner();
+};
+
+#endif
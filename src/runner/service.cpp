@@ -0,0 +1,399 @@
+#include "service.hpp"
+
+#include <sstream>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../solver/constructive.hpp"
+#include "../tools/reader.hpp"
+
+/****************************************************************************************/
+/*										Constructors									*/
+/****************************************************************************************/
+
+/* Constructor. Builds the resident model and plans the demands of the instance. */
+Service::Service(Data& data_) : data(data_), model(NULL), running(true), nbAccepted(0), nbRejected(0)
+{
+    if (data.getInput().getSolverEngine() != Input::SOLVER_ENGINE_COMPACT || data.getInput().isRelaxation()){
+        std::cerr << "ERROR: The service requires the compact engine solved as a MIP. Abort." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    model = new Model(env, data);
+    plan.resize(data.getNbDemands());
+
+    std::cout << "=> Planning the initial demands ..." << std::endl;
+    model->run();
+    if (model->getSolution().isLoaded() && model->getViolations().empty()){
+        storePlan();
+    }
+    else{
+        /* Without a valid initial plan, the service starts from an empty network. */
+        std::cout << "WARNING: No valid plan for the initial demands. They are removed from the service." << std::endl;
+        for (int k = 0; k < data.getNbDemands(); k++){
+            data.removeDemand(k);
+            model->removeDemand(k);
+        }
+    }
+    model->setTimeLimit(data.getInput().getServiceTimeLimit());
+    std::cout << "=> Service ready." << std::endl;
+}
+
+/****************************************************************************************/
+/*									Main operations  									*/
+/****************************************************************************************/
+
+/* Answers the requests read from a stream until it ends or a QUIT request is received. */
+void Service::serve(std::istream& in, std::ostream& out)
+{
+    /* Replies keep the original buffer of the reply stream, even when it is the standard output. */
+    std::ostream replies(out.rdbuf());
+    std::streambuf* logs = std::cout.rdbuf(std::cerr.rdbuf());
+    std::string line;
+    while (running && std::getline(in, line)){
+        const std::string REPLY = handle(line);
+        if (!REPLY.empty()){
+            replies << REPLY << std::endl;
+        }
+    }
+    std::cout.rdbuf(logs);
+}
+
+/* Answers the requests of the clients of a local UNIX socket, one client at a time, until a QUIT request is received. */
+void Service::serve(const std::string& socketPath)
+{
+    struct sockaddr_un address;
+    if (socketPath.size() >= sizeof(address.sun_path)){
+        std::cerr << "ERROR: The socket path " << socketPath << " is too long. Abort." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    const int LISTENER = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath.c_str());
+    if (LISTENER < 0 || bind(LISTENER, (struct sockaddr*)&address, sizeof(address)) < 0 || listen(LISTENER, SERVICE_BACKLOG) < 0){
+        std::cerr << "ERROR: Could not listen on socket " << socketPath << ": " << std::strerror(errno) << ". Abort." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::cout << "=> Listening on " << socketPath << " ..." << std::endl;
+
+    char buffer[SERVICE_BUFFER_SIZE];
+    while (running){
+        const int CLIENT = accept(LISTENER, NULL, NULL);
+        if (CLIENT < 0){
+            if (errno == EINTR) continue;
+            std::cerr << "ERROR: Could not accept a client: " << std::strerror(errno) << "." << std::endl;
+            break;
+        }
+        /* Requests may be split over several reads: only complete lines are answered. */
+        std::string pending;
+        bool connected = true;
+        while (running && connected){
+            const ssize_t NB_READ = read(CLIENT, buffer, SERVICE_BUFFER_SIZE);
+            if (NB_READ <= 0){
+                connected = false;
+                break;
+            }
+            pending.append(buffer, NB_READ);
+            std::size_t end = pending.find('\n');
+            while (running && connected && end != std::string::npos){
+                const std::string REPLY = handle(pending.substr(0, end));
+                pending.erase(0, end + 1);
+                if (!REPLY.empty()){
+                    connected = writeAll(CLIENT, REPLY + "\n");
+                }
+                end = pending.find('\n');
+            }
+        }
+        close(CLIENT);
+    }
+    close(LISTENER);
+    unlink(socketPath.c_str());
+}
+
+/* Answers a request. Returns the reply, empty if the request is blank. */
+std::string Service::handle(const std::string& request)
+{
+    const std::vector<std::string> FIELDS = split(request, SERVICE_DELIMITER);
+    if (FIELDS.empty()){
+        return "";
+    }
+    const std::chrono::steady_clock::time_point START = std::chrono::steady_clock::now();
+    std::string reply;
+    try {
+        if (FIELDS[0] == "ADD"){
+            reply = admit(FIELDS);
+        }
+        else if (FIELDS[0] == "UPDATE"){
+            reply = update(FIELDS);
+        }
+        else if (FIELDS[0] == "REMOVE"){
+            reply = release(FIELDS);
+        }
+        else if (FIELDS[0] == "QUIT"){
+            running = false;
+            reply = "BYE";
+        }
+        else{
+            reply = "ERROR;unknown request " + FIELDS[0];
+        }
+    }
+    catch (IloException& e){
+        std::ostringstream message;
+        message << e;
+        reply = "ERROR;" + message.str();
+    }
+    const double ELAPSED = std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count();
+    std::cout << "=> " << FIELDS[0] << " answered in " << ELAPSED << " s: " << reply << std::endl;
+    return reply;
+}
+
+/* Adds a demand and tries to serve it. */
+std::string Service::admit(const std::vector<std::string>& fields)
+{
+    if (fields.size() < 7 || fields.size() > 8){
+        return "ERROR;ADD expects name;source;target;latency;bandwidth;availability;vnfs";
+    }
+    const std::string NAME = fields[1];
+    if (!data.hasNodeName(fields[2]) || !data.hasNodeName(fields[3])){
+        return "ERROR;unknown node";
+    }
+    if (!isNumber(fields[4]) || !isNumber(fields[5]) || !isNumber(fields[6])){
+        return "ERROR;latency, bandwidth and availability must be numbers";
+    }
+    const double AVAILABILITY = std::stod(fields[6]);
+    if (AVAILABILITY < 0.0 || AVAILABILITY >= 1.0){
+        return "ERROR;availability must lie in [0,1)";
+    }
+    Demand demand(data.getNbDemands(), NAME, data.getIdFromNodeName(fields[2]), data.getIdFromNodeName(fields[3]), std::stod(fields[4]), std::stod(fields[5]), AVAILABILITY);
+    if (fields.size() == 8){
+        const std::vector<std::string> VNFS = split(fields[7], ",");
+        for (unsigned int i = 0; i < VNFS.size(); i++){
+            if (!data.hasVnfName(VNFS[i])){
+                return "ERROR;unknown vnf " + VNFS[i];
+            }
+            demand.addVNF(data.getIdFromVnfName(VNFS[i]));
+        }
+    }
+    if (!isReachable(AVAILABILITY)){
+        nbRejected++;
+        return "REJECTED;" + NAME + ";availability out of reach";
+    }
+
+    const int k = data.addDemand(demand);
+    plan.resize(data.getNbDemands());
+    model->addDemand(k);
+    const std::string ORIGIN = replan(k);
+    if (ORIGIN.empty()){
+        data.removeDemand(k);
+        model->removeDemand(k);
+        nbRejected++;
+        return "REJECTED;" + NAME + ";no valid plan found";
+    }
+    nbAccepted++;
+    return getAcceptedReply(k, ORIGIN);
+}
+
+/* Changes the availability requested by a demand and tries to serve it. */
+std::string Service::update(const std::vector<std::string>& fields)
+{
+    if (fields.size() != 3){
+        return "ERROR;UPDATE expects id;availability";
+    }
+    const int k = getDemandId(fields[1]);
+    if (k < 0){
+        return "ERROR;unknown demand " + fields[1];
+    }
+    if (!isNumber(fields[2])){
+        return "ERROR;availability must be a number";
+    }
+    const double AVAILABILITY = std::stod(fields[2]);
+    if (AVAILABILITY < 0.0 || AVAILABILITY >= 1.0){
+        return "ERROR;availability must lie in [0,1)";
+    }
+    if (!isReachable(AVAILABILITY)){
+        nbRejected++;
+        return "REJECTED;" + fields[1] + ";availability out of reach";
+    }
+
+    /* On failure, the demand keeps its previous requirement and paths. */
+    const double PREVIOUS = data.getDemand(k).getAvailability();
+    data.setDemandAvailability(k, AVAILABILITY);
+    model->updateAvailabilityRequirement(k);
+    const std::string ORIGIN = replan(k);
+    if (ORIGIN.empty()){
+        data.setDemandAvailability(k, PREVIOUS);
+        model->updateAvailabilityRequirement(k);
+        nbRejected++;
+        return "REJECTED;" + fields[1] + ";no valid plan found";
+    }
+    nbAccepted++;
+    return getAcceptedReply(k, ORIGIN);
+}
+
+/* Removes a demand, freeing the resources of its paths. */
+std::string Service::release(const std::vector<std::string>& fields)
+{
+    if (fields.size() != 2){
+        return "ERROR;REMOVE expects id";
+    }
+    const int k = getDemandId(fields[1]);
+    if (k < 0){
+        return "ERROR;unknown demand " + fields[1];
+    }
+    /* The current plan stays valid without the demand: no re-planning is needed. */
+    data.removeDemand(k);
+    model->removeDemand(k);
+    plan[k].clear();
+    return "REMOVED;" + fields[1];
+}
+
+/* Plans demand k around the current plan after it changed. Returns the origin of its new plan, empty if it cannot be served. */
+std::string Service::replan(const int k)
+{
+    std::cout << "=> Re-planning demand " << k << " ..." << std::endl;
+    /* Accepted demands keep their hosts and routes: their clients are never told of a change. */
+    for (int j = 0; j < data.getNbDemands(); j++){
+        if (j != k && !plan[j].empty()){
+            model->fixDemand(j, plan[j]);
+        }
+    }
+    try {
+        model->run();
+    }
+    catch (...){
+        model->releaseDemands();
+        throw;
+    }
+    model->releaseDemands();
+    if (model->getSolution().isLoaded() && model->getViolations().empty()){
+        storePlan();
+        return "MIP";
+    }
+    std::cout << "=> No valid plan found by CPLEX in time. Trying the constructive heuristic ..." << std::endl;
+    if (repair(k)){
+        return "HEURISTIC";
+    }
+    return "";
+}
+
+/* Serves demand k with the constructive heuristic, the other demands keeping their current paths. */
+bool Service::repair(const int k)
+{
+    Constructive heuristic(data);
+    for (int j = 0; j < data.getNbDemands(); j++){
+        if (j != k && !plan[j].empty() && !heuristic.fixDemand(j, plan[j])){
+            return false;
+        }
+    }
+    if (!heuristic.buildDemand(k)){
+        return false;
+    }
+    plan[k] = heuristic.getPaths(k);
+    return true;
+}
+
+/* Copies the paths of the last solution of the model into the plan. */
+void Service::storePlan()
+{
+    const Solution& solution = model->getSolution();
+    for (int k = 0; k < data.getNbDemands(); k++){
+        plan[k].clear();
+        if (data.isDemandRemoved(k)){
+            continue;
+        }
+        for (int p = 0; p < data.getNbPaths(k); p++){
+            if (solution.isActive(k, p)){
+                plan[k].push_back(solution.getPath(k, p));
+            }
+        }
+    }
+}
+
+/****************************************************************************************/
+/*								      Query Methods	    	    	    				*/
+/****************************************************************************************/
+
+/* Returns the reply describing the plan of demand k. */
+std::string Service::getAcceptedReply(const int k, const std::string& origin) const
+{
+    std::string reply = "ACCEPTED" + std::string(SERVICE_DELIMITER) + std::to_string(k) + SERVICE_DELIMITER + origin;
+    for (unsigned int p = 0; p < plan[k].size(); p++){
+        const ChainPath& PATH = plan[k][p];
+        reply += SERVICE_DELIMITER;
+        reply += "hosts=";
+        for (unsigned int i = 0; i < PATH.hosts.size(); i++){
+            if (i > 0) reply += ",";
+            reply += data.getNode(PATH.hosts[i]).getName();
+        }
+        reply += " route=" + data.getNode(data.getDemand(k).getSource()).getName();
+        for (unsigned int i = 0; i < PATH.sections.size(); i++){
+            for (unsigned int a = 0; a < PATH.sections[i].size(); a++){
+                reply += "," + data.getNode(data.getLink(PATH.sections[i][a]).getTarget()).getName();
+            }
+        }
+    }
+    return reply;
+}
+
+/* Returns the id of the demand named by a request field, or -1 if there is no such demand served. */
+int Service::getDemandId(const std::string& field) const
+{
+    if (field.empty() || field.find_first_not_of("0123456789") != std::string::npos || field.size() > 9){
+        return -1;
+    }
+    const int k = std::stoi(field);
+    if (k >= data.getNbDemands() || data.isDemandRemoved(k)){
+        return -1;
+    }
+    return k;
+}
+
+/* Returns true if an availability can be met by placing VNFs on every node in parallel. Higher requirements would make the data abort. */
+bool Service::isReachable(const double availability) const
+{
+    std::vector<int> nodes(data.getNbNodes());
+    for (int v = 0; v < data.getNbNodes(); v++){
+        nodes[v] = v;
+    }
+    return availability <= data.getParallelAvailability(nodes);
+}
+
+/* Returns true if a request field is a number. */
+bool Service::isNumber(const std::string& field)
+{
+    std::istringstream stream(field);
+    double value;
+    stream >> value;
+    return !stream.fail() && stream.eof();
+}
+
+/* Writes a whole string to a file descriptor. Returns false if the descriptor was closed. */
+bool Service::writeAll(const int fd, const std::string& str)
+{
+    std::size_t written = 0;
+    while (written < str.size()){
+        const ssize_t NB_WRITTEN = write(fd, str.c_str() + written, str.size() - written);
+        if (NB_WRITTEN < 0 && errno == EINTR) continue;
+        if (NB_WRITTEN <= 0) return false;
+        written += NB_WRITTEN;
+    }
+    return true;
+}
+
+/****************************************************************************************/
+/*										Destructors			    						*/
+/****************************************************************************************/
+
+/* Destructor. Ends the resident model and its environment. */
+Service::~Service()
+{
+    std::cout << "=> Service stopped: " << nbAccepted << " accepted and " << nbRejected << " rejected requests." << std::endl;
+    model->end();
+    delete model;
+    env.end();
+}
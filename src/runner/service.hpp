@@ -0,0 +1,118 @@
+#ifndef __service__hpp
+#define __service__hpp
+
+/****************************************************************************************/
+/*										LIBRARIES										*/
+/****************************************************************************************/
+
+/*** C++ Libraries ***/
+#include <string>
+#include <vector>
+#include <chrono>
+
+/*** CPLEX Libraries ***/
+#include <ilcplex/ilocplex.h>
+ILOSTLBEGIN
+
+/*** Own Libraries ***/
+#include "../instance/data.hpp"
+#include "../solver/model.hpp"
+
+/****************************************************************************************/
+/*										DEFINES			    							*/
+/****************************************************************************************/
+#define SERVICE_OPTION "-service" 			// Command line option running the admission service
+#define SERVICE_DELIMITER ";" 				// Field delimiter of requests and replies, as in the demand files
+#define SERVICE_BACKLOG 8 					// Pending connections queued on the service socket
+#define SERVICE_BUFFER_SIZE 4096 			// Bytes read from a client at once
+
+/********************************************************************************************
+ * This class runs an admission service on resident data and a resident model. The instance
+ * is read and the model built once; each request then updates the model incrementally and
+ * plans the requested demand within the service time limit, the accepted demands being fixed
+ * to their current paths. If CPLEX finds no valid plan in time, the constructive heuristic
+ * tries to serve the request around the current plan. Requests are read line by line, from the standard input or from the clients
+ * of a local UNIX socket, and each gets a one-line reply. Fields are separated by ';':
+ *  - ADD;name;source;target;latency;bandwidth;availability;vnf1,vnf2,...
+ *    replies ACCEPTED;id;origin;path;... or REJECTED;name;reason.
+ *  - UPDATE;id;availability replies ACCEPTED;id;origin;path;... or REJECTED;id;reason.
+ *  - REMOVE;id replies REMOVED;id.
+ *  - QUIT replies BYE and stops the service.
+ * Nodes and VNFs are given by name, as in the demand files. Each path is written as
+ * "hosts=A,B route=S,A,B,T", listing its hosts and the nodes it goes through. Malformed
+ * requests are answered by ERROR;reason.
+********************************************************************************************/
+class Service {
+
+private:
+	Data& 									data; 		/**< The resident instance, which demands are added to and removed from. **/
+	IloEnv 									env; 		/**< The environment of the resident model. **/
+	Model* 									model; 		/**< The resident model. **/
+	std::vector<std::vector<ChainPath> > 	plan; 		/**< plan[k] are the paths serving demand k in the current plan, empty if it is not served. **/
+	bool 									running; 	/**< False once a QUIT request was received. **/
+	int 									nbAccepted; /**< Number of accepted requests. **/
+	int 									nbRejected; /**< Number of rejected requests. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. Builds the resident model and plans the demands of the instance. @param data The instance. @note Only the compact engine, solved as a MIP, can be updated incrementally. **/
+	Service(Data& data);
+
+	/****************************************************************************************/
+	/*									Main operations  									*/
+	/****************************************************************************************/
+	/** Answers the requests read from a stream until it ends or a QUIT request is received. @param in The request stream. @param out The reply stream. @note Logs are sent to the standard error meanwhile, so that replies are not mixed with them. **/
+	void serve(std::istream& in, std::ostream& out);
+
+	/** Answers the requests of the clients of a local UNIX socket, one client at a time, until a QUIT request is received. @param socketPath The path of the socket. **/
+	void serve(const std::string& socketPath);
+
+	/** Answers a request. Returns the reply, empty if the request is blank. @param request The request line. **/
+	std::string handle(const std::string& request);
+
+	/** Adds a demand and tries to serve it. @param fields The request fields. **/
+	std::string admit(const std::vector<std::string>& fields);
+
+	/** Changes the availability requested by a demand and tries to serve it. @param fields The request fields. **/
+	std::string update(const std::vector<std::string>& fields);
+
+	/** Removes a demand, freeing the resources of its paths. @param fields The request fields. **/
+	std::string release(const std::vector<std::string>& fields);
+
+	/** Plans demand k after it changed, the other demands keeping their current paths. Returns the origin of its new plan, empty if it cannot be served. @param k The demand id. **/
+	std::string replan(const int k);
+
+	/** Serves demand k with the constructive heuristic, the other demands keeping their current paths. Returns true if it succeeds. @param k The demand id. **/
+	bool repair(const int k);
+
+	/** Copies the paths of the last solution of the model into the plan. **/
+	void storePlan();
+
+	/****************************************************************************************/
+	/*								      Query Methods	    	    	    				*/
+	/****************************************************************************************/
+	/** Returns the reply describing the plan of demand k. @param k The demand id. @param origin The method that found the plan. **/
+	std::string getAcceptedReply(const int k, const std::string& origin) const;
+
+	/** Returns the id of the demand named by a request field, or -1 if there is no such demand served. @param field The request field. **/
+	int getDemandId(const std::string& field) const;
+
+	/** Returns true if an availability can be met at all on the network. @param availability The requested availability. **/
+	bool isReachable(const double availability) const;
+
+	/** Returns true if a request field is a number. @param field The request field. **/
+	static bool isNumber(const std::string& field);
+
+	/** Writes a whole string to a file descriptor. Returns false if the descriptor was closed. **/
+	static bool writeAll(const int fd, const std::string& str);
+
+	/****************************************************************************************/
+	/*										Destructors			    						*/
+	/****************************************************************************************/
+	/** Destructor. Ends the resident model and its environment. **/
+	~Service();
+};
+
+#endif
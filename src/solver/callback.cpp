@@ -4,18 +4,20 @@
 /*										CONSTRUCTOR										*/
 /****************************************************************************************/
 
-Callback::Callback(const IloEnv& env_, const Data& data_, const IloNumVar3DMatrix& y_, const IloNumVar4DMatrix& x_, const IloNumVarMatrix& alpha_) :
-	                env(env_), data(data_),	y(y_), x(x_), alpha(alpha_), cutPool(env)
+Callback::Callback(const IloEnv& env_, const Data& data_, const IloNumVar3DMatrix& y_, const IloNumVar4DMatrix& x_, const IloNumVarMatrix& alpha_, const bool candidateOnly_) :
+	                env(env_), data(data_),	y(y_), x(x_), alpha(alpha_), candidateOnly(candidateOnly_), availabilityCheck(!data_.getInput().isRefinementOn()), poolVars(env), routing(NULL), separationPool(NULL), solutionPool(NULL), repairObj(0.0), hasRepair(false), stats(NULL), nbStats(0)
 {	
 	/*** Control ***/
-    thread_flag.lock();
 	nb_cuts_avail_heuristic = 0;
-    nbLazyConstraints = 0;
-    nbUserCuts = 0;
-    nbCuts = 0;
-	timeAll = 0.0;
+    candidateVars = IloNumVarArray(env);
+    repairVars = IloNumVarArray(env);
+    hostVars = IloNumVarArray(env);
+    setNbThreads(0);
     setCutPool();
-    thread_flag.unlock();
+    if (data.getInput().getSolverEngine() == Input::SOLVER_ENGINE_BENDERS){
+        routing = new Routing(data);
+    }
+    separationPool = new TaskPool(candidateOnly ? 1 : data.getInput().getSeparationThreads());
 }
 
 /****************************************************************************************/
@@ -27,22 +29,55 @@ void Callback::invoke(const Context& context)
     switch (context.getId()){
         /* Fractional solution */
         case Context::Id::Relaxation:
+            /* A pruned node needs neither heuristics nor cuts. */
+            if (data.getInput().getPropagation() == Input::PROPAGATION_ON && propagateAvailability(context)){
+                break;
+            }
+            if (solutionPool != NULL){
+                postHeuristicSolutions(context);
+            }
+            if (data.getInput().getRepairHeuristic() == Input::REPAIR_HEURISTIC_ON){
+                postRepairedSolution(context);
+            }
             addUserCuts(context);
+            /* Separation is only run once no pooled cut is violated. */
+            if (data.getInput().isAvailabilityCutsOn() && !checkCutPool(context)){
+                pathSupportSeparation(context);
+            }
             break;
 
         /* Integer solution */
         case Context::Id::Candidate:
 			if (context.isCandidatePoint()) {
-	    		addLazyConstraints(context);
+                /* The placement is fetched once, every candidate check reading from the buffer. */
+                const IloNumArray& point = fetchCandidatePoint(context);
+                bool rejected = false;
+                if (data.getInput().isAvailabilityCutsOn()){
+                    rejected = pathSupportSeparation(context, &point);
+                }
+                if (!rejected && isAvailabilityLazyRequired()){
+	    		    rejected = addLazyConstraints(context, point);
+                }
+                if (!rejected && routing != NULL){
+                    rejected = addRoutingCuts(context, point);
+                }
+                if (!rejected && solutionPool != NULL){
+                    publishIncumbent(context);
+                }
 			}
             break;
 
+        /* Branching decision */
+        case Context::Id::Branching:
+            makeStructuredBranch(context);
+            break;
+
         /* Not an option for callback */
 		default:
 			throw IloCplex::Exception(-1, "ERROR: Unexpected context ID !");
     }
     IloNum time_spent = context.getDoubleInfo(IloCplex::Callback::Context::Info::Time) - time_start;
-    incrementTime(time_spent);
+    incrementTime(context, time_spent);
 }
 
 
@@ -52,27 +87,183 @@ void Callback::invoke(const Context& context)
 /** Sets up the cut pool that is checked on relaxation context. On this pool only cuts appearing in a polynomial number are added. **/
 void Callback::setCutPool()
 {
-    std::cout << "---- Setting cut pool ----" << std::endl;
-    cutPool.clear();
+    if (!candidateOnly){
+        std::cout << "---- Setting cut pool ----" << std::endl;
+    }
+    std::lock_guard<std::mutex> lock(pool_flag);
+    poolVars.clear();
+    poolColumn.clear();
+    poolRowStart.assign(1, 0);
+    poolIndex.clear();
+    poolCoef.clear();
+    poolLB.clear();
+    poolUB.clear();
 }
 
-/* Checks whether the current solution satisfies all cuts in the pool and add the unsatisfied one. */
+/* Stores a cut in the pool, to be added again wherever it is violated. */
+void Callback::addToCutPool(const IloRange& cut)
+{
+    std::lock_guard<std::mutex> lock(pool_flag);
+    const IloNum CONSTANT = cut.getExpr().getConstant();
+    for (IloExpr::LinearIterator it = cut.getExpr().getLinearIterator(); it.ok(); ++it){
+        const IloNumVar VAR = it.getVar();
+        std::unordered_map<IloInt, int>::const_iterator found = poolColumn.find(VAR.getId());
+        int column = 0;
+        if (found == poolColumn.end()){
+            column = (int)poolVars.getSize();
+            poolColumn[VAR.getId()] = column;
+            poolVars.add(VAR);
+        }
+        else{
+            column = found->second;
+        }
+        poolIndex.push_back(column);
+        poolCoef.push_back(it.getCoef());
+    }
+    poolRowStart.push_back((int)poolIndex.size());
+    poolLB.push_back(cut.getLB() - CONSTANT);
+    poolUB.push_back(cut.getUB() - CONSTANT);
+}
+
+/* Sets up the pool through which solutions are exchanged with the improvement heuristics. */
+void Callback::setSolutionPool(SolutionPool* pool, const IloNumVarArray& vars)
+{
+    solutionPool = pool;
+    solutionVars = vars;
+}
+
+/* Replaces the threads sharing the per-demand separation work. */
+void Callback::setSeparationThreads(const int nbThreads)
+{
+    if (separationPool->getNbThreads() == std::max(1, nbThreads)){
+        return;
+    }
+    delete separationPool;
+    separationPool = new TaskPool(nbThreads);
+}
+
+/* Sets the number of CPLEX threads statistics are gathered from, keeping the totals gathered so far. */
+void Callback::setNbThreads(const int nbThreads)
+{
+    /* CPLEX never runs more threads than cores when left to choose. */
+    const int NB_SLOTS = std::max(1, std::max(nbThreads, (int)std::thread::hardware_concurrency()));
+    const ThreadStats TOTAL = getTotalStats();
+
+    statsBuffer.assign((NB_SLOTS + 1) * sizeof(ThreadStats), 0);
+    void* start = statsBuffer.data();
+    std::size_t space = statsBuffer.size();
+    stats = static_cast<ThreadStats*>(std::align(alignof(ThreadStats), NB_SLOTS * sizeof(ThreadStats), start, space));
+    nbStats = NB_SLOTS;
+    for (int t = 0; t < nbStats; t++){
+        new (&stats[t]) ThreadStats();
+    }
+    stats[0] = TOTAL;
+
+    /* One candidate buffer per slot as well. */
+    setCandidateVariables();
+}
+
+/* Sets up the flat index of the variables fetched on each candidate, once the variables of the demands changed. */
+void Callback::setCandidateVariables()
+{
+    candidateVars.clear();
+    candidateOffset.assign(data.getNbDemands(), 0);
+    for (int k = 0; k < data.getNbDemands() && k < (int)alpha.size(); k++){
+        candidateOffset[k] = (int)candidateVars.getSize();
+        for (unsigned int p = 0; p < alpha[k].size(); p++){
+            candidateVars.add(alpha[k][p]);
+        }
+        for (unsigned int v = 0; v < y[k].size(); v++){
+            for (unsigned int p = 0; p < y[k][v].size(); p++){
+                candidateVars.add(y[k][v][p]);
+            }
+        }
+    }
+    /* Repaired solutions also set the section placement variables. */
+    hostVars.clear();
+    hostOffset.assign(data.getNbDemands(), 0);
+    for (int k = 0; k < data.getNbDemands() && k < (int)x.size(); k++){
+        hostOffset[k] = (int)(candidateVars.getSize() + hostVars.getSize());
+        for (unsigned int v = 0; v < x[k].size(); v++){
+            for (unsigned int i = 0; i < x[k][v].size(); i++){
+                for (unsigned int p = 0; p < x[k][v][i].size(); p++){
+                    hostVars.add(x[k][v][i][p]);
+                }
+            }
+        }
+    }
+    repairVars.clear();
+    repairVars.add(candidateVars);
+    repairVars.add(hostVars);
+    {
+        std::lock_guard<std::mutex> lock(repair_flag);
+        hasRepair = false;
+    }
+    /* Buffers are allocated here, away from the candidate hot path. */
+    for (unsigned int t = 0; t < candidateBuffers.size(); t++){
+        candidateBuffers[t].end();
+        lowerBuffers[t].end();
+        upperBuffers[t].end();
+        hostBuffers[t].end();
+    }
+    candidateBuffers.assign(nbStats, IloNumArray());
+    lowerBuffers.assign(nbStats, IloNumArray());
+    upperBuffers.assign(nbStats, IloNumArray());
+    hostBuffers.assign(nbStats, IloNumArray());
+    for (int t = 0; t < nbStats; t++){
+        candidateBuffers[t] = IloNumArray(env, candidateVars.getSize());
+        lowerBuffers[t] = IloNumArray(env, candidateVars.getSize());
+        upperBuffers[t] = IloNumArray(env, candidateVars.getSize());
+        hostBuffers[t] = IloNumArray(env, hostVars.getSize());
+    }
+}
+
+/* Checks whether the current fractional solution satisfies all cuts in the pool and adds the most violated ones. */
 bool Callback::checkCutPool(const Context &context)
 {
-    bool found_violated_cut = false;
-    for (IloInt i = 0; i < cutPool.getSize(); ++i) {
-        const IloRange& cut = cutPool[i];
-        IloNum const lhs = context.getRelaxationValue(cut.getExpr());
-        if (lhs < cut.getLB() - EPS || lhs > cut.getUB() + EPS ) {
-            //std::cout << "Adding " << cut.getName() << std::endl;
-            context.addUserCut(cut, IloCplex::UseCutForce, IloFalse);
-            incrementUsercuts();
-            found_violated_cut = true;
-            /* Uncomment next line to add only one violated cut at a time. */
-            // return true;
+    /* Mandatory clauses */
+    if (context.getId() != Context::Id::Relaxation){
+        throw IloCplex::Exception(-1, "ERROR: Trying to access fractional solution while not in relaxation context !");
+    }
+
+    std::lock_guard<std::mutex> lock(pool_flag);
+    const int NB_ROWS = getCutPoolSize();
+    if (NB_ROWS == 0){
+        return false;
+    }
+    /* The relaxation point is fetched once, then every row is evaluated as a sparse product. */
+    IloNumArray point(env);
+    context.getRelaxationPoint(poolVars, point);
+    std::vector<std::pair<double, int> > violated;
+    for (int i = 0; i < NB_ROWS; i++){
+        double lhs = 0.0;
+        for (int e = poolRowStart[i]; e < poolRowStart[i+1]; e++){
+            lhs += poolCoef[e] * point[poolIndex[e]];
+        }
+        const double VIOLATION = std::max(poolLB[i] - lhs, lhs - poolUB[i]);
+        if (VIOLATION > EPSILON){
+            violated.push_back(std::make_pair(VIOLATION, i));
+        }
+    }
+    point.end();
+
+    /* Only the most violated cuts are added. */
+    if ((int)violated.size() > CUT_POOL_MAX_ADDED){
+        std::nth_element(violated.begin(), violated.begin() + CUT_POOL_MAX_ADDED, violated.end(), std::greater<std::pair<double, int> >());
+        violated.resize(CUT_POOL_MAX_ADDED);
+    }
+    for (unsigned int c = 0; c < violated.size(); c++){
+        const int ROW = violated[c].second;
+        IloExpr exp(env);
+        for (int e = poolRowStart[ROW]; e < poolRowStart[ROW+1]; e++){
+            exp += poolCoef[e] * poolVars[poolIndex[e]];
         }
+        IloRange cut(env, poolLB[ROW], exp, poolUB[ROW]);
+        context.addUserCut(cut, IloCplex::UseCutPurge, IloFalse);
+        exp.end();
+        incrementUsercuts(context);
     }
-    return found_violated_cut;
+    return !violated.empty();
 }
 
 /****************************************************************************************/
@@ -90,146 +281,1015 @@ void Callback::addUserCuts(const Context &context)
     if (data.getInput().getSectionFailureCuts() == Input::SECTION_FAILURE_CUTS_ON){
         sectionFailureSeparation(context);
     }
+
+    /* Add availability cover cuts */
+    if (data.getInput().getCoverCuts() == Input::COVER_CUTS_ON){
+        sectionCoverSeparation(context);
+        placementCoverSeparation(context);
+    }
     
 }
 
 /* Solves the separation problem associated with Section Failure inequalities. */
 void Callback::sectionFailureSeparation(const Context &context)
 {
-    try {
-        for (int k = 0; k < data.getNbDemands(); k++){
-            const double REQUIRED_AVAIL      = data.getDemand(k).getAvailability(); 
-            const int    NB_PATHS            = data.getNbPaths(k);
-            const double RHS                 = -std::log(1.0 - REQUIRED_AVAIL);
+    const IloNum4DMatrix xSol = getFractionalSectionSolution(context);
 
-            std::vector<int> selected_sections;
-            selected_sections.resize(NB_PATHS);
+    /* Demands are shared among the separation threads, their cuts being added in demand order. */
+    std::vector<std::vector<PendingCut> > cuts(data.getNbDemands());
+    separationPool->run(data.getNbDemands(), [&](int k){ sectionFailureSeparation(k, xSol, cuts[k]); });
+    for (int k = 0; k < data.getNbDemands(); k++){
+        for (unsigned int c = 0; c < cuts[k].size(); c++){
+            IloRange cut = buildCut(cuts[k][c]);
+            context.addUserCut(cut, IloCplex::UseCutForce, IloFalse);
+            cut.getExpr().end();
+            incrementUsercuts(context);
+        }
+    }
+}
+
+/* Solves the separation problem associated with Section Failure inequalities for a given demand and fractional solution. */
+void Callback::sectionFailureSeparation(const int k, const IloNum4DMatrix& xSol, std::vector<PendingCut>& cuts) const
+{
+    const double REQUIRED_AVAIL      = data.getDemand(k).getAvailability(); 
+    const int    NB_PATHS            = data.getNbPaths(k);
+    const double RHS                 = -std::log(1.0 - REQUIRED_AVAIL);
 
-            double lhs = 0.0;
+    std::vector<int> selected_sections;
+    selected_sections.resize(NB_PATHS);
 
-            for (int p = 0; p < NB_PATHS; p++){
-                lhs += getMostUnavailableSection(context, k, p, selected_sections[p]);
+    double lhs = 0.0;
+
+    for (int p = 0; p < NB_PATHS; p++){
+        lhs += getMostUnavailableSection(xSol, k, p, selected_sections[p]);
+    }
+
+    /* Build inequality: exp >= rhs */
+    if (lhs < RHS - BIG_EPSILON){
+        PendingCut cut;
+        cut.lb = RHS;
+        cut.ub = IloInfinity;
+        for (int p = 0; p < NB_PATHS; p++){
+            for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
+                int v = data.getNodeId(n);
+                int section = selected_sections[p];
+                cut.vars.push_back(x[k][v][section][p]);
+                cut.coefs.push_back(-std::log(1.0 - data.getNode(v).getAvailability()));
             }
+        }
+        cuts.push_back(cut);
+    }
+}
 
-            /* Build inequality */
-            if (lhs < RHS - BIG_EPSILON){
-                IloExpr exp(env);
+/* Solves the separation problem associated with availability cover inequalities on section placement variables. Taking the most unavailable section s_p of each path p, the section failure inequality sum_p sum_v w_v x[k][v][s_p][p] >= W, with w_v = -log(1 - a_v) and W = -log(1 - R), is a multiple-choice knapsack: each active path hosts s_p on a single node. If the heaviest nodes left to the paths once the nodes of C_p are forbidden to each path p weigh less than W, then sum_p sum_{v in C_p} x[k][v][s_p][p] >= 1. Each C_p is made of the most available nodes, so that it forbids as much weight as possible for its x-value. */
+void Callback::sectionCoverSeparation(const Context &context)
+{
+    const IloNum4DMatrix xSol = getFractionalSectionSolution(context);
+    const std::vector<int>& RANK = data.getAvailNodeRank();
+    const int NB_NODES = (int)RANK.size();
+    for (int k = 0; k < data.getNbDemands(); k++){
+        const int    NB_PATHS = data.getNbPaths(k);
+        const double RHS      = -std::log(1.0 - data.getDemand(k).getAvailability());
+        if (NB_PATHS == 0 || data.getDemand(k).getNbVNFs() == 0){
+            continue;
+        }
+
+        /* Option j of path p forbids its j most available nodes, at the cost of their x-values, leaving the (j+1)-th as the heaviest. Options adding no x-value to the next one are dominated. */
+        std::vector<int> sections(NB_PATHS);
+        std::vector<std::vector<double> > optionCost(NB_PATHS);
+        std::vector<std::vector<double> > optionLevel(NB_PATHS);
+        std::vector<std::vector<int> > optionSize(NB_PATHS);
+        for (int p = 0; p < NB_PATHS; p++){
+            getMostUnavailableSection(xSol, k, p, sections[p]);
+            double cost = 0.0;
+            for (int j = 0; j <= NB_NODES; j++){
+                const double NEXT_X = (j < NB_NODES) ? xSol[k][RANK[j]][sections[p]][p] : 0.0;
+                if (j == NB_NODES || NEXT_X > EPSILON){
+                    optionCost[p].push_back(cost);
+                    optionLevel[p].push_back((j < NB_NODES) ? -std::log(1.0 - data.getNode(RANK[j]).getAvailability()) : 0.0);
+                    optionSize[p].push_back(j);
+                }
+                cost += NEXT_X;
+            }
+        }
+
+        /* Cheapest cover: enumerated when there are few option combinations, greedy otherwise. */
+        double nbCombinations = 1.0;
+        for (int p = 0; p < NB_PATHS; p++){
+            nbCombinations *= optionCost[p].size();
+        }
+        std::vector<int> best;
+        double bestCost = 1.0 - EPS;
+        if (nbCombinations <= COVER_EXACT_LIMIT){
+            std::vector<int> current(NB_PATHS, 0);
+            bool done = false;
+            while (!done){
+                double cost = 0.0;
+                double level = 0.0;
+                for (int p = 0; p < NB_PATHS; p++){
+                    cost += optionCost[p][current[p]];
+                    level += optionLevel[p][current[p]];
+                }
+                if (level < RHS - EPSILON && cost < bestCost){
+                    bestCost = cost;
+                    best = current;
+                }
+                done = true;
+                for (int p = 0; p < NB_PATHS && done; p++){
+                    current[p]++;
+                    if (current[p] < (int)optionCost[p].size()){
+                        done = false;
+                    }
+                    else{
+                        current[p] = 0;
+                    }
+                }
+            }
+        }
+        else{
+            /* Forbid nodes where it lowers the heaviest node left the most per unit of x-value, until W is out of reach. */
+            std::vector<int> current(NB_PATHS, 0);
+            double level = 0.0;
+            for (int p = 0; p < NB_PATHS; p++){
+                level += optionLevel[p][0];
+            }
+            while (level >= RHS - EPSILON){
+                int chosen = -1;
+                double bestRatio = 0.0;
                 for (int p = 0; p < NB_PATHS; p++){
-                    for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-                        int v = data.getNodeId(n);
-                        int section = selected_sections[p];
-                        double coeff = -std::log(1.0 - data.getNode(v).getAvailability());
-                        exp += coeff * x[k][v][section][p];
+                    const int NEXT = current[p] + 1;
+                    if (NEXT < (int)optionCost[p].size()){
+                        const double RATIO = (optionLevel[p][current[p]] - optionLevel[p][NEXT]) / (optionCost[p][NEXT] - optionCost[p][current[p]]);
+                        if (chosen < 0 || RATIO > bestRatio){
+                            chosen = p;
+                            bestRatio = RATIO;
+                        }
                     }
                 }
-                
-                /* Add the cut: exp >= rhs */
-                IloRange cut(env, RHS, exp, IloInfinity);
-                context.addUserCut(cut, IloCplex::UseCutForce, IloFalse);
-                //std::cout << "Adding user cut: " << cut << std::endl;
-                exp.end();
-                incrementUsercuts();
+                if (chosen < 0){
+                    break;
+                }
+                level += optionLevel[chosen][current[chosen] + 1] - optionLevel[chosen][current[chosen]];
+                current[chosen]++;
+            }
+            double cost = 0.0;
+            for (int p = 0; p < NB_PATHS; p++){
+                cost += optionCost[p][current[p]];
+            }
+            if (level < RHS - EPSILON && cost < bestCost){
+                best = current;
+            }
+        }
+        if (best.empty()){
+            continue;
+        }
+
+        /* Build inequality */
+        IloExpr exp(env);
+        for (int p = 0; p < NB_PATHS; p++){
+            for (int j = 0; j < optionSize[p][best[p]]; j++){
+                exp += x[k][RANK[j]][sections[p]][p];
             }
         }
+        /* Add the cut: exp >= 1 */
+        IloRange cut(env, 1, exp, IloInfinity);
+        context.addUserCut(cut, IloCplex::UseCutPurge, IloFalse);
+        exp.end();
+        incrementUsercuts(context);
     }
-    catch (...) {
-        throw;
+}
+
+/* Solves the separation problem associated with availability cover inequalities on the node placement variables of single-path demands. The path must then meet the requirement alone: sum_v u_v y[k][v][0] <= U, with u_v = -log(a_v) and U = -log(R), is a knapsack. Any set C of nodes weighing more than U satisfies sum_{v in C} y[k][v][0] <= |C| - 1, which is extended to every node at most as available as the least available node of C. */
+void Callback::placementCoverSeparation(const Context &context)
+{
+    const IloNumArray& point = fetchRelaxationPoint(context);
+    for (int k = 0; k < data.getNbDemands(); k++){
+        const double REQUIRED_AVAIL = data.getDemand(k).getAvailability();
+        if (data.getNbPaths(k) != 1 || REQUIRED_AVAIL <= 0.0){
+            continue;
+        }
+        const double RHS = -std::log(REQUIRED_AVAIL);
+
+        /* Only nodes used fractionally can be part of a violated cover, the others costing 1. */
+        std::vector<int> support;
+        std::vector<double> cost;
+        std::vector<double> weight;
+        for (int v = 0; v < data.getNbNodes(); v++){
+            const double Y = point[getYIndex(k, v, 0)];
+            if (Y > EPSILON){
+                support.push_back(v);
+                cost.push_back(1.0 - Y);
+                weight.push_back(-std::log(data.getNode(v).getAvailability()));
+            }
+        }
+        const int SIZE = (int)support.size();
+
+        /* Cheapest cover: enumerated on small supports, greedy otherwise. */
+        std::vector<bool> best;
+        double bestCost = 1.0 - EPS;
+        if (SIZE > 0 && (1 << std::min(SIZE, 30)) <= COVER_EXACT_LIMIT){
+            for (int subset = 1; subset < (1 << SIZE); subset++){
+                double subsetCost = 0.0;
+                double subsetWeight = 0.0;
+                for (int j = 0; j < SIZE; j++){
+                    if (subset & (1 << j)){
+                        subsetCost += cost[j];
+                        subsetWeight += weight[j];
+                    }
+                }
+                if (subsetWeight > RHS + EPSILON && subsetCost < bestCost){
+                    bestCost = subsetCost;
+                    best.assign(SIZE, false);
+                    for (int j = 0; j < SIZE; j++){
+                        best[j] = ((subset & (1 << j)) != 0);
+                    }
+                }
+            }
+        }
+        else if (SIZE > 0){
+            /* Add nodes by increasing cost per unit of weight until the cover weighs more than U. */
+            std::vector<double> ratio(SIZE);
+            for (int j = 0; j < SIZE; j++){
+                ratio[j] = (weight[j] > 0.0) ? cost[j] / weight[j] : IloInfinity;
+            }
+            std::vector<int> order = getSortedIndexes_Desc(ratio);
+            std::vector<bool> chosen(SIZE, false);
+            double coverCost = 0.0;
+            double coverWeight = 0.0;
+            for (int j = SIZE - 1; j >= 0 && coverWeight <= RHS + EPSILON; j--){
+                chosen[order[j]] = true;
+                coverCost += cost[order[j]];
+                coverWeight += weight[order[j]];
+            }
+            if (coverWeight > RHS + EPSILON && coverCost < bestCost){
+                best = chosen;
+            }
+        }
+        if (best.empty()){
+            continue;
+        }
+
+        /* Build inequality: the cover extended to the nodes not more available than its least available one. */
+        std::vector<bool> extended(data.getNbNodes(), false);
+        double threshold = 1.0;
+        int coverSize = 0;
+        for (int j = 0; j < SIZE; j++){
+            if (best[j]){
+                extended[support[j]] = true;
+                threshold = std::min(threshold, data.getNode(support[j]).getAvailability());
+                coverSize++;
+            }
+        }
+        IloExpr exp(env);
+        for (int v = 0; v < data.getNbNodes(); v++){
+            if (extended[v] || data.getNode(v).getAvailability() <= threshold){
+                exp += y[k][v][0];
+            }
+        }
+        /* Add the cut: exp <= |C| - 1 */
+        IloRange cut(env, -IloInfinity, exp, coverSize - 1);
+        context.addUserCut(cut, IloCplex::UseCutPurge, IloFalse);
+        exp.end();
+        incrementUsercuts(context);
     }
 }
+
+/* Solves the separation problem associated with path support inequalities: if path p of demand k uses every node of S, its availability is at most the product a_S of their availabilities, that is, avail[k][p] <= a_S + (ub - a_S) * (|S| - sum_{v in S} y[k][v][p]). */
+bool Callback::pathSupportSeparation(const Context &context, const IloNumArray* point)
+{
+    const bool CANDIDATE = (context.getId() == Context::Id::Candidate);
+    if (CANDIDATE && point == NULL){
+        throw IloCplex::Exception(-1, "ERROR: Candidate path support separation without candidate buffer !");
+    }
+    /* The bound of the availability variables, so that cuts stay valid on paths not using S. */
+    const double AVAIL_UB = 1.0;
+    bool rejected = false;
+    for (int k = 0; k < data.getNbDemands(); k++){
+        const int NB_VNFS = data.getDemand(k).getNbVNFs();
+        for (int p = 0; p < data.getNbPaths(k); p++){
+            const double AVAIL = CANDIDATE ? context.getCandidatePoint(avail[k][p]) : context.getRelaxationPoint(avail[k][p]);
+            if (AVAIL <= EPS){
+                continue;
+            }
+            std::vector<double> ySol(data.getNbNodes(), 0.0);
+            for (int v = 0; v < data.getNbNodes(); v++){
+                ySol[v] = CANDIDATE ? (*point)[getYIndex(k, v, p)] : context.getRelaxationPoint(y[k][v][p]);
+            }
+
+            /* The most violated support among the prefixes of the nodes sorted by y-value. */
+            std::vector<int> order = getSortedIndexes_Desc(ySol);
+            double product = 1.0;
+            double slack = 0.0;
+            double bestViolation = SUPPORT_EPS;
+            int bestSize = 0;
+            for (int j = 0; j < NB_VNFS && j < (int)order.size() && ySol[order[j]] > EPS; j++){
+                product *= data.getNode(order[j]).getAvailability();
+                slack += 1.0 - ySol[order[j]];
+                double violation = AVAIL - (product + (AVAIL_UB - product) * slack);
+                if (violation > bestViolation){
+                    bestViolation = violation;
+                    bestSize = j + 1;
+                }
+            }
+            if (bestSize == 0){
+                continue;
+            }
+
+            /* Build inequality */
+            product = 1.0;
+            for (int j = 0; j < bestSize; j++){
+                product *= data.getNode(order[j]).getAvailability();
+            }
+            IloExpr exp(env);
+            exp += avail[k][p];
+            for (int j = 0; j < bestSize; j++){
+                exp += (AVAIL_UB - product) * y[k][order[j]][p];
+            }
+            /* Add the cut: exp <= rhs */
+            IloRange cut(env, -IloInfinity, exp, product + (AVAIL_UB - product) * bestSize);
+            if (CANDIDATE){
+                context.rejectCandidate(cut);
+                incrementLazyConstraints(context);
+                rejected = true;
+            }
+            else{
+                context.addUserCut(cut, IloCplex::UseCutPurge, IloFalse);
+                addToCutPool(cut);
+                incrementUsercuts(context);
+            }
+            exp.end();
+        }
+    }
+    return rejected;
+}
+
 /****************************************************************************************/
 /*									LAZY CONSTRAINTS        							*/
 /****************************************************************************************/
 /* Separation routine applied on integer solutions */
-void Callback::addLazyConstraints(const Context &context)
+bool Callback::addLazyConstraints(const Context &context, const IloNumArray& point)
 {
-    try {
-        /* Get current integer solution */
-        IloNum3DMatrix ySol = getIntegerSolution(context); 
-        /* Check VNF placement availability for each demand */
-        for (int k = 0; k < data.getNbDemands(); k++){
-            const double REQUIRED_AVAIL      = data.getDemand(k).getAvailability(); 
-            const int    NB_PATHS            = data.getNbPaths(k);
-            const int    LAST_ACTIVATED_PATH = getLastPathIndex(context, k);
-            const double PLACEMENT_AVAIL     = getPlacementAvailability(context, k);
-            
-            /* If placement availability is not enough, add lazy constraint. */
-            if (PLACEMENT_AVAIL < REQUIRED_AVAIL){
-                /* Build inequality. */
-                IloExpr exp(env);
-                int rhs = 1;
-                for (int p = 0; p < NB_PATHS; p++){
-                    if (context.getCandidatePoint(alpha[k][p]) > 1 - EPS){
-                        for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-                            int v = data.getNodeId(n);
-                            if (ySol[k][v][p] > 1 - EPS){
-                                exp -= y[k][v][p];
-                                rhs--;
-                            }
+    /* Check VNF placement availability for each demand, demands being shared among the separation threads. */
+    std::vector<std::vector<PendingCut> > cuts(data.getNbDemands());
+    separationPool->run(data.getNbDemands(), [&](int k){ availabilityNoGoodSeparation(k, point, cuts[k]); });
+
+    /* Cuts are added in demand order, whatever the order they were found in. */
+    std::vector<int> failing;
+    for (int k = 0; k < data.getNbDemands(); k++){
+        for (unsigned int c = 0; c < cuts[k].size(); c++){
+            IloRange cut = buildCut(cuts[k][c]);
+            context.rejectCandidate(cut);
+            cut.getExpr().end();
+            incrementLazyConstraints(context);
+        }
+        if (!cuts[k].empty()){
+            failing.push_back(k);
+        }
+    }
+
+    /* A rejected candidate is usually close to feasible. */
+    if (!failing.empty() && !candidateOnly && data.getInput().getRepairHeuristic() == Input::REPAIR_HEURISTIC_ON){
+        repairCandidate(context, point, failing);
+    }
+    return !failing.empty();
+}
+
+/* Solves the separation problem associated with availability no-good inequalities for a given demand and integer solution. */
+void Callback::availabilityNoGoodSeparation(const int k, const IloNumArray& point, std::vector<PendingCut>& cuts) const
+{
+    const double REQUIRED_AVAIL      = data.getDemand(k).getAvailability(); 
+    const int    NB_PATHS            = data.getNbPaths(k);
+    const int    LAST_ACTIVATED_PATH = getLastPathIndex(point, k);
+
+    /* A placement already checked is answered by the stored verdict. */
+    const PlacementKey KEY = getPlacementKey(k, point);
+    if (findPlacementVerdict(KEY, cuts)){
+        return;
+    }
+
+    /* If placement availability is enough, there is nothing to separate. */
+    if (getPlacementAvailability(point, k) >= REQUIRED_AVAIL){
+        storePlacementVerdict(KEY, std::vector<PendingCut>());
+        return;
+    }
+    /* The nodes used by each active path. */
+    std::vector<bool> active(NB_PATHS, false);
+    std::vector<std::vector<int> > support(NB_PATHS);
+    std::vector<std::pair<double, std::pair<int, int> > > used;
+    for (int p = 0; p < NB_PATHS; p++){
+        if (point[getAlphaIndex(k, p)] > 1 - EPS){
+            active[p] = true;
+            for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
+                int v = data.getNodeId(n);
+                if (point[getYIndex(k, v, p)] > 1 - EPS){
+                    support[p].push_back(v);
+                    used.push_back(std::make_pair(data.getNode(v).getAvailability(), std::make_pair(p, v)));
+                }
+            }
+        }
+    }
+
+    /* Minimal support: the most available nodes are dropped as long as the others alone miss the requirement. */
+    std::sort(used.begin(), used.end(), std::greater<std::pair<double, std::pair<int, int> > >());
+    for (unsigned int j = 0; j < used.size(); j++){
+        const int p = used[j].second.first;
+        const int v = used[j].second.second;
+        std::vector<int>::iterator it = std::find(support[p].begin(), support[p].end(), v);
+        support[p].erase(it);
+        if (getSupportAvailabilityBound(support, active) >= REQUIRED_AVAIL){
+            support[p].push_back(v);
+        }
+    }
+
+    /* Lifting: each node of the support may be replaced by any node that is not more available. */
+    std::vector<std::vector<int> > substitutes(NB_PATHS);
+    for (int p = 0; p < NB_PATHS; p++){
+        double threshold = -1.0;
+        for (unsigned int j = 0; j < support[p].size(); j++){
+            threshold = std::max(threshold, data.getNode(support[p][j]).getAvailability());
+        }
+        for (int v = 0; v < data.getNbNodes(); v++){
+            if (data.getNode(v).getAvailability() <= threshold){
+                substitutes[p].push_back(v);
+            }
+        }
+    }
+    int size = 0;
+    for (int p = 0; p < NB_PATHS; p++){
+        size += (int)support[p].size();
+    }
+    const std::vector<std::vector<int> >& LHS_NODES = (getSupportAvailabilityBound(substitutes, active, size) < REQUIRED_AVAIL) ? substitutes : support;
+
+    /* Build inequality: -sum y + alpha >= rhs. */
+    PendingCut cut;
+    cut.lb = 1 - size;
+    cut.ub = IloInfinity;
+    for (int p = 0; p < NB_PATHS; p++){
+        for (unsigned int j = 0; j < LHS_NODES[p].size(); j++){
+            cut.vars.push_back(y[k][LHS_NODES[p][j]][p]);
+            cut.coefs.push_back(-1.0);
+        }
+    }
+    if (LAST_ACTIVATED_PATH < NB_PATHS - 1){
+        cut.vars.push_back(alpha[k][LAST_ACTIVATED_PATH+1]);
+        cut.coefs.push_back(1.0);
+    }
+    cuts.push_back(cut);
+    storePlacementVerdict(KEY, std::vector<PendingCut>(1, cut));
+}
+
+/****************************************************************************************/
+/*									ROUTING CUTS        								*/
+/****************************************************************************************/
+/* Solves the routing subproblems for a given candidate placement and rejects it if some path cannot be routed. */
+bool Callback::addRoutingCuts(const Context &context, const IloNumArray& point)
+{
+    /* Mandatory clauses */
+    if (context.getId() != Context::Id::Candidate){
+        throw IloCplex::Exception(-1, "ERROR: Trying to access integer solution while not in candidate context !");
+    }
+
+    /* Get the hosts of each active path, the section placement being fetched at once. */
+    const int FIRST_HOST = (int)candidateVars.getSize();
+    const IloNumArray& hostPoint = fetchCandidateHosts(context);
+    std::vector<std::vector<PathPlacement> > placement(data.getNbDemands());
+    for (int k = 0; k < data.getNbDemands(); k++){
+        const int NB_VNFS = data.getDemand(k).getNbVNFs();
+        for (int p = 0; p < data.getNbPaths(k); p++){
+            if (point[getAlphaIndex(k, p)] > 1 - EPS){
+                PathPlacement path;
+                path.p = p;
+                path.hosts.resize(NB_VNFS, -1);
+                for (int v = 0; v < data.getNbNodes(); v++){
+                    for (int i = 0; i < NB_VNFS; i++){
+                        if (hostPoint[getXIndex(k, v, i, p) - FIRST_HOST] > 1 - EPS){
+                            path.hosts[i] = v;
                         }
                     }
                 }
-                if (LAST_ACTIVATED_PATH < NB_PATHS - 1){
-                    exp += alpha[k][LAST_ACTIVATED_PATH+1];
-                }
-                
-                /* Add the cut: exp >= rhs */
-                IloRange cut(env, rhs, exp, IloInfinity);
-                context.rejectCandidate(cut);
-                //std::cout << "Adding lazy constraint: " << cut << std::endl;
-                exp.end();
-                incrementLazyConstraints();
+                placement[k].push_back(path);
+            }
+        }
+    }
+
+    /* Latency: the hosts of a violated window cannot be used together on any path. */
+    std::vector<LatencyCut> latencyCuts;
+    routing->separateLatency(placement, latencyCuts, *separationPool);
+    for (unsigned int c = 0; c < latencyCuts.size(); c++){
+        const LatencyCut& violation = latencyCuts[c];
+        std::vector<int> hosts;
+        for (unsigned int j = 0; j < placement[violation.k].size(); j++){
+            if (placement[violation.k][j].p == violation.p){
+                hosts = placement[violation.k][j].hosts;
             }
         }
+        for (int p = 0; p < data.getNbPaths(violation.k); p++){
+            IloExpr exp(env);
+            int rhs = -1;
+            if (violation.first > violation.last){
+                exp += alpha[violation.k][p];
+                rhs = 0;
+            }
+            for (int i = violation.first; i <= violation.last; i++){
+                exp += x[violation.k][hosts[i]][i][p];
+                rhs++;
+            }
+            /* Add the cut: exp <= rhs */
+            IloRange cut(env, -IloInfinity, exp, rhs);
+            context.rejectCandidate(cut);
+            exp.end();
+            incrementLazyConstraints(context);
+        }
+    }
+    if (!latencyCuts.empty()){
+        return true;
     }
-    catch (...) {
-        throw;
+
+    /* Arc capacity: demands are only coupled when their shortest routes overload an arc. Only a proven unroutable placement is cut off. */
+    if (routing->isArcCapacityRespected(placement) || !routing->isJointRoutingInfeasible(placement)){
+        return false;
+    }
+    IloExpr exp(env);
+    int rhs = -1;
+    for (int k = 0; k < data.getNbDemands(); k++){
+        for (unsigned int j = 0; j < placement[k].size(); j++){
+            for (unsigned int i = 0; i < placement[k][j].hosts.size(); i++){
+                exp += x[k][placement[k][j].hosts[i]][i][placement[k][j].p];
+                rhs++;
+            }
+        }
     }
+    /* Add the cut: exp <= rhs */
+    IloRange cut(env, -IloInfinity, exp, rhs);
+    context.rejectCandidate(cut);
+    exp.end();
+    incrementLazyConstraints(context);
+    return true;
 }
 
 /****************************************************************************************/
-/*									QUERY METHODS        								*/
+/*									HEURISTIC SOLUTIONS        							*/
 /****************************************************************************************/
-/* Returns the last activated path index within a candidate solution. */
-const int Callback::getLastPathIndex(const Context &context, const int k) const
+/* Publishes an accepted candidate solution to the solution pool if it improves the incumbent. */
+void Callback::publishIncumbent(const Context &context)
 {
     /* Mandatory clauses */
     if (context.getId() != Context::Id::Candidate){
         throw IloCplex::Exception(-1, "ERROR: Trying to access integer solution while not in candidate context !");
     }
-    if (!context.isCandidatePoint()) {
-        throw IloCplex::Exception(-1, "ERROR: Unbounded solution within callback !");
+
+    const IloNum CANDIDATE_OBJ = context.getCandidateObjective();
+    if (CANDIDATE_OBJ >= context.getIncumbentObjective() - EPS){
+        return;
+    }
+    IloNumArray vals(env);
+    context.getCandidatePoint(solutionVars, vals);
+    std::vector<double> values(vals.getSize());
+    for (IloInt j = 0; j < vals.getSize(); j++){
+        values[j] = vals[j];
     }
+    vals.end();
+    solutionPool->offerIncumbent(values, CANDIDATE_OBJ);
+}
 
-    /* Compute last activated path index */
-    int last = 0;
-    for (unsigned int p = 0; p < alpha[k].size(); p++){
-        if (context.getCandidatePoint(alpha[k][p]) > 1 - EPS){
-            last = p;
+/* Posts the pending improvement of the solution pool, if any, to CPLEX. */
+void Callback::postHeuristicSolutions(const Context &context)
+{
+    /* Mandatory clauses */
+    if (context.getId() != Context::Id::Relaxation){
+        throw IloCplex::Exception(-1, "ERROR: Trying to post heuristic solution while not in relaxation context !");
+    }
+
+    std::vector<double> values;
+    double obj = 0.0;
+    if (!solutionPool->popImprovement(values, obj) || obj >= context.getIncumbentObjective() - EPS){
+        return;
+    }
+    IloNumArray vals(env, (IloInt)values.size());
+    for (unsigned int j = 0; j < values.size(); j++){
+        vals[j] = values[j];
+    }
+    /* CPLEX fixes the integer values and recomputes the continuous ones. */
+    context.postHeuristicSolution(solutionVars, vals, obj, Context::SolutionStrategy::Solve);
+    vals.end();
+    incrementPostedSolutions(context);
+}
+
+/* Propagates the availability requirements on the local bounds. The availability of path p is at most b_p, the product of the availabilities of the nodes fixed on it, or the availability of the most available node it may still use if none is fixed. The demand then meets R = 1 - U only if the product of the 1 - b_p over its active paths is at most U. */
+bool Callback::propagateAvailability(const Context &context)
+{
+    /* Mandatory clauses */
+    if (context.getId() != Context::Id::Relaxation){
+        throw IloCplex::Exception(-1, "ERROR: Trying to propagate local bounds while not in relaxation context !");
+    }
+
+    const int THREAD = getThreadIndex(context);
+    IloNumArray& lb = lowerBuffers[THREAD];
+    IloNumArray& ub = upperBuffers[THREAD];
+    context.getLocalLB(candidateVars, lb);
+    context.getLocalUB(candidateVars, ub);
+    const IloNumArray& point = fetchRelaxationPoint(context);
+
+    std::vector<IloRange> bounds;
+    for (int k = 0; k < data.getNbDemands(); k++){
+        const int    NB_PATHS       = data.getNbPaths(k);
+        const double REQUIRED_AVAIL = data.getDemand(k).getAvailability();
+        if (data.isDemandRemoved(k) || data.getDemand(k).getNbVNFs() == 0){
+            continue;
+        }
+
+        /* best[p] bounds the availability of path p, 0 if it cannot be active. */
+        std::vector<double> best(NB_PATHS, 0.0);
+        std::vector<double> fixedAvail(NB_PATHS, 1.0);
+        std::vector<int> open;
+        for (int p = 0; p < NB_PATHS; p++){
+            if (ub[getAlphaIndex(k, p)] < 0.5){
+                continue;
+            }
+            bool fixed = false;
+            double maxAvail = 0.0;
+            for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
+                int v = data.getNodeId(n);
+                const double NODE_AVAIL = data.getNode(v).getAvailability();
+                if (lb[getYIndex(k, v, p)] > 0.5){
+                    fixedAvail[p] *= NODE_AVAIL;
+                    fixed = true;
+                }
+                else if (ub[getYIndex(k, v, p)] > 0.5){
+                    maxAvail = std::max(maxAvail, NODE_AVAIL);
+                }
+            }
+            best[p] = fixed ? fixedAvail[p] : maxAvail;
+            if (best[p] > 0.0){
+                open.push_back(p);
+            }
+        }
+
+        /* The fewest paths meeting the requirement are the most available ones. */
+        std::vector<double> unavail(open.size());
+        for (unsigned int j = 0; j < open.size(); j++){
+            unavail[j] = 1.0 - best[open[j]];
+        }
+        std::sort(unavail.begin(), unavail.end());
+        double fail = 1.0;
+        int minNbPaths = 0;
+        while (minNbPaths < (int)unavail.size() && 1.0 - fail < REQUIRED_AVAIL - EPSILON){
+            fail *= unavail[minNbPaths];
+            minNbPaths++;
+        }
+        if (1.0 - fail < REQUIRED_AVAIL - EPSILON){
+            for (unsigned int j = 0; j < bounds.size(); j++){
+                bounds[j].getExpr().end();
+                bounds[j].end();
+            }
+            context.pruneCurrentNode();
+            incrementPrunedNodes(context);
+            return true;
+        }
+
+        /* Number of active paths. */
+        double count = 0.0;
+        for (int p = 0; p < NB_PATHS; p++){
+            count += point[getAlphaIndex(k, p)];
+        }
+        if (count < minNbPaths - EPS){
+            IloExpr exp(env);
+            for (int p = 0; p < NB_PATHS; p++){
+                exp += alpha[k][p];
+            }
+            bounds.push_back(IloRange(env, minNbPaths, exp, IloInfinity));
+        }
+
+        /* Without path p, the other open paths at their best must still reach the requirement. */
+        for (unsigned int j = 0; j < open.size(); j++){
+            const int p = open[j];
+            double othersFail = 1.0;
+            for (unsigned int l = 0; l < open.size(); l++){
+                if (l != j){
+                    othersFail *= (1.0 - best[open[l]]);
+                }
+            }
+            if (1.0 - othersFail < REQUIRED_AVAIL - EPSILON && point[getAlphaIndex(k, p)] < 1 - EPS){
+                IloExpr exp(env);
+                exp += alpha[k][p];
+                bounds.push_back(IloRange(env, 1.0, exp, IloInfinity));
+            }
+
+            /* A node whose availability takes path p too low for the requirement cannot be used by it. */
+            for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
+                int v = data.getNodeId(n);
+                if (lb[getYIndex(k, v, p)] > 0.5 || ub[getYIndex(k, v, p)] < 0.5 || point[getYIndex(k, v, p)] <= EPS){
+                    continue;
+                }
+                const double PATH_AVAIL = fixedAvail[p] * data.getNode(v).getAvailability();
+                if (1.0 - othersFail * (1.0 - PATH_AVAIL) < REQUIRED_AVAIL - EPSILON){
+                    IloExpr exp(env);
+                    exp += y[k][v][p];
+                    bounds.push_back(IloRange(env, -IloInfinity, exp, 0.0));
+                }
+            }
         }
     }
-    return last;
+
+    /* Local cuts only hold within the subtree of the current node. */
+    for (unsigned int j = 0; j < bounds.size(); j++){
+        context.addUserCut(bounds[j], IloCplex::UseCutPurge, IloTrue);
+        bounds[j].getExpr().end();
+        bounds[j].end();
+        incrementLocalBounds(context);
+    }
+    return false;
 }
 
-/* Returns the SFC availability induced by a candidate solution. */
-const double Callback::getPlacementAvailability(const Context &context, const int k) const
+/* Branches on the number of active paths of a demand, or else on a placement on the least available node. */
+bool Callback::makeStructuredBranch(const Context &context)
+{
+    /* Mandatory clauses */
+    if (context.getId() != Context::Id::Branching){
+        throw IloCplex::Exception(-1, "ERROR: Trying to branch while not in branching context !");
+    }
+
+    const IloNumArray& point = fetchRelaxationPoint(context);
+    const IloNum ESTIMATE = context.getRelaxationObjective();
+
+    /* The number of active paths decides most of the availability: the demand whose count is the most fractional comes first. */
+    int bestDemand = -1;
+    double bestCount = 0.0;
+    double bestFraction = EPS;
+    for (int k = 0; k < data.getNbDemands(); k++){
+        if (data.isDemandRemoved(k)){
+            continue;
+        }
+        double count = 0.0;
+        for (int p = 0; p < data.getNbPaths(k); p++){
+            count += point[getAlphaIndex(k, p)];
+        }
+        const double FRACTION = std::min(count - std::floor(count), std::ceil(count) - count);
+        if (FRACTION > bestFraction){
+            bestDemand = k;
+            bestCount = count;
+            bestFraction = FRACTION;
+        }
+    }
+    if (bestDemand >= 0){
+        IloExpr exp(env);
+        for (int p = 0; p < data.getNbPaths(bestDemand); p++){
+            exp += alpha[bestDemand][p];
+        }
+        IloRange down(env, -IloInfinity, exp, std::floor(bestCount));
+        IloRange up(env, std::ceil(bestCount), exp, IloInfinity);
+        context.makeBranch(down, ESTIMATE);
+        context.makeBranch(up, ESTIMATE);
+        down.end();
+        up.end();
+        exp.end();
+        incrementBranches(context);
+        return true;
+    }
+
+    /* Then the placement on the least available node used fractionally, where a section hurts availability the most. */
+    const std::vector<int>& rank = data.getAvailNodeRank();
+    for (int r = (int)rank.size() - 1; r >= 0; r--){
+        const int v = rank[r];
+        int bestK = -1;
+        int bestP = -1;
+        bestFraction = EPS;
+        for (int k = 0; k < data.getNbDemands(); k++){
+            if (data.isDemandRemoved(k)){
+                continue;
+            }
+            for (int p = 0; p < data.getNbPaths(k); p++){
+                const double VALUE = point[getYIndex(k, v, p)];
+                const double FRACTION = std::min(VALUE, 1.0 - VALUE);
+                if (FRACTION > bestFraction){
+                    bestK = k;
+                    bestP = p;
+                    bestFraction = FRACTION;
+                }
+            }
+        }
+        if (bestK >= 0){
+            context.makeBranch(y[bestK][v][bestP], 0.0, IloCplex::BranchDown, ESTIMATE);
+            context.makeBranch(y[bestK][v][bestP], 1.0, IloCplex::BranchUp, ESTIMATE);
+            incrementBranches(context);
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Repairs a candidate rejected for the availability of some demands and keeps the result to be posted if it improves the incumbent. */
+void Callback::repairCandidate(const Context &context, const IloNumArray& point, const std::vector<int>& failing)
 {
     /* Mandatory clauses */
     if (context.getId() != Context::Id::Candidate){
         throw IloCplex::Exception(-1, "ERROR: Trying to access integer solution while not in candidate context !");
     }
-    if (!context.isCandidatePoint()) {
-        throw IloCplex::Exception(-1, "ERROR: Unbounded solution within callback !");
+
+    /* The hosts of each active path, only the section placement variables being fetched as the others are already in the buffer. */
+    const int FIRST_HOST = (int)candidateVars.getSize();
+    const IloNumArray& vals = fetchCandidateHosts(context);
+    std::vector<std::vector<ChainPath> > chains(data.getNbDemands());
+    for (int k = 0; k < data.getNbDemands(); k++){
+        const int NB_VNFS = data.getDemand(k).getNbVNFs();
+        for (int p = 0; p < data.getNbPaths(k); p++){
+            if (point[getAlphaIndex(k, p)] > 1 - EPS){
+                ChainPath path;
+                path.hosts.assign(NB_VNFS, -1);
+                for (int v = 0; v < data.getNbNodes(); v++){
+                    for (int i = 0; i < NB_VNFS; i++){
+                        if (vals[getXIndex(k, v, i, p) - FIRST_HOST] > 1 - EPS){
+                            path.hosts[i] = v;
+                        }
+                    }
+                }
+                /* A VNF left unplaced cannot be repaired. */
+                if (std::find(path.hosts.begin(), path.hosts.end(), -1) != path.hosts.end()){
+                    return;
+                }
+                chains[k].push_back(path);
+            }
+        }
     }
 
-    /* Compute placement availability */
+    /* Demands meeting their requirement keep their hosts and are rerouted first, so that repairs only use the capacity left. */
+    std::vector<bool> isFailing(data.getNbDemands(), false);
+    for (unsigned int j = 0; j < failing.size(); j++){
+        isFailing[failing[j]] = true;
+    }
+    Constructive heuristic(data);
+    for (int k = 0; k < data.getNbDemands(); k++){
+        if (isFailing[k] || chains[k].empty()){
+            continue;
+        }
+        if (!heuristic.reserveDemand(k, chains[k])){
+            return;
+        }
+    }
+    for (unsigned int j = 0; j < failing.size(); j++){
+        if (!heuristic.repairDemand(failing[j], chains[failing[j]])){
+            return;
+        }
+    }
+    const double COST = heuristic.getCost();
+    if (COST >= context.getIncumbentObjective() - EPS){
+        return;
+    }
+
+    /* Only placement variables are set, CPLEX completing the routing and the availability variables. */
+    std::vector<double> values(repairVars.getSize(), 0.0);
+    for (int k = 0; k < data.getNbDemands(); k++){
+        const std::vector<ChainPath>& paths = heuristic.getPaths(k);
+        for (unsigned int p = 0; p < paths.size(); p++){
+            values[getAlphaIndex(k, p)] = 1.0;
+            for (unsigned int i = 0; i < paths[p].hosts.size(); i++){
+                values[getXIndex(k, paths[p].hosts[i], i, p)] = 1.0;
+                values[getYIndex(k, paths[p].hosts[i], p)] = 1.0;
+            }
+        }
+    }
+    std::lock_guard<std::mutex> lock(repair_flag);
+    if (!hasRepair || COST < repairObj){
+        repairValues = values;
+        repairObj = COST;
+        hasRepair = true;
+    }
+}
+
+/* Posts the pending repaired solution, if any, to CPLEX. */
+void Callback::postRepairedSolution(const Context &context)
+{
+    /* Mandatory clauses */
+    if (context.getId() != Context::Id::Relaxation){
+        throw IloCplex::Exception(-1, "ERROR: Trying to post heuristic solution while not in relaxation context !");
+    }
+
+    std::vector<double> values;
+    double obj = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(repair_flag);
+        if (!hasRepair){
+            return;
+        }
+        values.swap(repairValues);
+        obj = repairObj;
+        hasRepair = false;
+    }
+    if (obj >= context.getIncumbentObjective() - EPS){
+        return;
+    }
+    IloNumArray vals(env, (IloInt)values.size());
+    for (unsigned int j = 0; j < values.size(); j++){
+        vals[j] = values[j];
+    }
+    /* CPLEX fixes the placement and solves for the routing and availability variables. */
+    context.postHeuristicSolution(repairVars, vals, obj, Context::SolutionStrategy::Solve);
+    vals.end();
+    incrementPostedSolutions(context);
+}
+
+/****************************************************************************************/
+/*									QUERY METHODS        								*/
+/****************************************************************************************/
+/* Returns true if candidate solutions must be checked against the exact availability constraints. */
+const bool Callback::isAvailabilityLazyRequired() const
+{
+    return (availabilityCheck && (data.getInput().getApproximationType() == Input::APPROXIMATION_TYPE_RELAXATION || data.getInput().isBasic()));
+}
+
+/* Returns an upper bound on the availability of a demand whose active paths use, all together, at least size of their substitute nodes, the active paths without substitutes being free. */
+const double Callback::getSupportAvailabilityBound(const std::vector<std::vector<int> >& substitutes, const std::vector<bool>& active, int size) const
+{
+    if (size < 0){
+        size = 0;
+        for (unsigned int p = 0; p < substitutes.size(); p++){
+            size += (int)substitutes[p].size();
+        }
+    }
+    /* A path uses at least one node, at best the most available one. */
+    const double MAX_NODE_AVAIL = data.getNode(data.getAvailNodeRank().front()).getAvailability();
+    const double FREE_LOG_UNAVAIL = std::log(1.0 - MAX_NODE_AVAIL);
+
+    /* least[c] is the least log-unavailability of the paths seen so far, using c substitutes all together. */
+    std::vector<double> least(size + 1, IloInfinity);
+    least[0] = 0.0;
+    for (unsigned int p = 0; p < substitutes.size(); p++){
+        if (!active[p]){
+            continue;
+        }
+        /* A path using c substitutes is at best as available as the c most available ones. */
+        std::vector<double> avails;
+        for (unsigned int j = 0; j < substitutes[p].size(); j++){
+            avails.push_back(data.getNode(substitutes[p][j]).getAvailability());
+        }
+        std::sort(avails.begin(), avails.end(), std::greater<double>());
+        std::vector<double> next(size + 1, IloInfinity);
+        double product = 1.0;
+        for (int c = 0; c <= size && c <= (int)avails.size(); c++){
+            if (c > 0){
+                product *= avails[c-1];
+            }
+            const double LOG_UNAVAIL = (c == 0) ? FREE_LOG_UNAVAIL : std::log(1.0 - product);
+            for (int previous = 0; previous + c <= size; previous++){
+                if (least[previous] < IloInfinity){
+                    next[previous + c] = std::min(next[previous + c], least[previous] + LOG_UNAVAIL);
+                }
+            }
+        }
+        least = next;
+    }
+    /* Using more substitutes only lowers the availability. */
+    if (least[size] >= IloInfinity){
+        return 0.0;
+    }
+    return 1.0 - std::exp(least[size]);
+}
+
+/* Returns the contexts under which the callback must be invoked, 0 if none. */
+const CPXLONG Callback::getContextMask() const
+{
+    CPXLONG mask = 0;
+    /* Repaired candidates are posted from the relaxation context. */
+    const bool REPAIR = (isAvailabilityLazyRequired() && data.getInput().getRepairHeuristic() == Input::REPAIR_HEURISTIC_ON);
+    if (isLazyRequired() || solutionPool != NULL){
+        mask |= IloCplex::Callback::Context::Id::Candidate;
+    }
+    if (candidateOnly){
+        return mask;
+    }
+    const bool PROPAGATION = (data.getInput().getPropagation() == Input::PROPAGATION_ON);
+    if (data.getInput().isAvailabilityCutsOn() || data.getInput().getCoverCuts() == Input::COVER_CUTS_ON || solutionPool != NULL || REPAIR || PROPAGATION){
+        mask |= IloCplex::Callback::Context::Id::Relaxation;
+    }
+    if (data.getInput().getBranchingCallback() == Input::BRANCHING_CALLBACK_ON){
+        mask |= IloCplex::Callback::Context::Id::Branching;
+    }
+    return mask;
+}
+
+/* Returns the last activated path index of a demand within a candidate solution. */
+const int Callback::getLastPathIndex(const IloNumArray& point, const int k) const
+{
+    int last = 0;
+    for (int p = 0; p < data.getNbPaths(k); p++){
+        if (point[getAlphaIndex(k, p)] > 1 - EPS){
+            last = p;
+        }
+    }
+    return last;
+}
+
+/* Returns the SFC availability induced by a candidate solution. */
+const double Callback::getPlacementAvailability(const IloNumArray& point, const int k) const
+{
     double prob_all_paths_fail = 1.0;
-    for (unsigned int p = 0; p < alpha[k].size(); p++){
+    for (int p = 0; p < data.getNbPaths(k); p++){
         double path_failure = 1.0;
-        if (context.getCandidatePoint(alpha[k][p]) > 1 - EPS){
+        if (point[getAlphaIndex(k, p)] > 1 - EPS){
             double path_availability = 1.0;
             for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
                 int v = data.getNodeId(n);
-                if (context.getCandidatePoint(y[k][v][p]) > 1 - EPS){
+                if (point[getYIndex(k, v, p)] > 1 - EPS){
                     path_availability *= data.getNode(v).getAvailability();
                 }
             }
@@ -242,13 +1302,8 @@ const double Callback::getPlacementAvailability(const Context &context, const in
 
 
 /* Returns the most unavailable section of a path in the form -log(unavailability) given a fractional solution. */
-const double Callback::getMostUnavailableSection(const Context &context, const int k, const int p, int &section) const
+const double Callback::getMostUnavailableSection(const IloNum4DMatrix& xSol, const int k, const int p, int &section) const
 {
-    /* Mandatory clauses */
-    if (context.getId() != Context::Id::Relaxation){
-        throw IloCplex::Exception(-1, "ERROR: Trying to access fractional solution while not in relaxation context !");
-    }
-
     const int NB_VNFS = data.getDemand(k).getNbVNFs();
     double result = IloInfinity;
     for (int i = 0; i < NB_VNFS; i++){
@@ -256,7 +1311,7 @@ const double Callback::getMostUnavailableSection(const Context &context, const i
         for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
             int v = data.getNodeId(n);
             double coeff = -std::log(1.0 - data.getNode(v).getAvailability());
-            lhs += (coeff * context.getRelaxationValue(x[k][v][i][p]));
+            lhs += (coeff * xSol[k][v][i][p]);
         }
         if (lhs < result){
             result = lhs;
@@ -267,10 +1322,102 @@ const double Callback::getMostUnavailableSection(const Context &context, const i
     return result;
 }
 
+/* Returns the key of the placement of a demand within a candidate solution. */
+PlacementKey Callback::getPlacementKey(const int k, const IloNumArray& point) const
+{
+    const int NB_PATHS = data.getNbPaths(k);
+    const int NB_NODES = data.getNbNodes();
+    PlacementKey key;
+    key.k = k;
+    key.bits.assign((NB_PATHS * (NB_NODES + 1) + 63) / 64, 0);
+    for (int p = 0; p < NB_PATHS; p++){
+        if (point[getAlphaIndex(k, p)] > 1 - EPS){
+            key.bits[p / 64] |= (uint64_t)1 << (p % 64);
+            for (int v = 0; v < NB_NODES; v++){
+                if (point[getYIndex(k, v, p)] > 1 - EPS){
+                    const int BIT = NB_PATHS + p * NB_NODES + v;
+                    key.bits[BIT / 64] |= (uint64_t)1 << (BIT % 64);
+                }
+            }
+        }
+    }
+    return key;
+}
+
+/* Appends the cuts rejecting a placement already checked. Returns false if it was never checked. */
+bool Callback::findPlacementVerdict(const PlacementKey& key, std::vector<PendingCut>& cuts) const
+{
+    const int SHARD = (int)(PlacementKeyHash()(key) % MEMO_SHARDS);
+    std::lock_guard<std::mutex> lock(memo_flag[SHARD]);
+    PlacementMemo::const_iterator it = memo[SHARD].find(key);
+    if (it == memo[SHARD].end()){
+        return false;
+    }
+    cuts.insert(cuts.end(), it->second.begin(), it->second.end());
+    return true;
+}
+
+/* Stores the cuts rejecting a placement, none if it meets the requirement. */
+void Callback::storePlacementVerdict(const PlacementKey& key, const std::vector<PendingCut>& cuts) const
+{
+    const int SHARD = (int)(PlacementKeyHash()(key) % MEMO_SHARDS);
+    std::lock_guard<std::mutex> lock(memo_flag[SHARD]);
+    /* A full shard starts over rather than growing without bound. */
+    if (memo[SHARD].size() >= MEMO_SHARD_CAPACITY){
+        memo[SHARD].clear();
+    }
+    memo[SHARD][key] = cuts;
+}
 
+/* Forgets the verdicts on candidate placements, once the requirements or the variables of the demands changed. */
+void Callback::clearPlacementMemo()
+{
+    for (int shard = 0; shard < MEMO_SHARDS; shard++){
+        std::lock_guard<std::mutex> lock(memo_flag[shard]);
+        memo[shard].clear();
+    }
+}
 
+/* Builds a cut found by a separation task. */
+IloRange Callback::buildCut(const PendingCut& cut) const
+{
+    IloExpr exp(env);
+    for (unsigned int j = 0; j < cut.vars.size(); j++){
+        exp += cut.coefs[j] * cut.vars[j];
+    }
+    return IloRange(env, cut.lb, exp, cut.ub);
+}
 
-IloNum3DMatrix Callback::getIntegerSolution(const Context &context) const
+/* Returns the current fractional x-solution. */
+IloNum4DMatrix Callback::getFractionalSectionSolution(const Context &context) const
+{
+    /* Mandatory clauses */
+    if (context.getId() != Context::Id::Relaxation){
+        throw IloCplex::Exception(-1, "ERROR: Trying to access fractional solution while not in relaxation context !");
+    }
+
+    IloNum4DMatrix xSol(data.getNbDemands());
+    for (int k = 0; k < data.getNbDemands(); k++){
+        const int NB_VNFS = data.getDemand(k).getNbVNFs();
+        const int NB_PATHS = data.getNbPaths(k);
+        xSol[k].resize(data.getNbNodes());
+        for (int v = 0; v < data.getNbNodes(); v++){
+            xSol[k][v].resize(NB_VNFS);
+            for (int i = 0; i < NB_VNFS; i++){
+                xSol[k][v][i].resize(NB_PATHS);
+                for (int p = 0; p < NB_PATHS; p++){
+                    xSol[k][v][i][p] = context.getRelaxationPoint(x[k][v][i][p]);
+                }
+            }
+        }
+    }
+    return xSol;
+}
+
+
+
+/* Fetches the candidate values of the path activation and placement variables into the buffer of the invoking thread, and returns it. */
+const IloNumArray& Callback::fetchCandidatePoint(const Context &context)
 {
     /* Mandatory clauses */
     if (context.getId() != Context::Id::Candidate){
@@ -280,56 +1427,100 @@ IloNum3DMatrix Callback::getIntegerSolution(const Context &context) const
         throw IloCplex::Exception(-1, "ERROR: Unbounded solution within callback !");
     }
 
-    /* Initialize solution */
-    IloNum3DMatrix ySol;
-    const int NB_NODES = lemon::countNodes(data.getGraph());
-    const int NB_DEMANDS = data.getNbDemands();
-    ySol.resize(NB_DEMANDS);
-    for (int k = 0; k < data.getNbDemands(); k++){
-        ySol[k].resize(NB_NODES);
-        for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-            int v = data.getNodeId(n);
-            ySol[k][v].resize(data.getNbPaths(k));
-        }
+    IloNumArray& point = candidateBuffers[getThreadIndex(context)];
+    context.getCandidatePoint(candidateVars, point);
+    return point;
+}
+
+/* Fetches the candidate values of the section placement variables into the buffer of the invoking thread, and returns it. */
+const IloNumArray& Callback::fetchCandidateHosts(const Context &context)
+{
+    /* Mandatory clauses */
+    if (context.getId() != Context::Id::Candidate){
+        throw IloCplex::Exception(-1, "ERROR: Trying to access integer solution while not in candidate context !");
     }
 
-    /* Fill solution matrix */
-    for (int k = 0; k < NB_DEMANDS; k++){
-        const int NB_PATHS = data.getNbPaths(k);
-        for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-            int v = data.getNodeId(n);
-            for (int p = 0; p < NB_PATHS; p++){
-                ySol[k][v][p] = context.getCandidatePoint(y[k][v][p]);
-            }
-        }
+    IloNumArray& hosts = hostBuffers[getThreadIndex(context)];
+    context.getCandidatePoint(hostVars, hosts);
+    return hosts;
+}
+
+/* Fetches the relaxation values of the path activation and placement variables into the buffer of the invoking thread, and returns it. */
+const IloNumArray& Callback::fetchRelaxationPoint(const Context &context)
+{
+    /* Mandatory clauses */
+    if (context.getId() != Context::Id::Relaxation && context.getId() != Context::Id::Branching){
+        throw IloCplex::Exception(-1, "ERROR: Trying to access fractional solution while not in relaxation nor branching context !");
     }
-    
-    /* Return solution matrix */
-    return ySol;
+
+    IloNumArray& point = candidateBuffers[getThreadIndex(context)];
+    context.getRelaxationPoint(candidateVars, point);
+    return point;
 }
 
 /****************************************************************************************/
-/*								THREAD PROTECTED METHODS			    				*/
+/*								THREAD STATISTICS METHODS			    				*/
 /****************************************************************************************/
-void Callback::incrementLazyConstraints()
+/* Returns the slot index of the thread invoking the callback. */
+int Callback::getThreadIndex(const Context &context) const
+{
+    const int THREAD = (int)context.getIntInfo(Context::Info::ThreadId);
+    if (THREAD < 0 || THREAD >= nbStats){
+        throw IloCplex::Exception(-1, "ERROR: Callback invoked from more threads than statistics slots !");
+    }
+    return THREAD;
+}
+
+/* Returns the statistics of every thread summed up. */
+ThreadStats Callback::getTotalStats() const
+{
+    ThreadStats total = ThreadStats();
+    for (int t = 0; t < nbStats; t++){
+        total.nbLazyConstraints += stats[t].nbLazyConstraints;
+        total.nbUserCuts += stats[t].nbUserCuts;
+        total.nbPostedSolutions += stats[t].nbPostedSolutions;
+        total.nbBranches += stats[t].nbBranches;
+        total.nbLocalBounds += stats[t].nbLocalBounds;
+        total.nbPrunedNodes += stats[t].nbPrunedNodes;
+        total.time += stats[t].time;
+    }
+    return total;
+}
+
+void Callback::incrementLazyConstraints(const Context &context)
+{
+    ++getThreadStats(context).nbLazyConstraints;
+}
+
+void Callback::incrementUsercuts(const Context &context)
+{
+    ++getThreadStats(context).nbUserCuts;
+}
+
+void Callback::incrementTime(const Context &context, const IloNum time)
+{
+    getThreadStats(context).time += time;
+}
+
+void Callback::incrementPostedSolutions(const Context &context)
+{
+    ++getThreadStats(context).nbPostedSolutions;
+}
+
+/* Increase by one the number of branchings decided by the callback. */
+void Callback::incrementBranches(const Context &context)
 {
-    thread_flag.lock();
-    ++nbLazyConstraints;
-    ++nbCuts;
-    thread_flag.unlock();
+    ++getThreadStats(context).nbBranches;
 }
 
-void Callback::incrementUsercuts()
+/* Increase by one the number of local bounds tightened by propagation. */
+void Callback::incrementLocalBounds(const Context &context)
 {
-    thread_flag.lock();
-    ++nbUserCuts;
-    ++nbCuts;
-    thread_flag.unlock();
+    ++getThreadStats(context).nbLocalBounds;
 }
 
-void Callback::incrementTime(const IloNum time)
+/* Increase by one the number of nodes pruned by propagation. */
+void Callback::incrementPrunedNodes(const Context &context)
 {
-    thread_flag.lock();
-    timeAll += time;
-    thread_flag.unlock();
+    ++getThreadStats(context).nbPrunedNodes;
 }
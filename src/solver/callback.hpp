@@ -8,6 +8,10 @@
 /*** C++ Libraries ***/
 #include <thread>
 #include <mutex>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <cstdint>
 
 /*** CPLEX Libraries ***/
 #include <ilcplex/ilocplex.h>
@@ -16,6 +20,10 @@ ILOSTLBEGIN
 /*** Own Libraries ***/
 #include "../instance/data.hpp"
 #include "../tools/others.hpp"
+#include "solutionpool.hpp"
+#include "routing.hpp"
+#include "constructive.hpp"
+#include "../tools/taskpool.hpp"
 
 /****************************************************************************************/
 /*										TYPEDEFS										*/
@@ -42,9 +50,63 @@ typedef IloCplex::Callback::Context     Context;
 #define EPS 1e-4 // Tolerance, about float precision
 #define EPSILON 1e-6 // Tolerance, about float precision
 #define BIG_EPSILON 1e-10 // Tolerance, about float precision
+#define SUPPORT_EPS 1e-6 // Violation above which a path support cut is added
+#define CUT_POOL_MAX_ADDED 50 // Maximum number of pooled cuts added per relaxation, the most violated first
+#define CACHE_LINE_SIZE 64 // Bytes per cache line, the alignment of per-thread statistics
+#define COVER_EXACT_LIMIT 4096 // Maximum number of covers enumerated by the exact cover separation, greedy beyond
+#define MEMO_SHARDS 16 // Number of independently locked shards of the placement memo
+#define MEMO_SHARD_CAPACITY 65536 // Placements kept per memo shard, which is emptied beyond
+
+
+/********************************************************************************************
+ * The statistics gathered by one CPLEX thread. Each slot starts on its own cache line, so
+ * that threads never write to a line holding the statistics of another thread.
+********************************************************************************************/
+struct alignas(CACHE_LINE_SIZE) ThreadStats {
+    int     nbLazyConstraints;  /**< Number of lazy constraints added. **/
+    int     nbUserCuts;         /**< Number of user cuts added. **/
+    int     nbPostedSolutions;  /**< Number of heuristic solutions posted. **/
+    int     nbBranches;         /**< Number of branchings decided by the callback. **/
+    int     nbLocalBounds;      /**< Number of local bounds tightened by propagation. **/
+    int     nbPrunedNodes;      /**< Number of nodes pruned by propagation. **/
+    IloNum  time;               /**< Time spent on callback. **/
+};
+
+/********************************************************************************************
+ * A cut found by a separation task. Its terms are kept apart from Concert, whose environment
+ * is not thread safe, until the cut is built on the callback thread.
+********************************************************************************************/
+struct PendingCut {
+    std::vector<IloNumVar>  vars;   /**< The variables of the cut. **/
+    std::vector<double>     coefs;  /**< The coefficient of each variable. **/
+    double                  lb;     /**< The lower bound of the cut. **/
+    double                  ub;     /**< The upper bound of the cut. **/
+};
+
+/********************************************************************************************
+ * A candidate placement of a demand, packed as bits: whether each path is active, then
+ * whether each active path uses each node.
+********************************************************************************************/
+struct PlacementKey {
+    int                     k;      /**< The demand id. **/
+    std::vector<uint64_t>   bits;   /**< The packed placement. **/
 
+    /** Returns true if both keys describe the same placement. **/
+    bool operator==(const PlacementKey& other) const { return (k == other.k && bits == other.bits); }
+};
 
+/** Hashes a placement key. **/
+struct PlacementKeyHash {
+    std::size_t operator()(const PlacementKey& key) const {
+        uint64_t h = (uint64_t)key.k;
+        for (unsigned int w = 0; w < key.bits.size(); w++){
+            h ^= key.bits[w] + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        }
+        return (std::size_t)h;
+    }
+};
 
+typedef std::unordered_map<PlacementKey, std::vector<PendingCut>, PlacementKeyHash> PlacementMemo;
 
 /************************************************************************************
  * This class implements the generic callback interface. It has two main 
@@ -63,16 +125,54 @@ private:
 	const IloNumVar3DMatrix&    y;          /**< VNF placement variables **/
 	const IloNumVar4DMatrix&    x;          /**< VNF section placement variables **/
 	const IloNumVarMatrix&      alpha;      /**< Path activation variables **/
-    IloRangeArray               cutPool;    /**< Cutpool to be checked on each node. **/
+    IloNumVarMatrix             avail;      /**< Path availability variables, separated against when the availability cuts are on. **/
+
+    const bool                  candidateOnly;  /**< True if only candidates are checked, without cuts, heuristics nor separation threads, as within a neighbourhood model. **/
+    bool                        availabilityCheck; /**< False while the availability approximation is being refined, candidates being then checked by the refinement loop. **/
+
+    /*** Cut pool, stored as sparse rows over the pool columns ***/
+    IloNumVarArray                  poolVars;       /**< poolVars[j] is the variable of column j, fetched at once on each check. **/
+    std::unordered_map<IloInt, int> poolColumn;     /**< The column of each pooled variable, indexed by variable id. **/
+    std::vector<int>                poolRowStart;   /**< Row i spans entries poolRowStart[i] to poolRowStart[i+1]-1. **/
+    std::vector<int>                poolIndex;      /**< The column of each entry. **/
+    std::vector<double>             poolCoef;       /**< The coefficient of each entry. **/
+    std::vector<double>             poolLB;         /**< The lower bound of each row. **/
+    std::vector<double>             poolUB;         /**< The upper bound of each row. **/
+    std::mutex                      pool_flag;      /**< A mutex protecting the cut pool, which grows during the search. **/
+
+    /*** Benders data ***/
+    Routing*                    routing;        /**< Routing subproblems checking candidate placements. NULL unless the Benders engine is used. **/
+
+    /*** Separation data ***/
+    TaskPool*                   separationPool; /**< Threads sharing the per-demand separation work of an invocation. **/
+    mutable PlacementMemo       memo[MEMO_SHARDS];      /**< The cuts rejecting each candidate placement already checked, none if it meets the requirement. **/
+    mutable std::mutex          memo_flag[MEMO_SHARDS]; /**< A mutex protecting each shard of the placement memo. **/
+
+    /*** Candidate point, fetched at once into a flat buffer ***/
+    IloNumVarArray              candidateVars;      /**< The path activation then placement variables of each demand, fetched on each candidate. **/
+    std::vector<int>            candidateOffset;    /**< The index of alpha[k][0] in candidateVars, y[k][v][p] following alpha[k] at v*NB_PATHS + p. **/
+    std::vector<IloNumArray>    candidateBuffers;   /**< candidateBuffers[t] receives the candidate or relaxation point on the CPLEX thread of id t. **/
+    std::vector<IloNumArray>    lowerBuffers;       /**< lowerBuffers[t] receives the local lower bounds on the CPLEX thread of id t. **/
+    std::vector<IloNumArray>    upperBuffers;       /**< upperBuffers[t] receives the local upper bounds on the CPLEX thread of id t. **/
+    std::vector<IloNumArray>    hostBuffers;        /**< hostBuffers[t] receives the candidate section placement on the CPLEX thread of id t. **/
+
+    /*** Heuristic data ***/
+    SolutionPool*               solutionPool;   /**< Pool exchanging solutions with the improvement heuristics. NULL if none runs. **/
+    IloNumVarArray              solutionVars;   /**< The variables indexing the solutions of the pool. **/
+    IloNumVarArray              repairVars;     /**< The candidate variables followed by the section placement variables of each demand, indexing repaired solutions. **/
+    IloNumVarArray              hostVars;       /**< The section placement variables of each demand, fetched when a candidate is repaired. **/
+    std::vector<int>            hostOffset;     /**< The index of x[k][0][0][0] in repairVars, x[k][v][i][p] following at (v*NB_VNFS + i)*NB_PATHS + p. **/
+    std::vector<double>         repairValues;   /**< The best repaired solution not yet posted to CPLEX. **/
+    double                      repairObj;      /**< The objective value of the pending repaired solution. **/
+    bool                        hasRepair;      /**< True if a repaired solution is pending. **/
+    std::mutex                  repair_flag;    /**< A mutex protecting the pending repaired solution. **/
 
 
     /*** Manage execution and control ***/
-    std::mutex  thread_flag;                /**< A mutex for synchronizing multi-thread operations. **/
-    int         nb_cuts_avail_heuristic;    /**< Number of availability cuts added through heuristic procedure. **/
-    int         nbLazyConstraints;          /**< Number of lazy constraints added. **/
-    int         nbUserCuts;                 /**< Number of user cuts added. **/
-    int         nbCuts;                     /**< Total number of user cuts added. **/
-    IloNum      timeAll;                    /**< Total time spent on callback. **/
+    int                 nb_cuts_avail_heuristic;    /**< Number of availability cuts added through heuristic procedure. **/
+    std::vector<char>   statsBuffer;                /**< The storage of the statistics slots, one slot larger than needed so that they can start on a cache line. **/
+    ThreadStats*        stats;                      /**< stats[t] are the statistics of the CPLEX thread of id t, aggregated only when read. **/
+    int                 nbStats;                    /**< Number of statistics slots. **/
 
 
 public:
@@ -80,8 +180,8 @@ public:
 	/****************************************************************************************/
 	/*										Constructors									*/
 	/****************************************************************************************/
-    /** Constructor. Initializes callback variables. **/
-	Callback(const IloEnv& env_, const Data& data_, const IloNumVar3DMatrix& y_, const IloNumVar4DMatrix& x_, const IloNumVarMatrix& alpha_);
+    /** Constructor. Initializes callback variables. @param candidateOnly True to only check candidates, as within a neighbourhood model. **/
+	Callback(const IloEnv& env_, const Data& data_, const IloNumVar3DMatrix& y_, const IloNumVar4DMatrix& x_, const IloNumVarMatrix& alpha_, const bool candidateOnly = false);
 
 
 	/****************************************************************************************/
@@ -93,16 +193,64 @@ public:
     /** Solves the separation problems for a given fractional solution. @note Should only be called within relaxation context.**/
 	void            addUserCuts             (const Context& context); 
     
-    /** Solves the separation problems for a given integer solution. @note Should only be called within candidate context.**/
-    void            addLazyConstraints      (const Context& context);
+    /** Solves the separation problems for a given integer solution. Returns true if the candidate was rejected. @param point The candidate buffer. @note Should only be called within candidate context.**/
+    bool            addLazyConstraints      (const Context& context, const IloNumArray& point);
+
+    /** Solves the routing subproblems for a given candidate placement and rejects it if some path cannot be routed. Returns true if the candidate was rejected. @param point The candidate buffer. @note Should only be called within candidate context.**/
+    bool            addRoutingCuts          (const Context& context, const IloNumArray& point);
+
+    /** Publishes an accepted candidate solution to the solution pool if it improves the incumbent. @note Should only be called within candidate context.**/
+    void            publishIncumbent        (const Context& context);
+
+    /** Posts the pending improvement of the solution pool, if any, to CPLEX. @note Should only be called within relaxation context.**/
+    void            postHeuristicSolutions  (const Context& context);
+
+    /** Repairs a candidate rejected for the availability of some demands, by moving one of their VNFs to a more available node or adding a parallel path, and keeps the result to be posted if it improves the incumbent. @param point The candidate buffer. @param failing The demands missing their required availability. @note Should only be called within candidate context. **/
+    void            repairCandidate         (const Context& context, const IloNumArray& point, const std::vector<int>& failing);
+
+    /** Posts the pending repaired solution, if any, to CPLEX. @note Should only be called within relaxation context.**/
+    void            postRepairedSolution    (const Context& context);
+
+    /** Returns the index of x[k][v][i][p] in the repaired solutions. **/
+    int             getXIndex               (const int k, const int v, const int i, const int p) const { return hostOffset[k] + (v * data.getDemand(k).getNbVNFs() + i) * data.getNbPaths(k) + p; }
+
+    /** Fetches the candidate values of the path activation and placement variables into the buffer of the invoking thread, and returns it. @note Should only be called within candidate context. **/ 
+    const IloNumArray& fetchCandidatePoint  (const Context &context);
+
+    /** Fetches the candidate values of the section placement variables into the buffer of the invoking thread, and returns it. x[k][v][i][p] is found at getXIndex(k, v, i, p) - candidateVars.getSize(). @note Should only be called within candidate context. **/ 
+    const IloNumArray& fetchCandidateHosts  (const Context &context);
+
+    /** Fetches the relaxation values of the path activation and placement variables into the buffer of the invoking thread, and returns it. @note Should only be called within relaxation or branching context. **/ 
+    const IloNumArray& fetchRelaxationPoint (const Context &context);
 
-    /** Returns the current integer y-solution. @note Should only be called within candidate context. **/ 
-    IloNum3DMatrix  getIntegerSolution      (const Context &context) const;
+    /** Branches on the number of active paths of the demand whose count is the most fractional, or else on the most fractional placement on the least available node. Returns false, leaving the decision to CPLEX, if the relaxation is integral on both. @note Should only be called within branching context.**/
+    bool            makeStructuredBranch    (const Context& context);
+
+    /** Propagates the availability requirements on the local bounds of the path activation and placement variables. Paths that some demand cannot do without are activated, the number of active paths is bounded from below and placements no longer able to meet the requirement are forbidden, through local cuts violated by the relaxation. Returns true if the node was pruned, the requirement of some demand being out of reach. @note Should only be called within relaxation context.**/
+    bool            propagateAvailability   (const Context& context);
+
+    /** Returns the index of alpha[k][p] in the candidate buffer. **/
+    int             getAlphaIndex           (const int k, const int p) const { return candidateOffset[k] + p; }
+
+    /** Returns the index of y[k][v][p] in the candidate buffer. **/
+    int             getYIndex               (const int k, const int v, const int p) const { return candidateOffset[k] + (v + 1) * data.getNbPaths(k) + p; }
     
-    /** Returns the current fractional solution. @note Should only be called within relaxation context. **/ 
-    IloNum3DMatrix  getFractionalSolution   (const Context &context) const;
+    /** Returns the current fractional x-solution, indexed as the section placement variables. @note Should only be called within relaxation context. **/ 
+    IloNum4DMatrix  getFractionalSectionSolution(const Context &context) const;
+
+    /** Returns the key of the placement of a demand within a candidate solution. @param k The demand id. @param point The candidate buffer. **/
+    PlacementKey    getPlacementKey         (const int k, const IloNumArray& point) const;
+
+    /** Appends the cuts rejecting a placement already checked. Returns false if it was never checked. @param key The placement. @param cuts The cuts rejecting it. @note Thread safe. **/
+    bool            findPlacementVerdict    (const PlacementKey& key, std::vector<PendingCut>& cuts) const;
+
+    /** Stores the cuts rejecting a placement, none if it meets the requirement. @param key The placement. @param cuts The cuts rejecting it. @note Thread safe. **/
+    void            storePlacementVerdict   (const PlacementKey& key, const std::vector<PendingCut>& cuts) const;
+
+    /** Builds a cut found by a separation task. @note Should only be called from the callback thread. **/
+    IloRange        buildCut                (const PendingCut& cut) const;
 
-    /** Checks whether the current solution satisfies all cuts in the pool and add the unsatisfied one. **/
+    /** Checks whether the current fractional solution satisfies all cuts in the pool and adds the most violated ones. Returns true if some cut was added. @note Should only be called within relaxation context. **/
     bool            checkCutPool            (const Context &context);
 
 	/****************************************************************************************/
@@ -111,23 +259,66 @@ public:
     /** Sets up the cut pool that is checked on relaxation context. @note On this pool, only cuts appearing in a polynomial number are added. **/
     void setCutPool();
 
+    /** Stores a cut in the pool, to be added again wherever it is violated. @param cut The cut to be stored. **/
+    void addToCutPool(const IloRange& cut);
+
+    /** Sets the path availability variables the availability cuts are separated on. @param avail The path availability variables. **/
+    void setAvailabilityVariables(const IloNumVarMatrix& avail_) { avail = avail_; }
+
+    /** Sets up the pool through which solutions are exchanged with the improvement heuristics. @param pool The solution pool. @param vars The variables indexing the pool solutions. **/
+    void setSolutionPool(SolutionPool* pool, const IloNumVarArray& vars);
+
+    /** Sets up the flat index of the variables fetched on each candidate, once the variables of the demands changed. **/
+    void setCandidateVariables();
+
+    /** Forgets the verdicts on candidate placements, once the requirements or the variables of the demands changed. **/
+    void clearPlacementMemo();
+
+    /** Sets the number of CPLEX threads statistics are gathered from, keeping the totals gathered so far. @param nbThreads The number of threads, 0 standing for as many as cores. @note Should not be called during a solve. **/
+    void setNbThreads(const int nbThreads);
+
+    /** Replaces the threads sharing the per-demand separation work. @param nbThreads The number of threads, 1 or less separating serially. @note Should not be called during a solve. **/
+    void setSeparationThreads(const int nbThreads);
+
 	/****************************************************************************************/
 	/*								      Query Methods	    	    	    				*/
 	/****************************************************************************************/
-    /** Returns the number of user cuts added so far. **/ 
-    const int    getNbUserCuts()           const{ return nbCuts; }
+    /** Returns the statistics of every thread summed up. **/
+    ThreadStats  getTotalStats()           const;
+    /** Returns the total number of cuts, user cuts and lazy constraints, added so far. **/ 
+    const int    getNbUserCuts()           const{ const ThreadStats TOTAL = getTotalStats(); return TOTAL.nbUserCuts + TOTAL.nbLazyConstraints; }
     /** Returns the number of lazy constraints added so far. **/ 
-    const int    getNbLazyConstraints()    const{ return nbLazyConstraints; }
+    const int    getNbLazyConstraints()    const{ return getTotalStats().nbLazyConstraints; }
     /** Returns the total time spent on callback so far. **/ 
-    const IloNum getTime()                 const{ return timeAll; }
+    const IloNum getTime()                 const{ return getTotalStats().time; }
+    /** Returns the number of heuristic solutions posted so far. **/ 
+    const int    getNbPostedSolutions()    const{ return getTotalStats().nbPostedSolutions; }
+    /** Returns the number of branchings decided by the callback so far. **/ 
+    const int    getNbBranches()           const{ return getTotalStats().nbBranches; }
+    /** Returns the number of local bounds tightened by propagation so far. **/ 
+    const int    getNbLocalBounds()        const{ return getTotalStats().nbLocalBounds; }
+    /** Returns the number of nodes pruned by propagation so far. **/ 
+    const int    getNbPrunedNodes()        const{ return getTotalStats().nbPrunedNodes; }
+    /** Returns the number of cuts in the pool. **/ 
+    const int    getCutPoolSize()          const{ return (int)poolLB.size(); }
+    /** Returns true if candidate solutions must be checked against the exact availability constraints. **/
+    const bool   isAvailabilityLazyRequired() const;
+    /** Turns on or off the exact availability check of candidate solutions. **/
+    void         setAvailabilityCheck(const bool check) { availabilityCheck = check; }
+    /** Returns true if candidate solutions must be checked by the callback, either for availability or for routing. **/
+    const bool   isLazyRequired()          const { return (isAvailabilityLazyRequired() || routing != NULL); }
+    /** Returns the contexts under which the callback must be invoked, 0 if none. **/
+    const CPXLONG getContextMask()         const;
     /** Checks if all placement variables of a given SFC demand are inetegers. @param k The demand id. @param xSol The current solution. **/
     const bool   isIntegerAssignment(const int& k, const IloNum3DMatrix& xSol) const;
-    /** Returns the last activated path index for a given SFC within a candidate solution. @note Should only be called within candidate context. **/
-    const int    getLastPathIndex(const Context &context, const int k) const;
-    /** Returns the SFC availability induced by a candidate solution. @note Should only be called within candidate context. **/
-    const double getPlacementAvailability(const Context &context, const int k) const;
-    /* Returns the most unavailable section of a path in the for log(unavailability) given a fractional solution. @note Should only be called within relaxation context.*/
-    const double getMostUnavailableSection(const Context &context, const int k, const int p, int &section) const;
+    /** Returns an upper bound on the availability of a demand whose active paths use, all together, at least a given number of their substitute nodes. @param substitutes The substitute nodes of each path. @param active States whether each path is active. @param size The number of substitutes used, -1 standing for all of them. **/
+    const double getSupportAvailabilityBound(const std::vector<std::vector<int> >& substitutes, const std::vector<bool>& active, int size = -1) const;
+    /** Returns the last activated path index of a given SFC within a candidate solution. @param point The candidate buffer. **/
+    const int    getLastPathIndex(const IloNumArray& point, const int k) const;
+    /** Returns the SFC availability induced by a candidate solution. @param point The candidate buffer. **/
+    const double getPlacementAvailability(const IloNumArray& point, const int k) const;
+    /** Returns the most unavailable section of a path in the form -log(unavailability) given a fractional solution. @param xSol The fractional x-solution. **/
+    const double getMostUnavailableSection(const IloNum4DMatrix& xSol, const int k, const int p, int &section) const;
 
 
 	/****************************************************************************************/
@@ -135,22 +326,44 @@ public:
 	/****************************************************************************************/
     /** Solves the separation problem associated with Section Failure inequalities. **/
     void sectionFailureSeparation(const Context &context);
+    /** Solves the separation problem associated with Section Failure inequalities for a given demand. @param k The demand id. @param xSol The fractional x-solution. @param cuts The cuts found. @note Thread safe. **/
+    void sectionFailureSeparation(const int k, const IloNum4DMatrix& xSol, std::vector<PendingCut>& cuts) const;
+    /** Solves the separation problem associated with availability no-good inequalities for a given demand. @param k The demand id. @param point The candidate buffer. @param cuts The cuts found. @note Thread safe. **/
+    void availabilityNoGoodSeparation(const int k, const IloNumArray& point, std::vector<PendingCut>& cuts) const;
+    /** Solves the separation problem associated with path support inequalities, in both relaxation and candidate contexts. Returns true if a candidate was rejected. @param point The candidate buffer, NULL within relaxation context. **/
+    bool pathSupportSeparation(const Context &context, const IloNumArray* point = NULL);
+    /** Solves the separation problem associated with availability cover inequalities on section placement variables. **/
+    void sectionCoverSeparation(const Context &context);
+    /** Solves the separation problem associated with availability cover inequalities on the node placement variables of single-path demands. **/
+    void placementCoverSeparation(const Context &context);
 
 	/****************************************************************************************/
-	/*								Thread Protected Methods			    				*/
+	/*								Thread Statistics Methods			    				*/
 	/****************************************************************************************/
+    /** Returns the slot index of the thread invoking the callback. **/
+    int getThreadIndex(const Context &context) const;
+    /** Returns the statistics slot of the thread invoking the callback. **/
+    ThreadStats& getThreadStats(const Context &context) { return stats[getThreadIndex(context)]; }
     /** Increase by one the number of lazy constraints added. **/
-    void incrementLazyConstraints();
+    void incrementLazyConstraints(const Context &context);
     /** Increase by one the number of user cuts added. **/
-    void incrementUsercuts();
+    void incrementUsercuts(const Context &context);
     /** Increases the total callback time. @param time The time to be added. **/
-    void incrementTime(const IloNum time);
+    void incrementTime(const Context &context, const IloNum time);
+    /** Increase by one the number of heuristic solutions posted. **/
+    void incrementPostedSolutions(const Context &context);
+    /** Increase by one the number of branchings decided by the callback. **/
+    void incrementBranches(const Context &context);
+    /** Increase by one the number of local bounds tightened by propagation. **/
+    void incrementLocalBounds(const Context &context);
+    /** Increase by one the number of nodes pruned by propagation. **/
+    void incrementPrunedNodes(const Context &context);
 
 	/****************************************************************************************/
 	/*										Destructors			    						*/
 	/****************************************************************************************/
     /** Destructor **/
-    ~Callback() {}
+    ~Callback() { delete routing; delete separationPool; }
 
 };
 
@@ -0,0 +1,370 @@
+#include "columngeneration.hpp"
+
+/* Constructor */
+ColumnGeneration::ColumnGeneration(const IloEnv& env_, const Data& data_) :
+                env(env_), model(env), cplex(model), data(data_), obj(env),
+                availRow(env), maxPathsRow(env), nodeCapRow(env), arcCapRow(env),
+                slack(env), allLambda(env), nbIterations(0), lpBound(0.0), exact(true)
+{
+    std::cout << "=> Building column generation master ... " << std::endl;
+
+    setMaster();
+    setInitialColumns();
+
+    std::cout << "\t Master was correctly built with " << getNbColumns() << " initial chains ! " << std::endl;
+}
+
+/****************************************************************************************/
+/*										FORMULATION										*/
+/****************************************************************************************/
+
+/* Set up the z and slack variables, the objective function and the master rows. */
+void ColumnGeneration::setMaster()
+{
+    const int NB_NODES   = data.getNbNodes();
+    const int NB_ARCS    = (int)data.getLinks().size();
+    const int NB_DEMANDS = data.getNbDemands();
+    const int NB_VNFS    = data.getNbVnfs();
+
+    /* A unit of slack must cost more than any placement covering it. */
+    double totalCost = 1.0;
+    for (int v = 0; v < NB_NODES; v++){
+        for (int f = 0; f < NB_VNFS; f++){
+            totalCost += data.getPlacementCost(data.getNode(v), data.getVnf(f));
+        }
+    }
+    double minLogUnavail = 1.0;
+    for (int k = 0; k < NB_DEMANDS; k++){
+        minLogUnavail = std::min(minLogUnavail, -std::log(1.0 - data.getDemand(k).getAvailability()));
+    }
+    slackPenalty = totalCost / minLogUnavail;
+
+    /* VNF global placement variables: z[v][f] = 1 if vnf f is placed on node v */
+    IloExpr exp(env);
+    z.resize(NB_NODES);
+    for (int v = 0; v < NB_NODES; v++){
+        z[v].resize(NB_VNFS);
+        for (int f = 0; f < NB_VNFS; f++){
+            std::string name = "z(" + std::to_string(v) + "," + std::to_string(f) + ")";
+            z[v][f] = IloNumVar(env, 0.0, 1.0, ILOFLOAT, name.c_str());
+            model.add(z[v][f]);
+            exp += data.getPlacementCost(data.getNode(v), data.getVnf(f)) * z[v][f];
+        }
+    }
+
+    /* Availability slack variables: slack[k] is the missing -log(unavailability) of demand k. */
+    for (int k = 0; k < NB_DEMANDS; k++){
+        std::string name = "slack(" + std::to_string(k) + ")";
+        slack.add(IloNumVar(env, 0.0, IloInfinity, ILOFLOAT, name.c_str()));
+        exp += slackPenalty * slack[k];
+    }
+    model.add(slack);
+    obj.setExpr(exp);
+    obj.setSense(IloObjective::Minimize);
+    model.add(obj);
+    exp.end();
+
+    /* Demand rows. */
+    disjointRow.resize(NB_DEMANDS);
+    linkRow.resize(NB_DEMANDS);
+    for (int k = 0; k < NB_DEMANDS; k++){
+        const Demand& demand = data.getDemand(k);
+        std::string name = "Availability(" + std::to_string(k) + ")";
+        availRow.add(IloRange(env, -IloInfinity, -1.0 * slack[k], std::log(1.0 - demand.getAvailability()), name.c_str()));
+        name = "Max_Paths(" + std::to_string(k) + ")";
+        maxPathsRow.add(IloRange(env, -IloInfinity, data.getNbPaths(k), name.c_str()));
+
+        disjointRow[k] = IloRangeArray(env);
+        linkRow[k].resize(NB_NODES);
+        for (int v = 0; v < NB_NODES; v++){
+            name = "Disjunction(" + std::to_string(k) + "," + std::to_string(v) + ")";
+            disjointRow[k].add(IloRange(env, -IloInfinity, 1.0, name.c_str()));
+            linkRow[k][v] = IloRangeArray(env);
+            for (int i = 0; i < demand.getNbVNFs(); i++){
+                name = "Linking_z(" + std::to_string(k) + "," + std::to_string(i) + "," + std::to_string(v) + ")";
+                linkRow[k][v].add(IloRange(env, -IloInfinity, -1.0 * z[v][demand.getVNF_i(i)], 0.0, name.c_str()));
+            }
+            model.add(linkRow[k][v]);
+        }
+        model.add(disjointRow[k]);
+    }
+    model.add(availRow);
+    model.add(maxPathsRow);
+
+    /* Capacity rows. */
+    for (int v = 0; v < NB_NODES; v++){
+        std::string name = "Node_Capacity(" + std::to_string(v) + ")";
+        nodeCapRow.add(IloRange(env, -IloInfinity, data.getNode(v).getCapacity(), name.c_str()));
+    }
+    for (int a = 0; a < NB_ARCS; a++){
+        std::string name = "Arc_Capacity(" + std::to_string(a) + ")";
+        arcCapRow.add(IloRange(env, -IloInfinity, data.getLink(a).getBandwidth(), name.c_str()));
+    }
+    model.add(nodeCapRow);
+    model.add(arcCapRow);
+
+    lambda.resize(NB_DEMANDS);
+    columns.resize(NB_DEMANDS);
+}
+
+/* Adds a chain of a given demand to the master. */
+void ColumnGeneration::addColumn(const int k, const ChainPath& path)
+{
+    const Demand& demand    = data.getDemand(k);
+    const double  BANDWIDTH = demand.getBandwidth();
+    const double  AVAIL     = std::min(getColumnAvailability(path), 1.0 - 1e-12);
+
+    IloNumColumn column = obj(0.0);
+    column += availRow[k](std::log(1.0 - AVAIL));
+    column += maxPathsRow[k](1.0);
+
+    std::vector<double> load(data.getNbNodes(), 0.0);
+    std::vector<bool> host(data.getNbNodes(), false);
+    for (unsigned int i = 0; i < path.hosts.size(); i++){
+        const int v = path.hosts[i];
+        load[v] += BANDWIDTH * data.getVnf(demand.getVNF_i(i)).getConsumption();
+        host[v] = true;
+        column += linkRow[k][v][i](1.0);
+    }
+    for (int v = 0; v < data.getNbNodes(); v++){
+        if (host[v]){
+            column += disjointRow[k][v](1.0);
+            column += nodeCapRow[v](load[v]);
+        }
+    }
+
+    /* As in the arc capacity constraints, the last section is not counted. */
+    std::vector<int> uses(data.getLinks().size(), 0);
+    for (unsigned int i = 0; i + 1 < path.sections.size(); i++){
+        for (unsigned int j = 0; j < path.sections[i].size(); j++){
+            uses[path.sections[i][j]]++;
+        }
+    }
+    for (unsigned int a = 0; a < uses.size(); a++){
+        if (uses[a] > 0){
+            column += arcCapRow[a](uses[a] * BANDWIDTH);
+        }
+    }
+
+    std::string name = "lambda(" + std::to_string(k) + "," + std::to_string(lambda[k].size()) + ")";
+    IloNumVar var(column, 0.0, 1.0, ILOFLOAT, name.c_str());
+    column.end();
+    lambda[k].push_back(var);
+    allLambda.add(var);
+    columns[k].push_back(path);
+}
+
+/* Seeds the master with the chains built by the constructive heuristic. */
+void ColumnGeneration::setInitialColumns()
+{
+    Constructive heuristic(data);
+    if (!heuristic.run()){
+        std::cout << "\t Some demands have no initial chain: their availability starts as slack." << std::endl;
+    }
+    for (int k = 0; k < data.getNbDemands(); k++){
+        const std::vector<ChainPath>& paths = heuristic.getPaths(k);
+        for (unsigned int p = 0; p < paths.size(); p++){
+            addColumn(k, paths[p]);
+        }
+    }
+}
+
+/* Builds the reduced cost components of a demand from the master duals. */
+PricingCosts ColumnGeneration::getPricingCosts(const int k) const
+{
+    /* Duals of <= rows are non-positive in a minimization: clamping only removes numerical noise. */
+    const Demand& demand    = data.getDemand(k);
+    const double  BANDWIDTH = demand.getBandwidth();
+    PricingCosts costs;
+    costs.fixed = std::max(0.0, -cplex.getDual(maxPathsRow[k]));
+    costs.availWeight = std::max(0.0, -cplex.getDual(availRow[k]));
+
+    costs.arcCost.resize(data.getLinks().size());
+    for (unsigned int a = 0; a < data.getLinks().size(); a++){
+        costs.arcCost[a] = std::max(0.0, -cplex.getDual(arcCapRow[a])) * BANDWIDTH;
+    }
+    costs.placeCost.resize(data.getNbNodes());
+    costs.hostCost.resize(data.getNbNodes());
+    for (int v = 0; v < data.getNbNodes(); v++){
+        const double NODE_DUAL = std::max(0.0, -cplex.getDual(nodeCapRow[v]));
+        costs.hostCost[v] = std::max(0.0, -cplex.getDual(disjointRow[k][v]));
+        costs.placeCost[v].resize(demand.getNbVNFs());
+        for (int i = 0; i < demand.getNbVNFs(); i++){
+            const double LOAD = BANDWIDTH * data.getVnf(demand.getVNF_i(i)).getConsumption();
+            costs.placeCost[v][i] = NODE_DUAL * LOAD + std::max(0.0, -cplex.getDual(linkRow[k][v][i]));
+        }
+    }
+    return costs;
+}
+
+/****************************************************************************************/
+/*										  GETTERS										*/
+/****************************************************************************************/
+
+/* Returns the availability of a chain, that is, the product of the availabilities of its distinct hosts. */
+double ColumnGeneration::getColumnAvailability(const ChainPath& path) const
+{
+    std::vector<int> hosts = path.hosts;
+    std::sort(hosts.begin(), hosts.end());
+    hosts.erase(std::unique(hosts.begin(), hosts.end()), hosts.end());
+    if (hosts.empty()){
+        return 1.0;
+    }
+    return data.getChainAvailability(hosts);
+}
+
+/* Returns the placement availability of a demand induced by the MIP solution. */
+double ColumnGeneration::getPlacementAvailability(int k)
+{
+    double prob_all_paths_fail = 1.0;
+    for (unsigned int c = 0; c < lambda[k].size(); c++){
+        if (cplex.getValue(lambda[k][c]) > 1 - EPS){
+            prob_all_paths_fail *= (1.0 - getColumnAvailability(columns[k][c]));
+        }
+    }
+    return (1.0 - prob_all_paths_fail);
+}
+
+/****************************************************************************************/
+/*										  METHODS										*/
+/****************************************************************************************/
+
+/* Solves the master LP by column generation, then the master MIP over the generated chains. */
+void ColumnGeneration::run()
+{
+    std::cout << "=> Solving master LP by column generation ..." << std::endl;
+    const double TIME_LIMIT = data.getInput().getTimeLimit();
+    time = cplex.getCplexTime();
+    cplex.setOut(env.getNullStream());
+
+    bool added = true;
+    while (added && cplex.getCplexTime() - time < TIME_LIMIT){
+        if (!cplex.solve()){
+            throw IloCplex::Exception(-1, "ERROR: The master LP could not be solved !");
+        }
+        lpBound = cplex.getObjValue();
+        nbIterations++;
+
+        int nbAdded = 0;
+        exact = true;
+        for (int k = 0; k < data.getNbDemands(); k++){
+            PricingCosts costs = getPricingCosts(k);
+            Pricing pricing(data, k, costs, CG_MAX_LABELS);
+            std::vector<ChainPath> newColumns;
+            std::vector<double> reducedCosts;
+            pricing.run(CG_COLUMNS_PER_PRICING, -RC_EPS, newColumns, reducedCosts);
+            if (pricing.isTruncated()){
+                exact = false;
+            }
+            for (unsigned int c = 0; c < newColumns.size(); c++){
+                addColumn(k, newColumns[c]);
+            }
+            nbAdded += (int)newColumns.size();
+        }
+        added = (nbAdded > 0);
+        std::cout << "\t Iteration " << nbIterations << ": LP = " << lpBound << ", chains added = " << nbAdded << std::endl;
+    }
+    /* Stopped by the time limit: columns may still price out. */
+    if (added){
+        exact = false;
+    }
+    std::cout << "\t Master LP value: " << lpBound;
+    if (!exact){
+        std::cout << " (not a lower bound)";
+    }
+    std::cout << std::endl;
+
+    /* Price-and-branch: the master is solved as a MIP over the generated chains. */
+    std::cout << "=> Solving master MIP over " << getNbColumns() << " chains ..." << std::endl;
+    cplex.setOut(env.out());
+    IloNumVarArray allZ(env);
+    for (unsigned int v = 0; v < z.size(); v++){
+        for (unsigned int f = 0; f < z[v].size(); f++){
+            allZ.add(z[v][f]);
+        }
+    }
+    model.add(IloConversion(env, allLambda, ILOINT));
+    model.add(IloConversion(env, allZ, ILOINT));
+    cplex.setParam(IloCplex::Param::TimeLimit, std::max(1.0, TIME_LIMIT - (cplex.getCplexTime() - time)));
+    cplex.solve();
+
+	/* Get final execution time */
+    time = cplex.getCplexTime() - time;
+}
+
+/* Displays the obtained results */
+void ColumnGeneration::printResult()
+{
+    std::cout << "=> Printing solution ..." << std::endl;
+    if (cplex.getStatus() != IloAlgorithm::Optimal && cplex.getStatus() != IloAlgorithm::Feasible){
+        std::cout << "\t No integer solution was found over the generated chains." << std::endl;
+        return;
+    }
+    for (int k = 0; k < data.getNbDemands(); k++) {
+        const Demand& demand = data.getDemand(k);
+        std::cout << std::endl << "----------------------------------------------------" << std::endl << std::endl;
+        std::cout << "k=" << k+1 << " : From " << demand.getSource() << " to " << demand.getTarget() << std::endl;
+        double placementAv = getPlacementAvailability(k);
+        std::cout << "\t Placement Avail: " << placementAv << std::endl;
+        std::cout << "\t Required Avail : " << demand.getAvailability() << std::endl;
+        if (cplex.getValue(slack[k]) > EPS){
+            std::cout << "\t ==> UNFEASIBLE BY " << demand.getAvailability() - placementAv << std::endl;
+        }
+        int p = 0;
+        for (unsigned int c = 0; c < lambda[k].size(); c++){
+            if (cplex.getValue(lambda[k][c]) < 1 - EPS){
+                continue;
+            }
+            const ChainPath& path = columns[k][c];
+            std::cout << "\t Path " << ++p << std::endl;
+            std::cout << "\t\t Real Path avail : " << std::setprecision(9) << getColumnAvailability(path) << std::endl;
+            std::cout << "\t\t Path description : " << std::endl;
+            for (unsigned int i = 0; i < path.sections.size(); i++){
+                int node = (i == 0) ? demand.getSource() : path.hosts[i-1];
+                std::cout << "\t\t\t Section " << i+1 << " : " << node;
+                for (unsigned int j = 0; j < path.sections[i].size(); j++){
+                    std::cout << " -- " << data.getLink(path.sections[i][j]).getTarget();
+                }
+                std::cout << "." << std::endl;
+            }
+        }
+    }
+
+    std::cout << "Objective value: " << cplex.getObjValue() << std::endl;
+    std::cout << "Master LP value: " << lpBound << std::endl;
+    std::cout << "Chains generated: " << getNbColumns() << std::endl;
+    std::cout << "Pricing iterations: " << nbIterations << std::endl;
+    std::cout << "Nodes evaluated: " << cplex.getNnodes() << std::endl;
+    std::cout << "Total time: " << time << std::endl << std::endl;
+}
+
+/* Outputs the obtained results */
+void ColumnGeneration::output()
+{
+    std::string output_file = data.getInput().getOutputFile();
+    if (output_file.empty()){
+        return;
+    }
+
+	std::ofstream fileReport(output_file, std::ios_base::app); // File report
+    // If file_output can't be opened
+    if(!fileReport)
+    {
+        std::cerr << "ERROR: Unable to access output file." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    const bool FOUND = (cplex.getStatus() == IloAlgorithm::Optimal || cplex.getStatus() == IloAlgorithm::Feasible);
+    fileReport << data.getInput().getInstanceName() << ";"
+    		   << time << ";"
+    		   << (FOUND ? cplex.getObjValue() : IloInfinity) << ";"
+    		   << lpBound << ";"
+    		   << (exact ? 1 : 0) << ";"
+    		   << cplex.getNnodes() << ";"
+    		   << getNbColumns() << ";"
+    		   << nbIterations << ";"
+               << std::endl;
+
+    // Finalization ***
+    fileReport.close();
+}
@@ -0,0 +1,122 @@
+#ifndef __columngeneration__hpp
+#define __columngeneration__hpp
+
+/****************************************************************************************/
+/*										LIBRARIES										*/
+/****************************************************************************************/
+
+/*** Own Libraries ***/
+#include "model.hpp"
+#include "pricing.hpp"
+
+/****************************************************************************************/
+/*										DEFINES			    							*/
+/****************************************************************************************/
+#define RC_EPS 1e-6 					// Reduced cost a column must go below to enter the master
+#define CG_COLUMNS_PER_PRICING 5 		// Maximum number of columns added per demand and iteration
+#define CG_MAX_LABELS 200000 			// Maximum number of labels created by a pricing
+
+/********************************************************************************************
+ * This class implements the path-based formulation of the problem, solved by column
+ * generation. Each column is a placed and routed chain of one demand. The master selects
+ * node-disjoint parallel chains for each demand, enforces availability exactly through
+ *      sum_c log(1 - a_c) * lambda_c <= log(1 - A_k),
+ * which is valid because parallel chains share no host, and couples demands through node
+ * capacities, arc capacities and the VNF placement variables z. Columns are generated by a
+ * resource-constrained shortest path pricing. Once no column prices out, the master is
+ * solved as a MIP over the generated columns (price-and-branch).
+********************************************************************************************/
+class ColumnGeneration
+{
+	private:
+		/*** Cplex features ***/
+		const IloEnv&   env;    /**< IBM environment **/
+	 	IloModel        model;  /**< IBM Model **/
+		IloCplex        cplex;  /**< IBM Cplex **/
+
+		/*** Formulation specific ***/
+		const Data&     data;   		/**< Data read in data.hpp **/
+		IloObjective    obj;            /**< Objective function **/
+		double 			slackPenalty; 	/**< Cost of a unit of availability slack. **/
+
+		/*** Master rows ***/
+		IloRangeArray 	availRow; 		/**< availRow[k] enforces the availability of demand k. **/
+		IloRangeArray 	maxPathsRow; 	/**< maxPathsRow[k] bounds the number of chains of demand k. **/
+		IloRangeArray 	nodeCapRow; 	/**< nodeCapRow[v] enforces the capacity of node v. **/
+		IloRangeArray 	arcCapRow; 		/**< arcCapRow[a] enforces the capacity of arc a. **/
+		std::vector<IloRangeArray> 		disjointRow; 	/**< disjointRow[k][v] forbids node v from hosting VNFs of two chains of demand k. **/
+		std::vector<std::vector<IloRangeArray> > linkRow; 	/**< linkRow[k][v][i] links the chains placing the i-th VNF of demand k on v to z. **/
+
+		/*** Master variables ***/
+		IloNumVarMatrix 				z;          /**< VNF global placement variables **/
+		IloNumVarArray 					slack; 		/**< slack[k] is the availability shortfall of demand k. **/
+		IloNumVarMatrix 				lambda; 	/**< lambda[k][c] selects the c-th chain of demand k. **/
+		IloNumVarArray 					allLambda; 	/**< Every chain variable. **/
+		std::vector<std::vector<ChainPath> > columns; /**< columns[k][c] is the c-th chain of demand k. **/
+
+		/*** Manage execution and control ***/
+		IloNum 			time;
+		int 			nbIterations; 	/**< Number of master LP solved. **/
+		double 			lpBound; 		/**< Value of the last master LP. **/
+		bool 			exact; 			/**< False if the last pricing round was truncated, in which case the LP value is not a lower bound. **/
+
+	public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+		/** Constructor. Builds the master with no chain. **/
+		ColumnGeneration(const IloEnv& env, const Data& data);
+		ColumnGeneration(const IloEnv& env, const Data&&) = delete;
+		ColumnGeneration() = delete;
+
+	/****************************************************************************************/
+	/*									    Formulation  									*/
+	/****************************************************************************************/
+		/** Set up the z and slack variables, the objective function and the master rows. **/
+		void setMaster();
+
+		/** Adds a chain of a given demand to the master. @param k The demand id. @param path The chain. **/
+		void addColumn(const int k, const ChainPath& path);
+
+		/** Seeds the master with the chains built by the constructive heuristic. **/
+		void setInitialColumns();
+
+		/** Builds the reduced cost components of a demand from the master duals. @param k The demand id. **/
+		PricingCosts getPricingCosts(const int k) const;
+
+	/****************************************************************************************/
+	/*										   Getters  									*/
+	/****************************************************************************************/
+		/** Returns the availability of a chain, that is, the product of the availabilities of its distinct hosts. **/
+		double getColumnAvailability(const ChainPath& path) const;
+		/** Returns the placement availability of a demand induced by the MIP solution. **/
+		double getPlacementAvailability(int k);
+		/** Returns the number of chains generated. **/
+		int getNbColumns() const { return allLambda.getSize(); }
+
+	/****************************************************************************************/
+	/*										   Methods  									*/
+	/****************************************************************************************/
+		/** Solves the master LP by column generation, then the master MIP over the generated chains. Throws an IloException if the master LP cannot be solved. **/
+		void run();
+
+		/** Displays the obtained results **/
+		void printResult();
+
+		/** Outputs the obtained results **/
+		void output();
+
+		/** Limits the number of threads CPLEX uses to solve the master. @param nbThreads The number of threads. **/
+		void setThreads(const int nbThreads) { cplex.setParam(IloCplex::Param::Threads, nbThreads); }
+
+		/** Frees the CPLEX problem and the master model, so that the environment can host the next one. **/
+		void end() { cplex.end(); model.end(); }
+
+	/****************************************************************************************/
+	/*										Destructors 									*/
+	/****************************************************************************************/
+		/** Destructor. **/
+		~ColumnGeneration() {}
+};
+
+#endif
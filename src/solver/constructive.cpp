@@ -0,0 +1,362 @@
+#include "constructive.hpp"
+
+/****************************************************************************************/
+/*										CONSTRUCTOR										*/
+/****************************************************************************************/
+
+Constructive::Constructive(const Data& data_) : data(data_)
+{
+    lemonNode.resize(data.getNbNodes(), lemon::INVALID);
+    residualNodeCapacity.resize(data.getNbNodes());
+    for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
+        int v = data.getNodeId(n);
+        lemonNode[v] = n;
+        residualNodeCapacity[v] = data.getNode(v).getCapacity();
+    }
+    residualArcCapacity.resize(data.getLinks().size());
+    for (ArcIt it(data.getGraph()); it != lemon::INVALID; ++it){
+        int a = data.getArcId(it);
+        residualArcCapacity[a] = data.getLink(a).getBandwidth();
+    }
+    paths.resize(data.getNbDemands());
+}
+
+/****************************************************************************************/
+/*									MAIN OPERATIONS        								*/
+/****************************************************************************************/
+
+/* Builds a solution for every demand. */
+bool Constructive::run()
+{
+    /* Most demanding SFCs first, while most available nodes are still free. */
+    std::vector<double> requiredAvail(data.getNbDemands());
+    for (int k = 0; k < data.getNbDemands(); k++){
+        requiredAvail[k] = data.getDemand(k).getAvailability();
+    }
+    std::vector<int> order = getSortedIndexes_Desc(requiredAvail);
+    for (unsigned int j = 0; j < order.size(); j++){
+        if (!buildDemand(order[j])){
+            std::cout << "\t Constructive heuristic failed on demand " << order[j] << "." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Builds the paths of a given demand and reserves the capacities they use. */
+bool Constructive::buildDemand(const int k)
+{
+    const double REQUIRED_AVAIL = data.getDemand(k).getAvailability();
+    const int    NB_PATHS       = data.getNbPaths(k);
+    int          MIN_NB_PATHS   = 1;
+    if (data.getInput().getNbPathsLowerBound() == Input::NB_PATHS_LOWER_BOUND_ON){
+        MIN_NB_PATHS = data.getMinNbNodes(REQUIRED_AVAIL);
+    }
+
+    releaseDemand(k);
+    /* A removed demand is served by no path. */
+    if (data.isDemandRemoved(k)){
+        return true;
+    }
+    /* Parallel paths cannot share hosts. */
+    std::vector<bool> forbidden(data.getNbNodes(), false);
+    while ((getPlacementAvailability(k) < REQUIRED_AVAIL || (int)paths[k].size() < MIN_NB_PATHS) && (int)paths[k].size() < NB_PATHS){
+        ChainPath path;
+        if (!buildPath(k, forbidden, path)){
+            break;
+        }
+        reservePath(k, path);
+        paths[k].push_back(path);
+        for (unsigned int i = 0; i < path.hosts.size(); i++){
+            forbidden[path.hosts[i]] = true;
+        }
+    }
+
+    if (getPlacementAvailability(k) < REQUIRED_AVAIL || (int)paths[k].size() < MIN_NB_PATHS){
+        releaseDemand(k);
+        return false;
+    }
+    return true;
+}
+
+/* Sets prescribed paths for a given demand and reserves the capacities they use. */
+bool Constructive::fixDemand(const int k, const std::vector<ChainPath>& chains)
+{
+    releaseDemand(k);
+    for (unsigned int p = 0; p < chains.size(); p++){
+        reservePath(k, chains[p]);
+        paths[k].push_back(chains[p]);
+    }
+
+    bool fits = (!chains.empty() && getPlacementAvailability(k) >= data.getDemand(k).getAvailability());
+    for (unsigned int v = 0; v < residualNodeCapacity.size() && fits; v++){
+        fits = (residualNodeCapacity[v] >= -1e-6);
+    }
+    for (unsigned int a = 0; a < residualArcCapacity.size() && fits; a++){
+        fits = (residualArcCapacity[a] >= -1e-6);
+    }
+    if (!fits){
+        releaseDemand(k);
+    }
+    return fits;
+}
+
+/* Routes the sections of prescribed paths for a given demand and reserves the capacities they use. */
+bool Constructive::reserveDemand(const int k, std::vector<ChainPath>& chains)
+{
+    releaseDemand(k);
+    for (unsigned int p = 0; p < chains.size(); p++){
+        if (!routePath(k, chains[p])){
+            releaseDemand(k);
+            return false;
+        }
+        reservePath(k, chains[p]);
+        paths[k].push_back(chains[p]);
+    }
+    return true;
+}
+
+/* Repairs prescribed paths of a given demand that miss the required availability. */
+bool Constructive::repairDemand(const int k, const std::vector<ChainPath>& chains)
+{
+    const std::vector<int>& rank = data.getAvailNodeRank();
+    std::vector<bool> used(data.getNbNodes(), false);
+    for (unsigned int p = 0; p < chains.size(); p++){
+        for (unsigned int i = 0; i < chains[p].hosts.size(); i++){
+            used[chains[p].hosts[i]] = true;
+        }
+    }
+
+    std::vector<ChainPath> best;
+    double bestCost = 0.0;
+    /* A repair is kept if it is routed, fits the capacities, meets the requirement and is the cheapest so far. */
+    auto consider = [&](std::vector<ChainPath>& trial){
+        if (!reserveDemand(k, trial)){
+            return;
+        }
+        std::vector<ChainPath> routed = paths[k];
+        if (fixDemand(k, routed)){
+            const double COST = getCost();
+            if (best.empty() || COST < bestCost){
+                best = routed;
+                bestCost = COST;
+            }
+        }
+        releaseDemand(k);
+    };
+
+    /* Move one VNF to a more available node not used by the demand, parallel paths staying node-disjoint. */
+    for (unsigned int p = 0; p < chains.size(); p++){
+        for (unsigned int i = 0; i < chains[p].hosts.size(); i++){
+            const double HOST_AVAIL = data.getNode(chains[p].hosts[i]).getAvailability();
+            for (unsigned int r = 0; r < rank.size() && data.getNode(rank[r]).getAvailability() > HOST_AVAIL; r++){
+                if (used[rank[r]]){
+                    continue;
+                }
+                std::vector<ChainPath> trial = chains;
+                trial[p].hosts[i] = rank[r];
+                consider(trial);
+            }
+        }
+    }
+
+    /* Add one parallel path on nodes not used by the demand. */
+    if ((int)chains.size() < data.getNbPaths(k)){
+        std::vector<ChainPath> trial = chains;
+        if (reserveDemand(k, trial)){
+            ChainPath path;
+            const bool BUILT = buildPath(k, used, path);
+            releaseDemand(k);
+            if (BUILT){
+                trial.push_back(path);
+                consider(trial);
+            }
+        }
+    }
+
+    if (best.empty()){
+        return false;
+    }
+    return fixDemand(k, best);
+}
+
+/* Releases the capacities used by a given demand and forgets its paths. */
+void Constructive::releaseDemand(const int k)
+{
+    for (unsigned int p = 0; p < paths[k].size(); p++){
+        reservePath(k, paths[k][p], -1.0);
+    }
+    paths[k].clear();
+}
+
+/* Builds a path for a given demand whose hosts are not in a forbidden set. */
+bool Constructive::buildPath(const int k, const std::vector<bool>& forbidden, ChainPath& path) const
+{
+    const Demand&           demand    = data.getDemand(k);
+    const int               NB_VNFS   = demand.getNbVNFs();
+    const double            BANDWIDTH = demand.getBandwidth();
+    const std::vector<int>& rank      = data.getAvailNodeRank();
+
+    /* Each candidate primary node, most available first, hosts as many VNFs as it can. Remaining VNFs go to the most available nodes still having capacity. */
+    for (unsigned int r = 0; r < rank.size(); r++){
+        const int primary = rank[r];
+        if (forbidden[primary]){
+            continue;
+        }
+        std::vector<double> nodeCapacity = residualNodeCapacity;
+        path.hosts.assign(NB_VNFS, -1);
+        bool placed = true;
+        for (int i = 0; i < NB_VNFS && placed; i++){
+            const double LOAD = BANDWIDTH * data.getVnf(demand.getVNF_i(i)).getConsumption();
+            int host = (i == 0) ? primary : path.hosts[i-1];
+            if (nodeCapacity[host] < LOAD){
+                host = -1;
+                if (i > 0){
+                    for (unsigned int s = 0; s < rank.size() && host == -1; s++){
+                        if (!forbidden[rank[s]] && nodeCapacity[rank[s]] >= LOAD){
+                            host = rank[s];
+                        }
+                    }
+                }
+            }
+            if (host == -1){
+                placed = false;
+            }
+            else {
+                path.hosts[i] = host;
+                nodeCapacity[host] -= LOAD;
+            }
+        }
+        if (placed && routePath(k, path)){
+            return true;
+        }
+    }
+    path.hosts.clear();
+    path.sections.clear();
+    return false;
+}
+
+/* Routes the sections of a path of a given demand, one after the other, among arcs with enough residual bandwidth. */
+bool Constructive::routePath(const int k, ChainPath& path) const
+{
+    const Demand& demand    = data.getDemand(k);
+    const int     NB_VNFS   = demand.getNbVNFs();
+    const double  BANDWIDTH = demand.getBandwidth();
+
+    /* The bandwidth of a section is unavailable for the next ones. */
+    std::vector<double> arcCapacity = residualArcCapacity;
+    path.sections.assign(NB_VNFS + 1, std::vector<int>());
+    double latency = 0.0;
+    for (int i = 0; i <= NB_VNFS; i++){
+        const int source = (i == 0) ? demand.getSource() : path.hosts[i-1];
+        const int target = (i == NB_VNFS) ? demand.getTarget() : path.hosts[i];
+        double delay = 0.0;
+        if (!routeSection(source, target, BANDWIDTH, arcCapacity, path.sections[i], delay)){
+            return false;
+        }
+        latency += delay;
+        for (unsigned int j = 0; j < path.sections[i].size(); j++){
+            arcCapacity[path.sections[i][j]] -= BANDWIDTH;
+        }
+    }
+    return (latency <= demand.getMaxLatency());
+}
+
+/* Routes a section through a delay shortest path among arcs with enough residual bandwidth. */
+bool Constructive::routeSection(const int source, const int target, const double bandwidth, const std::vector<double>& arcCapacity, std::vector<int>& arcs, double& delay) const
+{
+    arcs.clear();
+    delay = 0.0;
+    if (source == target){
+        return true;
+    }
+
+    /* Saturated arcs cost more than any path made of unsaturated arcs. */
+    double blocked = 1.0;
+    for (ArcIt it(data.getGraph()); it != lemon::INVALID; ++it){
+        blocked += data.getLink(data.getArcId(it)).getDelay();
+    }
+    DelayMap cost(data.getGraph());
+    for (ArcIt it(data.getGraph()); it != lemon::INVALID; ++it){
+        int a = data.getArcId(it);
+        cost[it] = data.getLink(a).getDelay();
+        if (arcCapacity[a] < bandwidth){
+            cost[it] += blocked;
+        }
+    }
+
+    lemon::Dijkstra<Graph, DelayMap> shortestPath(data.getGraph(), cost);
+    shortestPath.run(lemonNode[source]);
+    if (!shortestPath.reached(lemonNode[target]) || shortestPath.dist(lemonNode[target]) >= blocked){
+        return false;
+    }
+    for (Graph::Node n = lemonNode[target]; n != lemonNode[source]; n = data.getGraph().source(shortestPath.predArc(n))){
+        int a = data.getArcId(shortestPath.predArc(n));
+        arcs.push_back(a);
+        delay += data.getLink(a).getDelay();
+    }
+    std::reverse(arcs.begin(), arcs.end());
+    return true;
+}
+
+/* Reserves the node and arc capacities used by a path of a given demand. */
+void Constructive::reservePath(const int k, const ChainPath& path, const double sign)
+{
+    const Demand& demand    = data.getDemand(k);
+    const double  BANDWIDTH = demand.getBandwidth();
+    for (unsigned int i = 0; i < path.hosts.size(); i++){
+        residualNodeCapacity[path.hosts[i]] -= sign * BANDWIDTH * data.getVnf(demand.getVNF_i(i)).getConsumption();
+    }
+    for (unsigned int i = 0; i < path.sections.size(); i++){
+        for (unsigned int j = 0; j < path.sections[i].size(); j++){
+            residualArcCapacity[path.sections[i][j]] -= sign * BANDWIDTH;
+        }
+    }
+}
+
+/****************************************************************************************/
+/*									QUERY METHODS        								*/
+/****************************************************************************************/
+
+/* Returns the availability of a path, that is, the product of the availabilities of its distinct hosts. */
+const double Constructive::getPathAvailability(const ChainPath& path) const
+{
+    std::vector<int> hosts = path.hosts;
+    std::sort(hosts.begin(), hosts.end());
+    hosts.erase(std::unique(hosts.begin(), hosts.end()), hosts.end());
+    double availability = 1.0;
+    for (unsigned int i = 0; i < hosts.size(); i++){
+        availability *= data.getNode(hosts[i]).getAvailability();
+    }
+    return availability;
+}
+
+/* Returns the availability of the paths built for a given demand. */
+const double Constructive::getPlacementAvailability(const int k) const
+{
+    double prob_all_paths_fail = 1.0;
+    for (unsigned int p = 0; p < paths[k].size(); p++){
+        prob_all_paths_fail *= (1.0 - getPathAvailability(paths[k][p]));
+    }
+    return (1.0 - prob_all_paths_fail);
+}
+
+/* Returns the placement cost of the solution built so far. */
+const double Constructive::getCost() const
+{
+    std::vector<std::vector<bool> > placed(data.getNbNodes(), std::vector<bool>(data.getNbVnfs(), false));
+    double cost = 0.0;
+    for (unsigned int k = 0; k < paths.size(); k++){
+        for (unsigned int p = 0; p < paths[k].size(); p++){
+            for (unsigned int i = 0; i < paths[k][p].hosts.size(); i++){
+                int v = paths[k][p].hosts[i];
+                int f = data.getDemand(k).getVNF_i(i);
+                if (!placed[v][f]){
+                    placed[v][f] = true;
+                    cost += data.getPlacementCost(data.getNode(v), data.getVnf(f));
+                }
+            }
+        }
+    }
+    return cost;
+}
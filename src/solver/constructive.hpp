@@ -0,0 +1,113 @@
+#ifndef __constructive__hpp
+#define __constructive__hpp
+
+/****************************************************************************************/
+/*										LIBRARIES										*/
+/****************************************************************************************/
+
+/*** C++ Libraries ***/
+#include <vector>
+
+/*** LEMON Libraries ***/
+#include <lemon/dijkstra.h>
+
+/*** Own Libraries ***/
+#include "../instance/data.hpp"
+#include "../tools/others.hpp"
+
+/****************************************************************************************/
+/*										TYPEDEFS										*/
+/****************************************************************************************/
+
+/*** LEMON ***/
+typedef Graph::ArcMap<double> DelayMap;
+
+/********************************************************************************************
+ * A placed and routed path of an SFC demand: the node hosting each of its VNFs and the
+ * ordered list of arcs routing each of its sections.
+********************************************************************************************/
+struct ChainPath {
+	std::vector<int> 				hosts; 		/**< hosts[i] is the id of the node hosting the i-th VNF. **/
+	std::vector<std::vector<int> > 	sections; 	/**< sections[i] is the ordered list of arc ids routing the i-th section. **/
+};
+
+/********************************************************************************************
+ * This class implements a greedy availability-aware constructive heuristic. Demands are
+ * treated one at a time, in decreasing order of required availability. VNFs are placed on
+ * the most available nodes with enough residual capacity and sections are routed through
+ * delay shortest paths among arcs with enough residual bandwidth. Node-disjoint parallel
+ * paths are added until the required availability is met.
+********************************************************************************************/
+class Constructive {
+
+private:
+	const Data& 					data; 					/**< Data read in data.hpp **/
+	std::vector<Graph::Node> 		lemonNode; 				/**< The lemon node associated with each node id. **/
+	std::vector<double> 			residualNodeCapacity; 	/**< The capacity still available on each node. **/
+	std::vector<double> 			residualArcCapacity; 	/**< The bandwidth still available on each arc. **/
+	std::vector<std::vector<ChainPath> > paths; 			/**< The paths built for each demand. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. Initializes the residual capacities with the network capacities. @param data The instance data. **/
+	Constructive(const Data& data);
+
+	/****************************************************************************************/
+	/*									Main operations  									*/
+	/****************************************************************************************/
+	/** Builds a solution for every demand. Returns true if all demands could be placed and routed. **/
+	bool run();
+
+	/** Builds the paths of a given demand and reserves the capacities they use. Returns false, and reserves nothing, if the required availability cannot be met. @param k The demand id. **/
+	bool buildDemand(const int k);
+
+	/** Sets prescribed paths for a given demand and reserves the capacities they use. Returns false, and reserves nothing, if they exceed residual capacities or miss the required availability. @param k The demand id. @param chains The paths to be set. **/
+	bool fixDemand(const int k, const std::vector<ChainPath>& chains);
+
+	/** Routes the sections of prescribed paths for a given demand and reserves the capacities they use. Returns false, and reserves nothing, if a path cannot be routed within residual capacities and latency. Node capacities and availability are not checked. @param k The demand id. @param chains The paths to be set, whose sections are overwritten. **/
+	bool reserveDemand(const int k, std::vector<ChainPath>& chains);
+
+	/** Repairs prescribed paths of a given demand that miss the required availability, either by moving one VNF to a more available node or by adding a parallel path. The cheapest repair is kept and its capacities reserved. Returns false, and reserves nothing, if no move meets the requirement within capacities and latency. @param k The demand id. @param chains The paths to be repaired, only their hosts being read. **/
+	bool repairDemand(const int k, const std::vector<ChainPath>& chains);
+
+	/** Releases the capacities used by a given demand and forgets its paths. @param k The demand id. **/
+	void releaseDemand(const int k);
+
+	/** Builds a path for a given demand whose hosts are not in a forbidden set. Returns false if no path respects capacities and latency. @param k The demand id. @param forbidden The nodes that cannot host a VNF. @param path The path built. **/
+	bool buildPath(const int k, const std::vector<bool>& forbidden, ChainPath& path) const;
+
+	/** Routes the sections of a path of a given demand, one after the other, among arcs with enough residual bandwidth. Returns false if a section cannot be routed or the latency limit is exceeded. @param k The demand id. @param path The path, whose hosts are set and whose sections are overwritten. **/
+	bool routePath(const int k, ChainPath& path) const;
+
+	/** Routes a section through a delay shortest path among arcs with enough residual bandwidth. Returns false if the target cannot be reached. @param source The section source node id. @param target The section target node id. @param bandwidth The bandwidth to be routed. @param arcCapacity The residual arc capacities to be respected. @param arcs The ordered list of arcs used. @param delay The delay of the route found. **/
+	bool routeSection(const int source, const int target, const double bandwidth, const std::vector<double>& arcCapacity, std::vector<int>& arcs, double& delay) const;
+
+	/** Reserves the node and arc capacities used by a path of a given demand. @param k The demand id. @param path The path to be reserved. @param sign 1 to reserve, -1 to release. **/
+	void reservePath(const int k, const ChainPath& path, const double sign = 1.0);
+
+	/****************************************************************************************/
+	/*								      Query Methods	    	    	    				*/
+	/****************************************************************************************/
+	/** Returns the paths built for a given demand. **/
+	const std::vector<ChainPath>& getPaths(const int k) const { return paths[k]; }
+	/** Returns the residual capacity of a given node. **/
+	const double getResidualNodeCapacity(const int v) const { return residualNodeCapacity[v]; }
+	/** Returns the residual bandwidth of a given arc. **/
+	const double getResidualArcCapacity(const int a) const { return residualArcCapacity[a]; }
+	/** Returns the availability of a path, that is, the product of the availabilities of its distinct hosts. **/
+	const double getPathAvailability(const ChainPath& path) const;
+	/** Returns the availability of the paths built for a given demand. **/
+	const double getPlacementAvailability(const int k) const;
+	/** Returns the placement cost of the solution built so far. **/
+	const double getCost() const;
+
+	/****************************************************************************************/
+	/*										Destructors			    						*/
+	/****************************************************************************************/
+	/** Destructor **/
+	~Constructive() {}
+};
+
+#endif
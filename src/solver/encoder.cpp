@@ -0,0 +1,197 @@
+#include "encoder.hpp"
+
+/* Returns the value at x of the piecewise linear function given as the IloPiecewiseLinear arguments. */
+static double evaluate(const IloNumArray& breakpoints, const IloNumArray& slopes, const double anchorX, const double anchorY, const double x)
+{
+    const double LO = std::min(anchorX, x);
+    const double HI = std::max(anchorX, x);
+    const int NB_BREAKPOINTS = (int)breakpoints.getSize();
+    double integral = 0.0;
+    for (int s = 0; s <= NB_BREAKPOINTS; s++){
+        const double SEG_LO = (s == 0) ? LO : std::max(LO, (double)breakpoints[s-1]);
+        const double SEG_HI = (s == NB_BREAKPOINTS) ? HI : std::min(HI, (double)breakpoints[s]);
+        if (SEG_HI > SEG_LO){
+            integral += slopes[s] * (SEG_HI - SEG_LO);
+        }
+    }
+    return (x >= anchorX) ? anchorY + integral : anchorY - integral;
+}
+
+/****************************************************************************************/
+/*										CONSTRUCTOR										*/
+/****************************************************************************************/
+
+Encoder::Encoder(const IloEnv& env_, const Input::Pwl_Encoding encoding_, const IloNumArray& breakpoints, const IloNumArray& slopes, const double anchorX, const double anchorY, const double lb, const double ub) : env(env_), encoding(encoding_)
+{
+    vertexX.push_back(lb);
+    for (int i = 0; i < breakpoints.getSize(); i++){
+        if (breakpoints[i] > vertexX.back() && breakpoints[i] < ub){
+            vertexX.push_back(breakpoints[i]);
+        }
+    }
+    vertexX.push_back(ub);
+    for (unsigned int j = 0; j < vertexX.size(); j++){
+        vertexY.push_back(evaluate(breakpoints, slopes, anchorX, anchorY, vertexX[j]));
+    }
+}
+
+/****************************************************************************************/
+/*									MAIN OPERATIONS        								*/
+/****************************************************************************************/
+
+/* Adds the rows encoding y = f(x). */
+void Encoder::encode(const IloNumVar& x, const IloNumVar& y, const std::string& name, IloExtractableArray& rows) const
+{
+    switch (encoding){
+        case Input::PWL_ENCODING_SOS2:
+            encodeSOS2(x, y, name, rows);
+            break;
+        case Input::PWL_ENCODING_INCREMENTAL:
+            encodeIncremental(x, y, name, rows);
+            break;
+        case Input::PWL_ENCODING_LOGARITHMIC:
+            encodeLogarithmic(x, y, name, rows);
+            break;
+        default:
+            throw IloCplex::Exception(-1, "ERROR: Unexpected piecewise encoding !");
+    }
+}
+
+/* Adds the convex combination rows and an SOS2 constraint on the vertex weights. */
+void Encoder::encodeSOS2(const IloNumVar& x, const IloNumVar& y, const std::string& name, IloExtractableArray& rows) const
+{
+    const int NB_VERTICES = (int)vertexX.size();
+    IloNumVarArray lambda(env);
+    IloNumArray weights(env);
+    IloExpr sum(env);
+    IloExpr expX(env);
+    IloExpr expY(env);
+    expX -= x;
+    expY -= y;
+    for (int j = 0; j < NB_VERTICES; j++){
+        std::string varName = name + "_lambda(" + std::to_string(j) + ")";
+        lambda.add(IloNumVar(env, 0.0, 1.0, ILOFLOAT, varName.c_str()));
+        weights.add(j + 1);
+        sum += lambda[j];
+        expX += vertexX[j] * lambda[j];
+        expY += vertexY[j] * lambda[j];
+    }
+    rows.add(IloRange(env, 1, sum, 1, (name + "_convexity").c_str()));
+    rows.add(IloRange(env, 0, expX, 0, (name + "_x").c_str()));
+    rows.add(IloRange(env, 0, expY, 0, (name + "_y").c_str()));
+    rows.add(IloSOS2(env, lambda, weights, (name + "_sos2").c_str()));
+    sum.end();
+    expX.end();
+    expY.end();
+}
+
+/* Adds the segment fill ratios, each segment being used only if the previous one is full. */
+void Encoder::encodeIncremental(const IloNumVar& x, const IloNumVar& y, const std::string& name, IloExtractableArray& rows) const
+{
+    const int NB_SEGMENTS = getNbSegments();
+    IloNumVarArray delta(env);
+    IloExpr expX(env);
+    IloExpr expY(env);
+    expX -= x;
+    expY -= y;
+    for (int s = 0; s < NB_SEGMENTS; s++){
+        std::string varName = name + "_delta(" + std::to_string(s) + ")";
+        delta.add(IloNumVar(env, 0.0, 1.0, ILOFLOAT, varName.c_str()));
+        expX += (vertexX[s+1] - vertexX[s]) * delta[s];
+        expY += (vertexY[s+1] - vertexY[s]) * delta[s];
+    }
+    rows.add(IloRange(env, -vertexX[0], expX, -vertexX[0], (name + "_x").c_str()));
+    rows.add(IloRange(env, -vertexY[0], expY, -vertexY[0], (name + "_y").c_str()));
+
+    /* delta[s+1] <= w[s] <= delta[s] */
+    for (int s = 0; s < NB_SEGMENTS - 1; s++){
+        std::string varName = name + "_w(" + std::to_string(s) + ")";
+        IloNumVar w(env, 0.0, 1.0, ILOINT, varName.c_str());
+        rows.add(IloRange(env, 0, w - delta[s+1], IloInfinity, (name + "_fill(" + std::to_string(s) + ")").c_str()));
+        rows.add(IloRange(env, 0, delta[s] - w, IloInfinity, (name + "_order(" + std::to_string(s) + ")").c_str()));
+    }
+    expX.end();
+    expY.end();
+}
+
+/* Adds the convex combination rows and the Gray code selecting the active segment. Vertex j only gets weight if one of its adjacent segments j-1 and j agrees with the binaries. */
+void Encoder::encodeLogarithmic(const IloNumVar& x, const IloNumVar& y, const std::string& name, IloExtractableArray& rows) const
+{
+    const int NB_VERTICES = (int)vertexX.size();
+    const int NB_SEGMENTS = getNbSegments();
+    const int NB_BITS = getNbBinaries();
+    IloNumVarArray lambda(env);
+    IloExpr sum(env);
+    IloExpr expX(env);
+    IloExpr expY(env);
+    expX -= x;
+    expY -= y;
+    for (int j = 0; j < NB_VERTICES; j++){
+        std::string varName = name + "_lambda(" + std::to_string(j) + ")";
+        lambda.add(IloNumVar(env, 0.0, 1.0, ILOFLOAT, varName.c_str()));
+        sum += lambda[j];
+        expX += vertexX[j] * lambda[j];
+        expY += vertexY[j] * lambda[j];
+    }
+    rows.add(IloRange(env, 1, sum, 1, (name + "_convexity").c_str()));
+    rows.add(IloRange(env, 0, expX, 0, (name + "_x").c_str()));
+    rows.add(IloRange(env, 0, expY, 0, (name + "_y").c_str()));
+
+    for (int l = 0; l < NB_BITS; l++){
+        std::string varName = name + "_b(" + std::to_string(l) + ")";
+        IloNumVar b(env, 0.0, 1.0, ILOINT, varName.c_str());
+        IloExpr ones(env);
+        IloExpr zeros(env);
+        for (int j = 0; j < NB_VERTICES; j++){
+            bool allOnes = true;
+            bool allZeros = true;
+            for (int s = std::max(0, j - 1); s <= std::min(j, NB_SEGMENTS - 1); s++){
+                const int GRAY = s ^ (s >> 1);
+                if ((GRAY >> l) & 1){
+                    allZeros = false;
+                }
+                else{
+                    allOnes = false;
+                }
+            }
+            if (allOnes){
+                ones += lambda[j];
+            }
+            if (allZeros){
+                zeros += lambda[j];
+            }
+        }
+        ones -= b;
+        zeros += b;
+        rows.add(IloRange(env, -IloInfinity, ones, 0, (name + "_one(" + std::to_string(l) + ")").c_str()));
+        rows.add(IloRange(env, -IloInfinity, zeros, 1, (name + "_zero(" + std::to_string(l) + ")").c_str()));
+        ones.end();
+        zeros.end();
+    }
+    sum.end();
+    expX.end();
+    expY.end();
+}
+
+/****************************************************************************************/
+/*									QUERY METHODS        								*/
+/****************************************************************************************/
+
+/* Returns the number of binaries the chosen encoding adds per encoded equality. */
+const int Encoder::getNbBinaries() const
+{
+    const int NB_SEGMENTS = getNbSegments();
+    switch (encoding){
+        case Input::PWL_ENCODING_INCREMENTAL:
+            return NB_SEGMENTS - 1;
+        case Input::PWL_ENCODING_LOGARITHMIC:{
+            int nbBits = 0;
+            while ((1 << nbBits) < NB_SEGMENTS){
+                nbBits++;
+            }
+            return nbBits;
+        }
+        default:
+            return 0;
+    }
+}
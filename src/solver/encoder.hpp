@@ -0,0 +1,77 @@
+#ifndef __encoder__hpp
+#define __encoder__hpp
+
+/****************************************************************************************/
+/*										LIBRARIES										*/
+/****************************************************************************************/
+
+/*** C++ Libraries ***/
+#include <vector>
+#include <string>
+
+/*** CPLEX Libraries ***/
+#include <ilcplex/ilocplex.h>
+ILOSTLBEGIN
+
+/*** Own Libraries ***/
+#include "../instance/input.hpp"
+
+/********************************************************************************************
+ * This class encodes a piecewise linear equality y = f(x) into explicit MIP rows, instead of
+ * leaving the choice to CPLEX through IloPiecewiseLinear. The function is given as the
+ * IloPiecewiseLinear arguments (breakpoints, slopes and an anchor point) and is restricted
+ * to the domain of x, so that every encoding is built from the same vertices. Three
+ * encodings are available:
+ *  - SOS2: one weight per vertex, adjacent weights only, enforced by an SOS2 constraint.
+ *  - INCREMENTAL: one fill ratio per segment, segments filled in order, one binary per
+ *    segment but the last.
+ *  - LOGARITHMIC: one weight per vertex, the active segment being selected through a Gray
+ *    code on ceil(log2(#segments)) binaries (Vielma and Nemhauser).
+********************************************************************************************/
+class Encoder {
+
+private:
+	IloEnv 					env; 			/**< The environment the rows are built in. **/
+	Input::Pwl_Encoding 	encoding; 		/**< The encoding used. **/
+	std::vector<double> 	vertexX; 		/**< vertexX[j] is the abscissa of the j-th vertex, increasing. **/
+	std::vector<double> 	vertexY; 		/**< vertexY[j] is the function value at vertexX[j]. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. Computes the vertices of the function over a domain. @param env The environment. @param encoding The encoding used. @param breakpoints The points where the slope changes. @param slopes The slopes, one more than breakpoints. @param anchorX The abscissa of a known point. @param anchorY The function value at anchorX. @param lb The lower bound of the domain. @param ub The upper bound of the domain. **/
+	Encoder(const IloEnv& env, const Input::Pwl_Encoding encoding, const IloNumArray& breakpoints, const IloNumArray& slopes, const double anchorX, const double anchorY, const double lb, const double ub);
+
+	/****************************************************************************************/
+	/*									Main operations  									*/
+	/****************************************************************************************/
+	/** Adds the rows encoding y = f(x). @param x The argument variable. @param y The value variable. @param name The prefix of the row names. @param rows The array receiving the rows. **/
+	void encode(const IloNumVar& x, const IloNumVar& y, const std::string& name, IloExtractableArray& rows) const;
+
+	/** Adds the convex combination rows and an SOS2 constraint on the vertex weights. **/
+	void encodeSOS2(const IloNumVar& x, const IloNumVar& y, const std::string& name, IloExtractableArray& rows) const;
+
+	/** Adds the segment fill ratios, each segment being used only if the previous one is full. **/
+	void encodeIncremental(const IloNumVar& x, const IloNumVar& y, const std::string& name, IloExtractableArray& rows) const;
+
+	/** Adds the convex combination rows and the Gray code selecting the active segment. **/
+	void encodeLogarithmic(const IloNumVar& x, const IloNumVar& y, const std::string& name, IloExtractableArray& rows) const;
+
+	/****************************************************************************************/
+	/*								      Query Methods	    	    	    				*/
+	/****************************************************************************************/
+	/** Returns the number of segments of the function over the domain. **/
+	const int getNbSegments() const { return (int)vertexX.size() - 1; }
+
+	/** Returns the number of binaries the chosen encoding adds per encoded equality. **/
+	const int getNbBinaries() const;
+
+	/****************************************************************************************/
+	/*										Destructors			    						*/
+	/****************************************************************************************/
+	/** Destructor **/
+	~Encoder() {}
+};
+
+#endif
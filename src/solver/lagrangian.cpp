@@ -0,0 +1,316 @@
+#include "lagrangian.hpp"
+
+/* Constructor */
+Lagrangian::Lagrangian(const Data& data_, const int nbThreads) : data(data_), lowerBound(0.0), upperBound(IloInfinity), nbIterations(0), time(0.0)
+{
+    const int NB_DEMANDS = data.getNbDemands();
+    const int NB_NODES   = data.getNbNodes();
+    const int NB_VNFS    = data.getNbVnfs();
+
+    std::cout << "=> Building Lagrangian subproblems ... " << std::endl;
+    const int NB_THREADS = (nbThreads > 0 ? nbThreads : (int)std::thread::hardware_concurrency());
+    nbWorkers = std::max(1, std::min(NB_THREADS, NB_DEMANDS));
+    subEnv.resize(nbWorkers);
+    for (int k = 0; k < NB_DEMANDS; k++){
+        subData.push_back(new Data(data, std::vector<int>(1, k)));
+        subModel.push_back(new Model(subEnv[k % nbWorkers], *subData[k]));
+        /* Subproblems already run in parallel: a separation pool per model would oversubscribe the cores. */
+        subModel[k]->setSeparationThreads(1);
+    }
+
+    /* Start with the placement cost shared evenly among the demands requesting each VNF. */
+    std::vector<int> nbRequests(NB_VNFS, 0);
+    for (int k = 0; k < NB_DEMANDS; k++){
+        const std::vector<int>& vnfs = data.getDemand(k).getListOfVNFs();
+        for (int f = 0; f < NB_VNFS; f++){
+            if (std::find(vnfs.begin(), vnfs.end(), f) != vnfs.end()){
+                nbRequests[f]++;
+            }
+        }
+    }
+    nodePrice.assign(NB_NODES, 0.0);
+    arcPrice.assign(data.getLinks().size(), 0.0);
+    placementPrice.assign(NB_DEMANDS, IloNumMatrix(NB_NODES, IloNumVector(NB_VNFS, 0.0)));
+    for (int k = 0; k < NB_DEMANDS; k++){
+        const std::vector<int>& vnfs = data.getDemand(k).getListOfVNFs();
+        for (int v = 0; v < NB_NODES; v++){
+            for (int f = 0; f < NB_VNFS; f++){
+                if (std::find(vnfs.begin(), vnfs.end(), f) != vnfs.end()){
+                    placementPrice[k][v][f] = data.getPlacementCost(data.getNode(v), data.getVnf(f)) / nbRequests[f];
+                }
+            }
+        }
+    }
+    std::cout << "\t " << NB_DEMANDS << " subproblems were built for " << nbWorkers << " threads ! " << std::endl;
+}
+
+/****************************************************************************************/
+/*										   Methods  									*/
+/****************************************************************************************/
+
+/* Solves every subproblem in parallel and returns the Lagrangian bound of the current multipliers. */
+double Lagrangian::evaluate(std::vector<LagrangianSolution>& solutions, const double timeLimit)
+{
+    const int NB_DEMANDS = data.getNbDemands();
+
+    /* Thread w only touches the models living in subEnv[w], solved one after another within the time left. */
+    const std::chrono::steady_clock::time_point START = std::chrono::steady_clock::now();
+    auto work = [&](const int worker){
+        for (int k = worker; k < NB_DEMANDS; k += nbWorkers){
+            const int    NB_LEFT = (NB_DEMANDS - 1 - k) / nbWorkers + 1;
+            const double ELAPSED = std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count();
+            const double SHARE   = std::max(0.0, timeLimit - ELAPSED) / NB_LEFT;
+            subModel[k]->solveLagrangianSubproblem(nodePrice, arcPrice, placementPrice[k], SHARE, solutions[k]);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int w = 1; w < nbWorkers; w++){
+        workers.push_back(std::thread(work, w));
+    }
+    work(0);
+    for (unsigned int w = 0; w < workers.size(); w++){
+        workers[w].join();
+    }
+
+    double value = 0.0;
+    for (int k = 0; k < NB_DEMANDS; k++){
+        if (solutions[k].bound >= IloInfinity){
+            return IloInfinity;
+        }
+        value += solutions[k].bound;
+    }
+    /* z is only set to one where it is cheaper than the copies it covers. */
+    for (int v = 0; v < data.getNbNodes(); v++){
+        for (int f = 0; f < data.getNbVnfs(); f++){
+            double reducedCost = data.getPlacementCost(data.getNode(v), data.getVnf(f));
+            for (int k = 0; k < NB_DEMANDS; k++){
+                reducedCost -= placementPrice[k][v][f];
+            }
+            value += std::min(0.0, reducedCost);
+        }
+        value -= nodePrice[v] * data.getNode(v).getCapacity();
+    }
+    for (unsigned int a = 0; a < arcPrice.size(); a++){
+        value -= arcPrice[a] * data.getLink(a).getBandwidth();
+    }
+    return value;
+}
+
+/* Moves the multipliers along the subgradient given by the subproblem solutions. */
+void Lagrangian::updatePrices(const std::vector<LagrangianSolution>& solutions, const double value, const double step)
+{
+    const int NB_DEMANDS = data.getNbDemands();
+    const int NB_NODES   = data.getNbNodes();
+    const int NB_VNFS    = data.getNbVnfs();
+
+    /* Subgradient components, zeroed where the projection would cancel them. */
+    std::vector<double> nodeGrad(NB_NODES);
+    std::vector<double> arcGrad(arcPrice.size());
+    std::vector<IloNumMatrix> placementGrad(NB_DEMANDS, IloNumMatrix(NB_NODES, IloNumVector(NB_VNFS, 0.0)));
+    double norm = 0.0;
+    for (int v = 0; v < NB_NODES; v++){
+        nodeGrad[v] = -data.getNode(v).getCapacity();
+        for (int k = 0; k < NB_DEMANDS; k++){
+            nodeGrad[v] += solutions[k].nodeLoad[v];
+        }
+        if (nodePrice[v] <= 0.0 && nodeGrad[v] < 0.0){
+            nodeGrad[v] = 0.0;
+        }
+        norm += nodeGrad[v] * nodeGrad[v];
+    }
+    for (unsigned int a = 0; a < arcPrice.size(); a++){
+        arcGrad[a] = -data.getLink(a).getBandwidth();
+        for (int k = 0; k < NB_DEMANDS; k++){
+            arcGrad[a] += solutions[k].arcLoad[a];
+        }
+        if (arcPrice[a] <= 0.0 && arcGrad[a] < 0.0){
+            arcGrad[a] = 0.0;
+        }
+        norm += arcGrad[a] * arcGrad[a];
+    }
+    for (int v = 0; v < NB_NODES; v++){
+        for (int f = 0; f < NB_VNFS; f++){
+            double reducedCost = data.getPlacementCost(data.getNode(v), data.getVnf(f));
+            for (int k = 0; k < NB_DEMANDS; k++){
+                reducedCost -= placementPrice[k][v][f];
+            }
+            const double Z = (reducedCost < 0.0) ? 1.0 : 0.0;
+            for (int k = 0; k < NB_DEMANDS; k++){
+                const std::vector<int>& vnfs = data.getDemand(k).getListOfVNFs();
+                if (std::find(vnfs.begin(), vnfs.end(), f) == vnfs.end()){
+                    continue;
+                }
+                placementGrad[k][v][f] = solutions[k].placed[v][f] - Z;
+                if (placementPrice[k][v][f] <= 0.0 && placementGrad[k][v][f] < 0.0){
+                    placementGrad[k][v][f] = 0.0;
+                }
+                norm += placementGrad[k][v][f] * placementGrad[k][v][f];
+            }
+        }
+    }
+    if (norm <= 0.0){
+        return;
+    }
+
+    /* Polyak step towards the best known solution, or towards a guess while there is none. */
+    const double TARGET = (upperBound < IloInfinity) ? upperBound : value + std::max(1.0, 0.1 * std::fabs(value));
+    const double T = step * (TARGET - value) / norm;
+    for (int v = 0; v < NB_NODES; v++){
+        nodePrice[v] = std::max(0.0, nodePrice[v] + T * nodeGrad[v]);
+    }
+    for (unsigned int a = 0; a < arcPrice.size(); a++){
+        arcPrice[a] = std::max(0.0, arcPrice[a] + T * arcGrad[a]);
+    }
+    for (int k = 0; k < NB_DEMANDS; k++){
+        for (int v = 0; v < NB_NODES; v++){
+            for (int f = 0; f < NB_VNFS; f++){
+                placementPrice[k][v][f] = std::max(0.0, placementPrice[k][v][f] + T * placementGrad[k][v][f]);
+            }
+        }
+    }
+}
+
+/* Repairs the subproblem paths into a feasible solution. */
+bool Lagrangian::repair(const std::vector<LagrangianSolution>& solutions)
+{
+    /* Demands keep their subproblem paths when they fit, the others are rebuilt greedily afterwards. */
+    Constructive heuristic(data);
+    std::vector<int> rebuilt;
+    for (int k = 0; k < data.getNbDemands(); k++){
+        if (!heuristic.fixDemand(k, solutions[k].chains[0])){
+            rebuilt.push_back(k);
+        }
+    }
+    for (unsigned int j = 0; j < rebuilt.size(); j++){
+        if (!heuristic.buildDemand(rebuilt[j])){
+            return false;
+        }
+    }
+    if (heuristic.getCost() >= upperBound - EPS){
+        return false;
+    }
+    upperBound = heuristic.getCost();
+    for (int k = 0; k < data.getNbDemands(); k++){
+        bestPaths[k] = heuristic.getPaths(k);
+    }
+    return true;
+}
+
+/* Runs the subgradient until the gap is closed, the step vanishes or limits are reached. */
+void Lagrangian::run()
+{
+    std::cout << "=> Solving Lagrangian relaxation ..." << std::endl;
+    const double TIME_LIMIT = data.getInput().getTimeLimit();
+    const std::chrono::steady_clock::time_point START = std::chrono::steady_clock::now();
+    auto elapsed = [&](){ return std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count(); };
+
+    bestPaths.assign(data.getNbDemands(), std::vector<ChainPath>());
+    Constructive initial(data);
+    if (initial.run()){
+        upperBound = initial.getCost();
+        for (int k = 0; k < data.getNbDemands(); k++){
+            bestPaths[k] = initial.getPaths(k);
+        }
+    }
+
+    std::vector<LagrangianSolution> solutions(data.getNbDemands());
+    double step = LAGRANGIAN_STEP_INIT;
+    int nbStalls = 0;
+    while (nbIterations < data.getInput().getLagrangianIterations() && step >= LAGRANGIAN_STEP_MIN && elapsed() < TIME_LIMIT){
+        double value = evaluate(solutions, TIME_LIMIT - elapsed());
+        nbIterations++;
+        if (value >= IloInfinity){
+            std::cout << "\t A demand cannot be served alone: the problem is infeasible." << std::endl;
+            lowerBound = IloInfinity;
+            break;
+        }
+        if (value > lowerBound + EPS){
+            lowerBound = value;
+            nbStalls = 0;
+        }
+        else if (++nbStalls >= LAGRANGIAN_PATIENCE){
+            step /= 2.0;
+            nbStalls = 0;
+        }
+        repair(solutions);
+        std::cout << "\t Iteration " << nbIterations << ": L = " << value << ", LB = " << lowerBound << ", UB = " << upperBound << std::endl;
+        if (getGap() <= EPSILON){
+            break;
+        }
+        updatePrices(solutions, value, step);
+    }
+    time = elapsed();
+}
+
+/* Displays the obtained results */
+void Lagrangian::printResult()
+{
+    std::cout << "=> Printing solution ..." << std::endl;
+    for (int k = 0; k < data.getNbDemands() && upperBound < IloInfinity; k++) {
+        const Demand& demand = data.getDemand(k);
+        std::cout << std::endl << "----------------------------------------------------" << std::endl << std::endl;
+        std::cout << "k=" << k+1 << " : From " << demand.getSource() << " to " << demand.getTarget() << std::endl;
+        std::cout << "\t Required Avail : " << demand.getAvailability() << std::endl;
+        for (unsigned int p = 0; p < bestPaths[k].size(); p++){
+            const ChainPath& path = bestPaths[k][p];
+            std::cout << "\t Path " << p+1 << std::endl;
+            std::cout << "\t\t Path description : " << std::endl;
+            for (unsigned int i = 0; i < path.sections.size(); i++){
+                int node = (i == 0) ? demand.getSource() : path.hosts[i-1];
+                std::cout << "\t\t\t Section " << i+1 << " : " << node;
+                for (unsigned int j = 0; j < path.sections[i].size(); j++){
+                    std::cout << " -- " << data.getLink(path.sections[i][j]).getTarget();
+                }
+                std::cout << "." << std::endl;
+            }
+        }
+    }
+
+    std::cout << "Objective value: " << upperBound << std::endl;
+    std::cout << "Lagrangian bound: " << lowerBound << std::endl;
+    std::cout << "Gap: " << 100.0 * getGap() << "%" << std::endl;
+    std::cout << "Subgradient iterations: " << nbIterations << std::endl;
+    std::cout << "Total time: " << time << std::endl << std::endl;
+}
+
+/* Outputs the obtained results */
+void Lagrangian::output()
+{
+    std::string output_file = data.getInput().getOutputFile();
+    if (output_file.empty()){
+        return;
+    }
+
+	std::ofstream fileReport(output_file, std::ios_base::app); // File report
+    // If file_output can't be opened
+    if(!fileReport)
+    {
+        std::cerr << "ERROR: Unable to access output file." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    fileReport << data.getInput().getInstanceName() << ";"
+    		   << time << ";"
+    		   << upperBound << ";"
+    		   << lowerBound << ";"
+    		   << getGap() << ";"
+    		   << nbIterations << ";"
+               << std::endl;
+
+    // Finalization ***
+    fileReport.close();
+}
+
+/****************************************************************************************/
+/*										Destructors 									*/
+/****************************************************************************************/
+Lagrangian::~Lagrangian()
+{
+    for (unsigned int k = 0; k < subModel.size(); k++){
+        delete subModel[k];
+        delete subData[k];
+    }
+    for (unsigned int w = 0; w < subEnv.size(); w++){
+        subEnv[w].end();
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef __lagrangian__hpp
+#define __lagrangian__hpp
+
+/****************************************************************************************/
+/*										LIBRARIES										*/
+/****************************************************************************************/
+
+/*** C++ Libraries ***/
+#include <thread>
+#include <chrono>
+
+/*** Own Libraries ***/
+#include "model.hpp"
+
+/****************************************************************************************/
+/*										DEFINES			    							*/
+/****************************************************************************************/
+#define LAGRANGIAN_STEP_INIT 2.0 		// Initial factor of the Polyak step
+#define LAGRANGIAN_STEP_MIN 1e-3 		// Step factor below which the subgradient stops
+#define LAGRANGIAN_PATIENCE 5 			// Iterations without bound improvement before the step factor is halved
+
+/********************************************************************************************
+ * This class implements a Lagrangian relaxation of the compact formulation. The node and
+ * arc capacity constraints are dualized, and so is the sharing of the placement variables:
+ * each demand owns a copy z^k <= z. The relaxation then splits into one small MIP per
+ * demand, built on the sub-instance made of that demand alone, plus a trivial problem in z.
+ * Subproblems are solved in parallel, each thread owning the environment of its demands.
+ * Multipliers follow a Polyak subgradient step. At each iteration, the paths found by the
+ * subproblems are repaired into a feasible solution by the constructive heuristic, which
+ * gives upper bounds.
+********************************************************************************************/
+class Lagrangian
+{
+	private:
+		const Data&     				data;   		/**< Data read in data.hpp **/
+		int 							nbWorkers; 		/**< Number of threads solving subproblems. **/
+		std::vector<IloEnv> 			subEnv; 		/**< subEnv[w] is the environment of the subproblems solved by thread w. **/
+		std::vector<Data*> 				subData; 		/**< subData[k] is the sub-instance made of demand k alone. **/
+		std::vector<Model*> 			subModel; 		/**< subModel[k] is the model of demand k. **/
+
+		/*** Multipliers ***/
+		std::vector<double> 			nodePrice; 		/**< nodePrice[v] is the multiplier of the capacity of node v. **/
+		std::vector<double> 			arcPrice; 		/**< arcPrice[a] is the multiplier of the capacity of arc a. **/
+		std::vector<IloNumMatrix> 		placementPrice; /**< placementPrice[k][v][f] is the multiplier of z^k[v][f] <= z[v][f]. **/
+
+		/*** Manage execution and control ***/
+		double 							lowerBound; 	/**< Best Lagrangian bound. **/
+		double 							upperBound; 	/**< Cost of the best feasible solution. **/
+		std::vector<std::vector<ChainPath> > bestPaths; /**< bestPaths[k] are the paths of demand k in the best feasible solution. **/
+		int 							nbIterations; 	/**< Number of subgradient iterations. **/
+		double 							time;
+
+	public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+		/** Constructor. Builds the model of each demand and the initial multipliers. @param data The instance. @param nbThreads The number of threads solving subproblems, 0 to use as many as cores. **/
+		Lagrangian(const Data& data, const int nbThreads = 0);
+		Lagrangian(const Data&&) = delete;
+		Lagrangian() = delete;
+
+	/****************************************************************************************/
+	/*										   Methods  									*/
+	/****************************************************************************************/
+		/** Solves every subproblem in parallel and returns the Lagrangian bound of the current multipliers. @param solutions The subproblem solutions. @param timeLimit The time limit in seconds of the whole evaluation, each worker sharing what is left of it among its remaining subproblems. **/
+		double evaluate(std::vector<LagrangianSolution>& solutions, const double timeLimit);
+
+		/** Moves the multipliers along the subgradient given by the subproblem solutions. @param solutions The subproblem solutions. @param value The Lagrangian bound of the current multipliers. @param step The factor of the Polyak step. **/
+		void updatePrices(const std::vector<LagrangianSolution>& solutions, const double value, const double step);
+
+		/** Repairs the subproblem paths into a feasible solution. Returns true if the upper bound is improved. @param solutions The subproblem solutions. **/
+		bool repair(const std::vector<LagrangianSolution>& solutions);
+
+		/** Runs the subgradient until the gap is closed, the step vanishes or limits are reached. **/
+		void run();
+
+		/** Displays the obtained results **/
+		void printResult();
+
+		/** Outputs the obtained results **/
+		void output();
+
+	/****************************************************************************************/
+	/*										   Getters  									*/
+	/****************************************************************************************/
+		/** Returns the relative gap between the bounds. **/
+		double getGap() const { return (upperBound - lowerBound) / std::max(1.0, std::fabs(upperBound)); }
+
+	/****************************************************************************************/
+	/*										Destructors 									*/
+	/****************************************************************************************/
+		/** Destructor. Ends the subproblem environments. **/
+		~Lagrangian();
+};
+
+#endif
@@ -0,0 +1,93 @@
+#include "lns.hpp"
+
+/****************************************************************************************/
+/*										CONSTRUCTOR										*/
+/****************************************************************************************/
+
+Lns::Lns(const Data& data_, SolutionPool& pool_) : data(data_), pool(pool_),
+            timeLimit(data_.getInput().getLnsTimeLimit()), neighbourhoodSize(data_.getInput().getLnsNeighbourhoodSize()),
+            nbIterations(0), nbImprovements(0)
+{
+}
+
+/****************************************************************************************/
+/*									MAIN OPERATIONS        								*/
+/****************************************************************************************/
+
+/* Runs the search until the pool is closed. */
+void Lns::run()
+{
+    /* Concert environments are not thread safe: neighbourhoods never touch the main search environment. */
+    IloEnv lnsEnv;
+    try
+    {
+        /* Built silently, the main search reporting on the standard output meanwhile. */
+        Model sub(lnsEnv, data, Model::BUILD_MODE_NEIGHBOURHOOD);
+        std::mt19937 generator(0);
+        IloNumVector incumbent;
+        double incumbentObj = IloInfinity;
+        int version = 0;
+        while (!pool.isClosed()){
+            /* Wait for a first incumbent, then switch to the newest one as soon as it is published. */
+            pool.waitIncumbent(incumbent, incumbentObj, version, incumbent.empty() ? 1.0 : 0.0);
+            if (incumbent.empty()){
+                continue;
+            }
+
+            /* Alternate between demand and region neighbourhoods. */
+            std::vector<bool> freed;
+            if (nbIterations % 2 == 1){
+                freed = selectRegion(sub, incumbent, generator);
+            }
+            if (std::find(freed.begin(), freed.end(), true) == freed.end()){
+                freed = selectDemands(generator);
+            }
+            ++nbIterations;
+
+            IloNumVector values;
+            IloNum obj = 0.0;
+            if (sub.solveNeighbourhood(freed, incumbent, timeLimit, incumbentObj - EPS, values, obj)){
+                pool.pushImprovement(values, obj);
+                incumbent.swap(values);
+                incumbentObj = obj;
+                ++nbImprovements;
+            }
+        }
+    }
+    catch (const IloException& e) { std::cerr << "ERROR: Large neighbourhood search stopped: " << e << std::endl; }
+    catch (...) { std::cerr << "ERROR: Large neighbourhood search stopped." << std::endl; }
+    lnsEnv.end();
+}
+
+/* Returns a neighbourhood made of randomly chosen demands. */
+std::vector<bool> Lns::selectDemands(std::mt19937& generator) const
+{
+    std::vector<int> demands(data.getNbDemands());
+    std::iota(demands.begin(), demands.end(), 0);
+    std::shuffle(demands.begin(), demands.end(), generator);
+
+    std::vector<bool> freed(data.getNbDemands(), false);
+    for (int j = 0; j < neighbourhoodSize && j < data.getNbDemands(); j++){
+        freed[demands[j]] = true;
+    }
+    return freed;
+}
+
+/* Returns a neighbourhood made of the demands placed on a random node or on its neighbours. */
+std::vector<bool> Lns::selectRegion(const Model& sub, const IloNumVector& incumbent, std::mt19937& generator) const
+{
+    std::uniform_int_distribution<int> pick(0, data.getNbNodes() - 1);
+    const int CENTER = pick(generator);
+
+    std::vector<bool> region(data.getNbNodes(), false);
+    region[CENTER] = true;
+    for (unsigned int a = 0; a < data.getLinks().size(); a++){
+        if (data.getLink(a).getSource() == CENTER){
+            region[data.getLink(a).getTarget()] = true;
+        }
+        if (data.getLink(a).getTarget() == CENTER){
+            region[data.getLink(a).getSource()] = true;
+        }
+    }
+    return sub.getDemandsHostedIn(region, incumbent);
+}
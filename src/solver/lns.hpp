@@ -0,0 +1,67 @@
+#ifndef __lns__hpp
+#define __lns__hpp
+
+/****************************************************************************************/
+/*										LIBRARIES										*/
+/****************************************************************************************/
+
+/*** C++ Libraries ***/
+#include <random>
+
+/*** Own Libraries ***/
+#include "model.hpp"
+
+/********************************************************************************************
+ * This class implements a large neighbourhood search running alongside CPLEX on its own
+ * thread. It repeatedly frees the variables of a few demands, or of the demands placed on a
+ * region of nodes, fixes the rest to the incumbent and solves the small sub-MIP within a
+ * short time limit. Incumbents are read from, and improvements are published to, a solution
+ * pool shared with the main search callback.
+********************************************************************************************/
+class Lns {
+
+private:
+    const Data& 	data; 					/**< Data read in data.hpp **/
+    SolutionPool& 	pool; 					/**< Pool shared with the main search. **/
+    const int 		timeLimit; 				/**< Time limit in seconds of each neighbourhood solve. **/
+    const int 		neighbourhoodSize; 		/**< Number of demands freed in each demand neighbourhood. **/
+
+    /*** Manage execution and control ***/
+    int 			nbIterations; 			/**< Number of neighbourhoods solved. **/
+    int 			nbImprovements; 		/**< Number of improving solutions found. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+    /** Constructor. @param data The instance data. @param pool The pool shared with the main search. **/
+    Lns(const Data& data, SolutionPool& pool);
+
+	/****************************************************************************************/
+	/*									Main operations  									*/
+	/****************************************************************************************/
+    /** Runs the search until the pool is closed. @note Neighbourhoods are solved in an environment of their own. **/
+    void run();
+
+    /** Returns a neighbourhood made of randomly chosen demands. @param generator The random number generator. **/
+    std::vector<bool> selectDemands(std::mt19937& generator) const;
+
+    /** Returns a neighbourhood made of the demands placed on a random node or on its neighbours. @param sub The model solving the neighbourhoods. @param incumbent The incumbent solution. @param generator The random number generator. **/
+    std::vector<bool> selectRegion(const Model& sub, const IloNumVector& incumbent, std::mt19937& generator) const;
+
+	/****************************************************************************************/
+	/*								      Query Methods	    	    	    				*/
+	/****************************************************************************************/
+    /** Returns the number of neighbourhoods solved. @note Should only be called once the search is over. **/
+    const int getNbIterations()   const { return nbIterations; }
+    /** Returns the number of improving solutions found. @note Should only be called once the search is over. **/
+    const int getNbImprovements() const { return nbImprovements; }
+
+	/****************************************************************************************/
+	/*										Destructors			    						*/
+	/****************************************************************************************/
+    /** Destructor **/
+    ~Lns() {}
+};
+
+#endif
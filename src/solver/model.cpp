@@ -1,27 +1,48 @@
 #include "model.hpp"
+#include "lns.hpp"
 
-void printVector(const std::vector<double> &v, std::string name){
-    std::cout << name << " :" << std::endl;
+void printVector(std::ostream& out, const std::vector<double> &v, std::string name){
+    out << name << " :" << std::endl;
     for (unsigned int k = 0; k < v.size(); k++){
-        std::cout << k << " : " << v[k] << std::endl;
+        out << k << " : " << v[k] << std::endl;
     }
-    std::cout << std::endl;
+    out << std::endl;
+}
+/* Inserts a value in a sorted vector of touches, unless it lies outside or next to an existing touch. */
+bool insertTouch(std::vector<double> &touch, double u){
+    if (u <= touch.front() + REFINEMENT_MIN_DISTANCE || u >= touch.back() - REFINEMENT_MIN_DISTANCE){
+        return false;
+    }
+    std::vector<double>::iterator it = std::lower_bound(touch.begin(), touch.end(), u);
+    if (*it - u < REFINEMENT_MIN_DISTANCE || u - *(it-1) < REFINEMENT_MIN_DISTANCE){
+        return false;
+    }
+    touch.insert(it, u);
+    return true;
 }
 /* Constructor */
-Model::Model(const IloEnv& env_, const Data& data_) : 
+Model::Model(const IloEnv& env_, const Data& data_) : Model(env_, data_, BUILD_MODE_FULL)
+{
+}
+
+/* Constructor. Only a full model reports its build; a formulation only model has neither callback nor CPLEX parameters. */
+Model::Model(const IloEnv& env_, const Data& data_, const Build_Mode mode) : 
                 env(env_), model(env), cplex(model), data(data_), 
-                obj(env), constraints(env)
+                obj(env), constraints(env), nodeCapacityRows(env), arcCapacityRows(env), callback(NULL), solution(data_), validator(data_, !isRoutingDelegated()), solutionVars(env), timeLimit(data_.getInput().getTimeLimit()), buildLog(mode == BUILD_MODE_FULL ? std::cout.rdbuf() : NULL), initialFormulation(true), solutionPool(NULL), lns(NULL)
 {
 
-    std::cout << "=> Building model ... " << std::endl;
+    buildLog << "=> Building model ... " << std::endl;
     
     buildPiecewiseLinearApproximation();
     setVariables();
+    setSolutionVariables();
     setObjective();  
     setConstraints();  
-    setCplexParameters();
+    if (mode != BUILD_MODE_FORMULATION){
+        setCplexParameters(mode == BUILD_MODE_NEIGHBOURHOOD);
+    }
 
-    std::cout << "\t Model was correctly built ! " << std::endl;                 
+    buildLog << "\t Model was correctly built ! " << std::endl;                 
 }
 // breaks[0] = 0 and breaks[last] = 1.0
 /* Returns g(y) where g(y) is a function approximating log(y) from above */
@@ -112,51 +133,60 @@ void Model::buildPiecewiseLinearApproximation(){
 }
 /* Set up the vector u for approximating log(avail). */
 void Model::buildAvailVector_u(){
-    const int PATH_NB_BREAKS    = data.getInput().getNbBreakpoints();
     const int NB_DEMANDS        = data.getNbDemands();
+    avail_touch.resize(NB_DEMANDS);
+    for (int q = 0; q < NB_DEMANDS; q++){
+        buildAvailVector_u(q);
+    }
+}
+
+/* Set up the vector u for approximating log(avail) for a given demand. */
+void Model::buildAvailVector_u(const int q){
+    const int PATH_NB_BREAKS    = data.getInput().isRefinementOn() ? REFINEMENT_NB_TOUCHS : data.getInput().getNbBreakpoints();
     int PATH_NB_TOUCHS          = PATH_NB_BREAKS;
 
     if (data.getInput().getApproximationType() ==  Input::APPROXIMATION_TYPE_RESTRICTION){
         PATH_NB_TOUCHS = PATH_NB_BREAKS + 1;
     }
 
-    avail_touch.resize(NB_DEMANDS);
-    for (int q = 0; q < NB_DEMANDS; q++){
-        double leastAvailPath = data.getChainAvailability(data.getNLeastAvailableNodes(data.getDemand(q).getNbVNFs()));
-        double mostAvailPath = data.getChainAvailability(data.getNMostAvailableNodes(1));
-    
-        for (int k = 1; k <= PATH_NB_TOUCHS; k++){
-            double expo = ((double) (PATH_NB_TOUCHS - k)) / (PATH_NB_TOUCHS - 1);
-            double u = mostAvailPath * std::pow((leastAvailPath/mostAvailPath), expo);
-            avail_touch[q].push_back(u);
-        }
-        printVector(avail_touch[q], "avail touch");
+    avail_touch[q].clear();
+    double leastAvailPath = data.getChainAvailability(data.getNLeastAvailableNodes(data.getDemand(q).getNbVNFs()));
+    double mostAvailPath = data.getChainAvailability(data.getNMostAvailableNodes(1));
+
+    for (int k = 1; k <= PATH_NB_TOUCHS; k++){
+        double expo = ((double) (PATH_NB_TOUCHS - k)) / (PATH_NB_TOUCHS - 1);
+        double u = mostAvailPath * std::pow((leastAvailPath/mostAvailPath), expo);
+        avail_touch[q].push_back(u);
     }
+    printVector(buildLog, avail_touch[q], "avail touch");
 }
 
 /* Set up the breakpoints for approximating log(avail). */
 void Model::buildAvailBreakpoints(){
     const int NB_DEMANDS = data.getNbDemands();
     avail_breakpoints.resize(NB_DEMANDS);
+    for (int q = 0; q < NB_DEMANDS; q++){
+        buildAvailBreakpoints(q);
+        printVector(buildLog, avail_breakpoints[q], "avail breakpoints");
+    }
+}
+
+/* Set up the breakpoints for approximating log(avail) for a given demand. */
+void Model::buildAvailBreakpoints(const int q){
+    avail_breakpoints[q].clear();
     if (data.getInput().getApproximationType() == Input::APPROXIMATION_TYPE_RESTRICTION){
-        for (int q = 0; q < NB_DEMANDS; q++){
-            for (unsigned int k = 1; k < avail_touch[q].size(); k++){
-                double log_u_k1 = std::log(avail_touch[q][k]);
-                double log_u_k = std::log(avail_touch[q][k-1]);
-                double inv_u_k1 = 1.0/avail_touch[q][k];
-                double inv_u_k = 1.0/avail_touch[q][k-1];
-                
-                avail_breakpoints[q].push_back( (log_u_k1 - log_u_k) / (inv_u_k - inv_u_k1) );
-            }
-            printVector(avail_breakpoints[q], "avail breakpoints");
+        for (unsigned int k = 1; k < avail_touch[q].size(); k++){
+            double log_u_k1 = std::log(avail_touch[q][k]);
+            double log_u_k = std::log(avail_touch[q][k-1]);
+            double inv_u_k1 = 1.0/avail_touch[q][k];
+            double inv_u_k = 1.0/avail_touch[q][k-1];
+            
+            avail_breakpoints[q].push_back( (log_u_k1 - log_u_k) / (inv_u_k - inv_u_k1) );
         }
     }
     else{
-        for (int q = 0; q < NB_DEMANDS; q++){
-            for (unsigned int k = 0; k < avail_touch[q].size(); k++){
-                avail_breakpoints[q].push_back(avail_touch[q][k]);
-            }
-            printVector(avail_breakpoints[q], "avail breakpoints");
+        for (unsigned int k = 0; k < avail_touch[q].size(); k++){
+            avail_breakpoints[q].push_back(avail_touch[q][k]);
         }
     }
 }
@@ -165,69 +195,76 @@ void Model::buildAvailBreakpoints(){
 void Model::buildUnavailVector_u(){
     const int NB_DEMANDS        = data.getNbDemands();
     unavail_touch.resize(NB_DEMANDS);
-
     for (int q = 0; q < NB_DEMANDS; q++){
-        const int PATH_NB_TOUCHS    = (int)avail_touch[q].size();
-        //std::cout << (int)avail_touch[q].size() << std::endl;
-        //const int PATH_NB_TOUCHS    = 12;
-        double leastAvailPath = data.getChainAvailability(data.getNLeastAvailableNodes(data.getDemand(q).getNbVNFs()));
-        double mostAvailPath = data.getChainAvailability(data.getNMostAvailableNodes(1));
-        double UB = 1.0 - leastAvailPath;
-        double LB = 1.0 - mostAvailPath;
-        for (int k = 1; k <= PATH_NB_TOUCHS; k++){
-            double expo = ((double) (PATH_NB_TOUCHS - k)) / (PATH_NB_TOUCHS - 1);
-            double u = (UB) * std::pow((LB/UB), expo);
-            unavail_touch[q].push_back(u);
-        }
-        unavail_touch[q].push_back(1.0);
-        printVector(unavail_touch[q], "config vector u");
+        buildUnavailVector_u(q);
+    }
+}
+
+/* Set up the vector u for approximating log(unavail) for a given demand. */
+void Model::buildUnavailVector_u(const int q){
+    const int PATH_NB_TOUCHS    = (int)avail_touch[q].size();
+    //std::cout << (int)avail_touch[q].size() << std::endl;
+    //const int PATH_NB_TOUCHS    = 12;
+    unavail_touch[q].clear();
+    double leastAvailPath = data.getChainAvailability(data.getNLeastAvailableNodes(data.getDemand(q).getNbVNFs()));
+    double mostAvailPath = data.getChainAvailability(data.getNMostAvailableNodes(1));
+    double UB = 1.0 - leastAvailPath;
+    double LB = 1.0 - mostAvailPath;
+    for (int k = 1; k <= PATH_NB_TOUCHS; k++){
+        double expo = ((double) (PATH_NB_TOUCHS - k)) / (PATH_NB_TOUCHS - 1);
+        double u = (UB) * std::pow((LB/UB), expo);
+        unavail_touch[q].push_back(u);
     }
+    unavail_touch[q].push_back(1.0);
+    printVector(buildLog, unavail_touch[q], "config vector u");
 }
 
 /* Set up the breakpoints for approximating log(unavail). */
 void Model::buildUnavailBreakpoints(){
     const int NB_DEMANDS = data.getNbDemands();
     unavail_breakpoints.resize(NB_DEMANDS);
-    
+    for (int q = 0; q < NB_DEMANDS; q++){
+        buildUnavailBreakpoints(q);
+        printVector(buildLog, unavail_breakpoints[q], "unavail breakpoints");
+    }
+}
+
+/* Set up the breakpoints for approximating log(unavail) for a given demand. */
+void Model::buildUnavailBreakpoints(const int q){
+    unavail_breakpoints[q].clear();
     if (data.getInput().getApproximationType() == Input::APPROXIMATION_TYPE_RESTRICTION){
-        for (int q = 0; q < NB_DEMANDS; q++){
-            for (unsigned int k = 1; k <= unavail_touch[q].size()-1; k++){
-                double log_u_k1 = std::log(unavail_touch[q][k]);
-                double log_u_k = std::log(unavail_touch[q][k-1]);
-                double inv_u_k1 = 1.0/unavail_touch[q][k];
-                double inv_u_k = 1.0/unavail_touch[q][k-1];
-                unavail_breakpoints[q].push_back( (log_u_k1 - log_u_k) / (inv_u_k - inv_u_k1) );
-            }
-            printVector(unavail_breakpoints[q], "unavail breakpoints");
+        for (unsigned int k = 1; k <= unavail_touch[q].size()-1; k++){
+            double log_u_k1 = std::log(unavail_touch[q][k]);
+            double log_u_k = std::log(unavail_touch[q][k-1]);
+            double inv_u_k1 = 1.0/unavail_touch[q][k];
+            double inv_u_k = 1.0/unavail_touch[q][k-1];
+            unavail_breakpoints[q].push_back( (log_u_k1 - log_u_k) / (inv_u_k - inv_u_k1) );
         }
     }
     else{
-        for (int q = 0; q < NB_DEMANDS; q++){
-            for (unsigned int k = 0; k < unavail_touch[q].size(); k++){
-                unavail_breakpoints[q].push_back(unavail_touch[q][k]);
-            }
-            printVector(unavail_breakpoints[q], "unavail breakpoints");
+        for (unsigned int k = 0; k < unavail_touch[q].size(); k++){
+            unavail_breakpoints[q].push_back(unavail_touch[q][k]);
         }
     }
 }
 
 /** Set up the Cplex parameters. **/
-void Model::setCplexParameters(){
+void Model::setCplexParameters(const bool candidateOnly){
     /** Build callback **/
-    callback = new Callback(env, data, y, x, alpha);
+    callback = new Callback(env, data, y, x, alpha, candidateOnly);
+    callback->setAvailabilityVariables(avail);
 
-    /* Define contexts under which the callback will be executed */
-    CPXLONG chosenContext = 0;
-	chosenContext |= IloCplex::Callback::Context::Id::Candidate;
-	//chosenContext |= IloCplex::Callback::Context::Id::Relaxation;
-
-    /* Use callback within the defined contexts */
-    if (data.getInput().getApproximationType() == Input::APPROXIMATION_TYPE_RELAXATION || data.getInput().isBasic()){
-	    cplex.use(callback, chosenContext);
+    /* Use callback within the contexts it is needed in */
+    const CPXLONG CHOSEN_CONTEXT = callback->getContextMask();
+    if (CHOSEN_CONTEXT != 0){
+	    cplex.use(callback, CHOSEN_CONTEXT);
     }
 
+    /** Branching priorities **/
+    setBranchingPriorities();
+
     /** Time limit definition **/
-    cplex.setParam(IloCplex::Param::TimeLimit, data.getInput().getTimeLimit());    // Execution time limited
+    cplex.setParam(IloCplex::Param::TimeLimit, timeLimit);    // Execution time limited
 	
     // cplex.setParam(IloCplex::Param::Simplex::Tolerances::Feasibility, 1e-9);
     // cplex.setParam(IloCplex::Param::Simplex::Tolerances::Optimality, 1e-9);
@@ -245,87 +282,34 @@ void Model::setCplexParameters(){
 /* Set up variables */
 void Model::setVariables(){
     const int NB_NODES   = lemon::countNodes(data.getGraph());
-    const int NB_ARCS    = lemon::countArcs(data.getGraph());
     const int NB_DEMANDS = data.getNbDemands();
     const int NB_VNFS    = data.getNbVnfs();
 
-    std::cout << "\t Setting up variables... " << std::endl;
+    buildLog << "\t Setting up variables... " << std::endl;
 
     /* Flow variables: f[k][a][i][p] = 1 if arc a is used for routing section i of path p from demand k. */
-    std::cout << "\t > Setting up flow variables. " << std::endl;
+    buildLog << "\t > Setting up flow variables. " << std::endl;
     f.resize(NB_DEMANDS);
     for (int k = 0; k < NB_DEMANDS; k++){
-        const int NB_PATHS   = data.getNbPaths(k);
-        f[k].resize(NB_ARCS);
-        for (ArcIt it(data.getGraph()); it != lemon::INVALID; ++it){
-            int a = data.getArcId(it);
-            const int NB_SECTIONS = data.getDemand(k).getNbVNFs() + 1;
-            f[k][a].resize(NB_SECTIONS);
-            for (int i = 0; i < NB_SECTIONS; i++){
-                f[k][a][i].resize(NB_PATHS);
-                for (int p = 0; p < NB_PATHS; p++){
-                    std::string name = "f(" + std::to_string(k) + "," + std::to_string(a) + "," + std::to_string(i) + "," + std::to_string(p) + ")";
-                    if (data.getInput().isRelaxation()){
-                        f[k][a][i][p] = IloNumVar(env, 0.0, 1.0, ILOFLOAT, name.c_str());
-                    }
-                    else{
-                        f[k][a][i][p] = IloNumVar(env, 0.0, 1.0, ILOINT, name.c_str());
-                    }
-                    model.add(f[k][a][i][p]);
-                }
-            }
-        }
+        setFlowVariables(k);
     }
 
     /* VNF section placement variables: x[k][v][i][p] = 1 if there is the i-th VNF of demand k is placed on node v within its path p. */
-    std::cout << "\t > Setting up VNF section placement variables. " << std::endl;
+    buildLog << "\t > Setting up VNF section placement variables. " << std::endl;
     x.resize(NB_DEMANDS);
     for (int k = 0; k < NB_DEMANDS; k++){
-        const int NB_PATHS = data.getNbPaths(k);
-        x[k].resize(NB_NODES);
-        for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-            int v = data.getNodeId(n);
-            x[k][v].resize(data.getDemand(k).getNbVNFs());
-            for (int i = 0; i < data.getDemand(k).getNbVNFs(); i++){
-                x[k][v][i].resize(NB_PATHS);
-                for (int p = 0; p < NB_PATHS; p++){
-                    std::string name = "x(" + std::to_string(k) + "," + std::to_string(v) + "," + std::to_string(i) + "," + std::to_string(p) + ")";
-                    if (data.getInput().isRelaxation()){
-                        x[k][v][i][p] = IloNumVar(env, 0.0, 1.0, ILOFLOAT, name.c_str());
-                    }
-                    else{
-                        x[k][v][i][p] = IloNumVar(env, 0.0, 1.0, ILOINT, name.c_str());
-                    }
-                    model.add(x[k][v][i][p]);
-                }
-            }
-        }
+        setSectionPlacementVariables(k);
     }
 
     /* VNF path placement variables: y[k][v][p] = 1 if there is a VNF placed on node v within the path p of demand k. */
-    std::cout << "\t > Setting up VNF path placement variables. " << std::endl;
+    buildLog << "\t > Setting up VNF path placement variables. " << std::endl;
     y.resize(NB_DEMANDS);
     for (int k = 0; k < NB_DEMANDS; k++){
-        const int NB_PATHS = data.getNbPaths(k);
-        y[k].resize(NB_NODES);
-        for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-            int v = data.getNodeId(n);
-            y[k][v].resize(NB_PATHS);
-            for (int p = 0; p < NB_PATHS; p++){
-                std::string name = "y(" + std::to_string(k) + "," + std::to_string(v) + "," + std::to_string(p) + ")";
-                if (data.getInput().isRelaxation()){
-                    y[k][v][p] = IloNumVar(env, 0.0, 1.0, ILOFLOAT, name.c_str());
-                }
-                else{
-                    y[k][v][p] = IloNumVar(env, 0.0, 1.0, ILOINT, name.c_str());
-                }
-                model.add(y[k][v][p]);
-            }
-        }
+        setPathPlacementVariables(k);
     }
 
     /* VNF global placement variables: z[v][f] = 1 if vnf f is placed on node v */
-    std::cout << "\t > Setting up VNF global placement variables. " << std::endl;
+    buildLog << "\t > Setting up VNF global placement variables. " << std::endl;
     z.resize(NB_NODES);
     for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
         int v = data.getNodeId(n);
@@ -344,89 +328,254 @@ void Model::setVariables(){
     }
 
     /* Path activation variables: alpha[k][p] = 1 if path p is active for demand k */
-    std::cout << "\t > Setting up path activation variables. " << std::endl;
+    buildLog << "\t > Setting up path activation variables. " << std::endl;
     alpha.resize(NB_DEMANDS);
     for (int k = 0; k < NB_DEMANDS; k++){
-        const int NB_PATHS = data.getNbPaths(k);
-        alpha[k].resize(NB_PATHS);
-        double REQUIRED_AVAIL = data.getDemand(k).getAvailability();
-        int MIN_NB_PATHS = data.getMinNbNodes(REQUIRED_AVAIL);
-        std::cout << "Min/max nb paths for demand " << k << ": " << MIN_NB_PATHS << ", " << NB_PATHS << std::endl;
-        for (int p = 0; p < NB_PATHS; p++){
-            std::string name = "alpha(" + std::to_string(k) + "," + std::to_string(p) + ")";
-            double lb = 0.0;
-            if (p < MIN_NB_PATHS && data.getInput().getNbPathsLowerBound() == Input::NB_PATHS_LOWER_BOUND_ON){
-                lb = 1.0;
-            }
-            if (data.getInput().isRelaxation()){
-                alpha[k][p] = IloNumVar(env, lb, 1.0, ILOFLOAT, name.c_str());
-            }
-            else{
-                alpha[k][p] = IloNumVar(env, lb, 1.0, ILOINT, name.c_str());
-            }
-            model.add(alpha[k][p]);
-        }
+        setPathActivationVariables(k);
     }
 
     if(data.getInput().isRelaxation() == false){
         /* Path availability variables: avail[k][p] */
-        std::cout << "\t > Setting up path availability variables. " << std::endl;
+        buildLog << "\t > Setting up path availability variables. " << std::endl;
         avail.resize(NB_DEMANDS);
         for (int k = 0; k < NB_DEMANDS; k++){
-            const int NB_PATHS = data.getNbPaths(k);
-            avail[k].resize(NB_PATHS);
-            for (int p = 0; p < NB_PATHS; p++){
-                std::string name = "avail(" + std::to_string(k) + "," + std::to_string(p) + ")";
-                avail[k][p] = IloNumVar(env, 0.0, 1.0, ILOFLOAT, name.c_str());
-                model.add(avail[k][p]);
-            }
+            setPathVariables(avail, k, "avail", 0.0, 1.0);
         }
 
-
         /* Approximated path availability variables: approx_log_avail[k][p] */
-        std::cout << "\t > Setting up path availability variables. " << std::endl;
+        buildLog << "\t > Setting up path availability variables. " << std::endl;
         approx_log_avail.resize(NB_DEMANDS);
         for (int k = 0; k < NB_DEMANDS; k++){
-            const int NB_PATHS = data.getNbPaths(k);
-            approx_log_avail[k].resize(NB_PATHS);
-            for (int p = 0; p < NB_PATHS; p++){
-                std::string name = "approx_log_avail(" + std::to_string(k) + "," + std::to_string(p) + ")";
-                approx_log_avail[k][p] = IloNumVar(env, -IloInfinity, 0.0, ILOFLOAT, name.c_str());
-                model.add(approx_log_avail[k][p]);
-            }
+            setPathVariables(approx_log_avail, k, "approx_log_avail", -IloInfinity, 0.0);
         }
+
         /* Path unavailability variables: unavail[k][p] */
-        std::cout << "\t > Setting up path unavailability variables. " << std::endl;
+        buildLog << "\t > Setting up path unavailability variables. " << std::endl;
         unavail.resize(NB_DEMANDS);
         for (int k = 0; k < NB_DEMANDS; k++){
-            const int NB_PATHS = data.getNbPaths(k);
-            unavail[k].resize(NB_PATHS);
-            for (int p = 0; p < NB_PATHS; p++){
-                std::string name = "unavail(" + std::to_string(k) + "," + std::to_string(p) + ")";
-                unavail[k][p] = IloNumVar(env, 0.0, 1.0, ILOFLOAT, name.c_str());
-                model.add(unavail[k][p]);
-            }
+            setPathVariables(unavail, k, "unavail", 0.0, 1.0);
         }
 
         /* Approximated config availability variables: approx_log_unavail[k][p] */
-        std::cout << "\t > Setting up path availability variables. " << std::endl;
+        buildLog << "\t > Setting up path availability variables. " << std::endl;
         approx_log_unavail.resize(NB_DEMANDS);
         for (int k = 0; k < NB_DEMANDS; k++){
-            const int NB_PATHS = data.getNbPaths(k);
-            approx_log_unavail[k].resize(NB_PATHS);
+            setPathVariables(approx_log_unavail, k, "approx_log_unavail", -IloInfinity, 0.0);
+        }
+    }
+}
+
+/* Set up the flow variables of demand k. In the Benders master, routing is left to the callback subproblems and f[k] stays empty. */
+void Model::setFlowVariables(const int k){
+    if (isRoutingDelegated()){
+        return;
+    }
+    const int NB_PATHS = data.getNbPaths(k);
+    f[k].resize(lemon::countArcs(data.getGraph()));
+    for (ArcIt it(data.getGraph()); it != lemon::INVALID; ++it){
+        int a = data.getArcId(it);
+        const int NB_SECTIONS = data.getDemand(k).getNbVNFs() + 1;
+        f[k][a].resize(NB_SECTIONS);
+        for (int i = 0; i < NB_SECTIONS; i++){
+            f[k][a][i].resize(NB_PATHS);
+            for (int p = 0; p < NB_PATHS; p++){
+                std::string name = "f(" + std::to_string(k) + "," + std::to_string(a) + "," + std::to_string(i) + "," + std::to_string(p) + ")";
+                if (data.getInput().isRelaxation()){
+                    f[k][a][i][p] = IloNumVar(env, 0.0, 1.0, ILOFLOAT, name.c_str());
+                }
+                else{
+                    f[k][a][i][p] = IloNumVar(env, 0.0, 1.0, ILOINT, name.c_str());
+                }
+                model.add(f[k][a][i][p]);
+            }
+        }
+    }
+}
+
+/* Set up the VNF section placement variables of demand k. */
+void Model::setSectionPlacementVariables(const int k){
+    const int NB_PATHS = data.getNbPaths(k);
+    x[k].resize(lemon::countNodes(data.getGraph()));
+    for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
+        int v = data.getNodeId(n);
+        x[k][v].resize(data.getDemand(k).getNbVNFs());
+        for (int i = 0; i < data.getDemand(k).getNbVNFs(); i++){
+            x[k][v][i].resize(NB_PATHS);
             for (int p = 0; p < NB_PATHS; p++){
-                std::string name = "approx_log_unavail(" + std::to_string(k) + "," + std::to_string(p) + ")";
-                approx_log_unavail[k][p] = IloNumVar(env, -IloInfinity, 0.0, ILOFLOAT, name.c_str());
-                model.add(approx_log_unavail[k][p]);
+                std::string name = "x(" + std::to_string(k) + "," + std::to_string(v) + "," + std::to_string(i) + "," + std::to_string(p) + ")";
+                if (data.getInput().isRelaxation()){
+                    x[k][v][i][p] = IloNumVar(env, 0.0, 1.0, ILOFLOAT, name.c_str());
+                }
+                else{
+                    x[k][v][i][p] = IloNumVar(env, 0.0, 1.0, ILOINT, name.c_str());
+                }
+                model.add(x[k][v][i][p]);
+            }
+        }
+    }
+}
+
+/* Set up the VNF path placement variables of demand k. */
+void Model::setPathPlacementVariables(const int k){
+    const int NB_PATHS = data.getNbPaths(k);
+    y[k].resize(lemon::countNodes(data.getGraph()));
+    for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
+        int v = data.getNodeId(n);
+        y[k][v].resize(NB_PATHS);
+        for (int p = 0; p < NB_PATHS; p++){
+            std::string name = "y(" + std::to_string(k) + "," + std::to_string(v) + "," + std::to_string(p) + ")";
+            if (data.getInput().isRelaxation()){
+                y[k][v][p] = IloNumVar(env, 0.0, 1.0, ILOFLOAT, name.c_str());
+            }
+            else{
+                y[k][v][p] = IloNumVar(env, 0.0, 1.0, ILOINT, name.c_str());
+            }
+            model.add(y[k][v][p]);
+        }
+    }
+}
+
+/* Set up the path activation variables of demand k. */
+void Model::setPathActivationVariables(const int k){
+    const int NB_PATHS = data.getNbPaths(k);
+    alpha[k].resize(NB_PATHS);
+    double REQUIRED_AVAIL = data.getDemand(k).getAvailability();
+    int MIN_NB_PATHS = data.getMinNbNodes(REQUIRED_AVAIL);
+    buildLog << "Min/max nb paths for demand " << k << ": " << MIN_NB_PATHS << ", " << NB_PATHS << std::endl;
+    for (int p = 0; p < NB_PATHS; p++){
+        std::string name = "alpha(" + std::to_string(k) + "," + std::to_string(p) + ")";
+        double lb = 0.0;
+        if (p < MIN_NB_PATHS && data.getInput().getNbPathsLowerBound() == Input::NB_PATHS_LOWER_BOUND_ON){
+            lb = 1.0;
+        }
+        if (data.getInput().isRelaxation()){
+            alpha[k][p] = IloNumVar(env, lb, 1.0, ILOFLOAT, name.c_str());
+        }
+        else{
+            alpha[k][p] = IloNumVar(env, lb, 1.0, ILOINT, name.c_str());
+        }
+        model.add(alpha[k][p]);
+    }
+}
+
+/* Set up one continuous variable per path of demand k within a family of path variables. */
+void Model::setPathVariables(IloNumVarMatrix& vars, const int k, const std::string& prefix, const double lb, const double ub){
+    const int NB_PATHS = data.getNbPaths(k);
+    vars[k].resize(NB_PATHS);
+    for (int p = 0; p < NB_PATHS; p++){
+        std::string name = prefix + "(" + std::to_string(k) + "," + std::to_string(p) + ")";
+        vars[k][p] = IloNumVar(env, lb, ub, ILOFLOAT, name.c_str());
+        model.add(vars[k][p]);
+    }
+}
+
+/* Set up the flattened array of solution variables. */
+void Model::setSolutionVariables(){
+    const int NB_DEMANDS = data.getNbDemands();
+    solutionVars.clear();
+    demandVarRange.resize(NB_DEMANDS);
+    yIndex.resize(NB_DEMANDS);
+    for (int k = 0; k < NB_DEMANDS; k++){
+        demandVarRange[k].first = solutionVars.getSize();
+        for (unsigned int p = 0; p < alpha[k].size(); p++){
+            solutionVars.add(alpha[k][p]);
+        }
+        for (unsigned int a = 0; a < f[k].size(); a++){
+            for (unsigned int i = 0; i < f[k][a].size(); i++){
+                for (unsigned int p = 0; p < f[k][a][i].size(); p++){
+                    solutionVars.add(f[k][a][i][p]);
+                }
+            }
+        }
+        for (unsigned int v = 0; v < x[k].size(); v++){
+            for (unsigned int i = 0; i < x[k][v].size(); i++){
+                for (unsigned int p = 0; p < x[k][v][i].size(); p++){
+                    solutionVars.add(x[k][v][i][p]);
+                }
+            }
+        }
+        yIndex[k].resize(y[k].size());
+        for (unsigned int v = 0; v < y[k].size(); v++){
+            yIndex[k][v].resize(y[k][v].size());
+            for (unsigned int p = 0; p < y[k][v].size(); p++){
+                yIndex[k][v][p] = solutionVars.getSize();
+                solutionVars.add(y[k][v][p]);
+            }
+        }
+        demandVarRange[k].second = solutionVars.getSize();
+    }
+    for (unsigned int v = 0; v < z.size(); v++){
+        for (unsigned int vnf = 0; vnf < z[v].size(); vnf++){
+            solutionVars.add(z[v][vnf]);
+        }
+    }
+    const IloNumVarMatrix* continuous[] = { &avail, &approx_log_avail, &unavail, &approx_log_unavail };
+    for (int c = 0; c < 4; c++){
+        for (unsigned int k = 0; k < continuous[c]->size(); k++){
+            for (unsigned int p = 0; p < (*continuous[c])[k].size(); p++){
+                solutionVars.add((*continuous[c])[k][p]);
             }
         }
     }
+
+    solutionLB.resize(solutionVars.getSize());
+    solutionUB.resize(solutionVars.getSize());
+    for (IloInt j = 0; j < solutionVars.getSize(); j++){
+        solutionLB[j] = solutionVars[j].getLB();
+        solutionUB[j] = solutionVars[j].getUB();
+    }
+}
+
+/* Set up the branching priorities of each variable family. Fixing z and alpha decides most of the rest, so they are meant to come first. */
+void Model::setBranchingPriorities(){
+    const Input& input = data.getInput();
+    IloNumVarArray vars(env);
+    IloNumArray priorities(env);
+    for (int k = 0; k < data.getNbDemands(); k++){
+        for (unsigned int p = 0; p < alpha[k].size() && input.getPriorityAlpha() > 0; p++){
+            vars.add(alpha[k][p]);
+            priorities.add(input.getPriorityAlpha());
+        }
+        for (unsigned int a = 0; a < f[k].size() && input.getPriorityF() > 0; a++){
+            for (unsigned int i = 0; i < f[k][a].size(); i++){
+                for (unsigned int p = 0; p < f[k][a][i].size(); p++){
+                    vars.add(f[k][a][i][p]);
+                    priorities.add(input.getPriorityF());
+                }
+            }
+        }
+        for (unsigned int v = 0; v < x[k].size() && input.getPriorityX() > 0; v++){
+            for (unsigned int i = 0; i < x[k][v].size(); i++){
+                for (unsigned int p = 0; p < x[k][v][i].size(); p++){
+                    vars.add(x[k][v][i][p]);
+                    priorities.add(input.getPriorityX());
+                }
+            }
+        }
+        for (unsigned int v = 0; v < y[k].size() && input.getPriorityY() > 0; v++){
+            for (unsigned int p = 0; p < y[k][v].size(); p++){
+                vars.add(y[k][v][p]);
+                priorities.add(input.getPriorityY());
+            }
+        }
+    }
+    for (unsigned int v = 0; v < z.size() && input.getPriorityZ() > 0; v++){
+        for (unsigned int vnf = 0; vnf < z[v].size(); vnf++){
+            vars.add(z[v][vnf]);
+            priorities.add(input.getPriorityZ());
+        }
+    }
+    if (vars.getSize() > 0){
+        cplex.setPriorities(vars, priorities);
+    }
+    priorities.end();
+    vars.end();
 }
 
 /* Set up objective function. */
 void Model::setObjective(){
 
-    std::cout << "\t Setting up objective function... " << std::endl;
+    buildLog << "\t Setting up objective function... " << std::endl;
 
 	IloExpr exp(env);
   	for(NodeIt n(data.getGraph()); n != lemon::INVALID; ++n) {
@@ -454,15 +603,21 @@ void Model::setObjective(){
 /* Set up constraints. */
 void Model::setConstraints(){
 
-    std::cout << "\t Setting up constraints... " << std::endl;
+    buildLog << "\t Setting up constraints... " << std::endl;
 
-    setRoutingConstraints();
+    demandRows.clear();
+    for (int k = 0; k < data.getNbDemands(); k++){
+        demandRows.push_back(IloRangeArray(env));
+    }
+    if (!isRoutingDelegated()){
+        setRoutingConstraints();
+        setArcCapacityConstraints();
+        setLatencyConstraints();
+        setDegreeConstraints();
+    }
     setNodeCapacityConstraints();
-    setArcCapacityConstraints();
-    setLatencyConstraints();
     setLinkingConstraints();
     setDisjunctionConstraints();
-    setDegreeConstraints();
 
     if (data.getInput().isBasic() == false){
         setSymmetryBreakingConstraints();
@@ -478,70 +633,116 @@ void Model::setConstraints(){
     }
 */
     model.add(constraints);
+    for (int k = 0; k < data.getNbDemands(); k++){
+        model.add(demandRows[k]);
+    }
+}
 
+/* Set up the constraints involving demand k only, in the same order as setConstraints. */
+void Model::setDemandConstraints(const int k){
+    if (!isRoutingDelegated()){
+        setRoutingConstraints(k);
+        setLatencyConstraints(k);
+        setDegreeConstraints(k);
+    }
+    setLinkingConstraints(k);
+    setDisjunctionConstraints(k);
+
+    if (data.getInput().isBasic() == false){
+        setSymmetryBreakingConstraints(k);
+        setPathAvailApproxConstraints(k);
+        setConfigAvailApproxConstraints(k);
+    }
+    model.add(demandRows[k]);
+}
+
+/* Adds the terms of demand k to the node and arc capacity constraints shared by every demand. */
+void Model::setCapacityTerms(const int k){
+    for (int v = 0; v < nodeCapacityRows.getSize(); v++){
+        for (int i = 0; i < data.getDemand(k).getNbVNFs(); i++){
+            for (int p = 0; p < data.getNbPaths(k); p++){
+                int vnf = data.getDemand(k).getVNF_i(i);
+                double coeff = data.getDemand(k).getBandwidth() * data.getVnf(vnf).getConsumption();
+                nodeCapacityRows[v].setLinearCoef(x[k][v][i][p], coeff);
+            }
+        }
+    }
+    for (int a = 0; a < arcCapacityRows.getSize(); a++){
+        for (int i = 0; i < data.getDemand(k).getNbVNFs(); i++){
+            for (int p = 0; p < data.getNbPaths(k); p++){
+                arcCapacityRows[a].setLinearCoef(f[k][a][i][p], data.getDemand(k).getBandwidth());
+            }
+        }
+    }
 }
 
 /* Add up the routing constraints: flow conservation constraints among sections */
 void Model::setRoutingConstraints()
 {
-    std::cout << "\t > Setting up routing constraints. " << std::endl;
+    buildLog << "\t > Setting up routing constraints. " << std::endl;
 
     for (int k = 0; k < data.getNbDemands(); k++){
-        const int NB_PATHS = data.getNbPaths(k);
-        int o_k = data.getDemand(k).getSource();
-        int d_k = data.getDemand(k).getTarget();
-        for (int p = 0; p < NB_PATHS; p++){
-            const int NB_SECTIONS = data.getDemand(k).getNbVNFs() + 1;
-            for (int i = 0; i < NB_SECTIONS; i++){
-                for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-                    int v = data.getNodeId(n);
-                    
-                    IloExpr exp(env);
-                    for (Graph::OutArcIt it(data.getGraph(), n); it != lemon::INVALID; ++it){
-                        int a = data.getArcId(it);
-                        exp += f[k][a][i][p];
+        setRoutingConstraints(k);
+    }
+}
+
+/* Add up the routing constraints of demand k. */
+void Model::setRoutingConstraints(const int k)
+{
+    const int NB_PATHS = data.getNbPaths(k);
+    int o_k = data.getDemand(k).getSource();
+    int d_k = data.getDemand(k).getTarget();
+    for (int p = 0; p < NB_PATHS; p++){
+        const int NB_SECTIONS = data.getDemand(k).getNbVNFs() + 1;
+        for (int i = 0; i < NB_SECTIONS; i++){
+            for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
+                int v = data.getNodeId(n);
+                
+                IloExpr exp(env);
+                for (Graph::OutArcIt it(data.getGraph(), n); it != lemon::INVALID; ++it){
+                    int a = data.getArcId(it);
+                    exp += f[k][a][i][p];
+                }
+                for (Graph::InArcIt it(data.getGraph(), n); it != lemon::INVALID; ++it){
+                    int a = data.getArcId(it);
+                    exp -= f[k][a][i][p];
+                }
+                
+                /* First section; */
+                if (i == 0){
+                    /* Source node; */
+                    if (v == o_k){
+                        exp -= alpha[k][p];
+                        exp += x[k][o_k][i][p];
                     }
-                    for (Graph::InArcIt it(data.getGraph(), n); it != lemon::INVALID; ++it){
-                        int a = data.getArcId(it);
-                        exp -= f[k][a][i][p];
+                    /* Not source */
+                    else{
+                        exp += x[k][v][i][p];
                     }
-                    
-                    /* First section; */
-                    if (i == 0){
-                        /* Source node; */
-                        if (v == o_k){
-                            exp -= alpha[k][p];
-                            exp += x[k][o_k][i][p];
+                }
+                else{
+                    /* Last section */
+                    if (i == NB_SECTIONS-1){
+                        /* Target node; */
+                        if (v == d_k){
+                            exp -= x[k][d_k][i-1][p];
+                            exp += alpha[k][p];
                         }
-                        /* Not source */
+                        /* Not target */
                         else{
-                            exp += x[k][v][i][p];
-                        }
+                            exp -= x[k][v][i-1][p];
+                        }      
                     }
+                    /* other sections */
                     else{
-                        /* Last section */
-                        if (i == NB_SECTIONS-1){
-                            /* Target node; */
-                            if (v == d_k){
-                                exp -= x[k][d_k][i-1][p];
-                                exp += alpha[k][p];
-                            }
-                            /* Not target */
-                            else{
-                                exp -= x[k][v][i-1][p];
-                            }      
-                        }
-                        /* other sections */
-                        else{
-                            exp += x[k][v][i][p];
-                            exp -= x[k][v][i-1][p];
-                        }
+                        exp += x[k][v][i][p];
+                        exp -= x[k][v][i-1][p];
                     }
-                    std::string name = "Routing(" + std::to_string(k) + "," + std::to_string(p) + "," + std::to_string(i) + "," + std::to_string(v) + ")";
-                    constraints.add(IloRange(env, 0, exp, 0, name.c_str()));
-                    exp.clear();
-                    exp.end();
                 }
+                std::string name = "Routing(" + std::to_string(k) + "," + std::to_string(p) + "," + std::to_string(i) + "," + std::to_string(v) + ")";
+                demandRows[k].add(IloRange(env, 0, exp, 0, name.c_str()));
+                exp.clear();
+                exp.end();
             }
         }
     }
@@ -551,26 +752,32 @@ void Model::setRoutingConstraints()
 /* Add up the degree constraints */
 void Model::setDegreeConstraints()
 {
-    std::cout << "\t > Setting up degree constraints. " << std::endl;
+    buildLog << "\t > Setting up degree constraints. " << std::endl;
 
     for (int k = 0; k < data.getNbDemands(); k++){
-        for (int p = 0; p < data.getNbPaths(k); p++){
-            const int NB_SECTIONS = data.getDemand(k).getNbVNFs() + 1;
-            for (int i = 0; i < NB_SECTIONS; i++){
-                for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-                    int v = data.getNodeId(n);
-                    
-                    IloExpr exp(env);
-                    for (Graph::OutArcIt it(data.getGraph(), n); it != lemon::INVALID; ++it){
-                        int a = data.getArcId(it);
-                        exp += f[k][a][i][p];
-                    }
+        setDegreeConstraints(k);
+    }
+}
 
-                    std::string name = "Degree(" + std::to_string(k) + "," + std::to_string(p) + "," + std::to_string(i) + "," + std::to_string(v) + ")";
-                    constraints.add(IloRange(env, 0, exp, 1, name.c_str()));
-                    exp.clear();
-                    exp.end();
+/* Add up the degree constraints of demand k. */
+void Model::setDegreeConstraints(const int k)
+{
+    for (int p = 0; p < data.getNbPaths(k); p++){
+        const int NB_SECTIONS = data.getDemand(k).getNbVNFs() + 1;
+        for (int i = 0; i < NB_SECTIONS; i++){
+            for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
+                int v = data.getNodeId(n);
+                
+                IloExpr exp(env);
+                for (Graph::OutArcIt it(data.getGraph(), n); it != lemon::INVALID; ++it){
+                    int a = data.getArcId(it);
+                    exp += f[k][a][i][p];
                 }
+
+                std::string name = "Degree(" + std::to_string(k) + "," + std::to_string(p) + "," + std::to_string(i) + "," + std::to_string(v) + ")";
+                demandRows[k].add(IloRange(env, 0, exp, 1, name.c_str()));
+                exp.clear();
+                exp.end();
             }
         }
     }
@@ -578,7 +785,7 @@ void Model::setDegreeConstraints()
 
 /* Add up the node capacity constraints: the bandwidth treated in a node must respect its capacity. */
 void Model::setNodeCapacityConstraints(){
-    std::cout << "\t > Setting up node capacity constraints " << std::endl;
+    buildLog << "\t > Setting up node capacity constraints " << std::endl;
     for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
         int v = data.getNodeId(n);
         IloExpr exp(env);
@@ -593,7 +800,9 @@ void Model::setNodeCapacityConstraints(){
             }
         }
         std::string name = "Node_Capacity(" + std::to_string(v) + ")";
-        constraints.add(IloRange(env, 0, exp, capacity, name.c_str()));
+        IloRange row(env, 0, exp, capacity, name.c_str());
+        constraints.add(row);
+        nodeCapacityRows.add(row);
         exp.clear();
         exp.end();
     }
@@ -601,7 +810,7 @@ void Model::setNodeCapacityConstraints(){
 
 /* Add up the arc capacity constraints: the bandwidth routed within an arc must respect its capacity. */
 void Model::setArcCapacityConstraints(){
-    std::cout << "\t > Setting up arc capacity constraints. " << std::endl;
+    buildLog << "\t > Setting up arc capacity constraints. " << std::endl;
     for (ArcIt it(data.getGraph()); it != lemon::INVALID; ++it){
         int a = data.getArcId(it);
         IloExpr exp(env);
@@ -615,7 +824,9 @@ void Model::setArcCapacityConstraints(){
             }
         }
         std::string name = "Arc_Capacity(" + std::to_string(a) + ")";
-        constraints.add(IloRange(env, 0, exp, capacity, name.c_str()));
+        IloRange row(env, 0, exp, capacity, name.c_str());
+        constraints.add(row);
+        arcCapacityRows.add(row);
         exp.clear();
         exp.end();
     }
@@ -624,122 +835,136 @@ void Model::setArcCapacityConstraints(){
 
 /* Add up the latency constraints: the path lengths must respect latency. */
 void Model::setLatencyConstraints(){
-    std::cout << "\t > Setting up latency constraints. " << std::endl;
+    buildLog << "\t > Setting up latency constraints. " << std::endl;
     for (int k = 0; k < data.getNbDemands(); k++){
-        for (int p = 0; p < data.getNbPaths(k); p++){
-            IloExpr exp(env);
-            double latency = data.getDemand(k).getMaxLatency();
-            for (ArcIt it(data.getGraph()); it != lemon::INVALID; ++it){
-                int a = data.getArcId(it);
-                for (int i = 0; i < data.getDemand(k).getNbVNFs()+1; i++){
-                    double coeff = data.getLink(a).getDelay();
-                    exp += (coeff * f[k][a][i][p]);
-                }
+        setLatencyConstraints(k);
+    }
+}
+
+/* Add up the latency constraints of demand k. */
+void Model::setLatencyConstraints(const int k){
+    for (int p = 0; p < data.getNbPaths(k); p++){
+        IloExpr exp(env);
+        double latency = data.getDemand(k).getMaxLatency();
+        for (ArcIt it(data.getGraph()); it != lemon::INVALID; ++it){
+            int a = data.getArcId(it);
+            for (int i = 0; i < data.getDemand(k).getNbVNFs()+1; i++){
+                double coeff = data.getLink(a).getDelay();
+                exp += (coeff * f[k][a][i][p]);
             }
-            std::string name = "Latency(" + std::to_string(k) + "," + std::to_string(p) + ")";
-            constraints.add(IloRange(env, 0, exp, latency, name.c_str()));
-            exp.clear();
-            exp.end();
         }
+        std::string name = "Latency(" + std::to_string(k) + "," + std::to_string(p) + ")";
+        demandRows[k].add(IloRange(env, 0, exp, latency, name.c_str()));
+        exp.clear();
+        exp.end();
     }
 }
 
 /* Add up the linking constraints. */
 void Model::setLinkingConstraints(){
-    std::cout << "\t > Setting up linking constraints. " << std::endl;
+    buildLog << "\t > Setting up linking constraints. " << std::endl;
+    for (int k = 0; k < data.getNbDemands(); k++){
+        setLinkingConstraints(k);
+    }
+}
 
+/* Add up the linking constraints of demand k. */
+void Model::setLinkingConstraints(const int k){
     /* linking variables alpha-x */
-    for (int k = 0; k < data.getNbDemands(); k++){
-        for (int p = 0; p < data.getNbPaths(k); p++){
-            for (int i = 0; i < data.getDemand(k).getNbVNFs(); i++){
-                IloExpr exp(env);
-                for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-                    int v = data.getNodeId(n);
-                    exp += x[k][v][i][p];
-                }
-                exp -= alpha[k][p];
-                std::string name = "Linking_alpha(" + std::to_string(k) + "," + std::to_string(p) + "," + std::to_string(i) + ")";
-                constraints.add(IloRange(env, 0, exp, 0, name.c_str()));
-                exp.clear();
-                exp.end();
+    for (int p = 0; p < data.getNbPaths(k); p++){
+        for (int i = 0; i < data.getDemand(k).getNbVNFs(); i++){
+            IloExpr exp(env);
+            for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
+                int v = data.getNodeId(n);
+                exp += x[k][v][i][p];
             }
+            exp -= alpha[k][p];
+            std::string name = "Linking_alpha(" + std::to_string(k) + "," + std::to_string(p) + "," + std::to_string(i) + ")";
+            demandRows[k].add(IloRange(env, 0, exp, 0, name.c_str()));
+            exp.clear();
+            exp.end();
         }
     }
 
-    
     /* linking variables x-y */
-    for (int k = 0; k < data.getNbDemands(); k++){
-        for (int p = 0; p < data.getNbPaths(k); p++){
-            for (int i = 0; i < data.getDemand(k).getNbVNFs(); i++){
-                for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-                    int v = data.getNodeId(n);
-                    IloExpr exp(env);
-                    exp += x[k][v][i][p];
-                    exp -= y[k][v][p];
-                    std::string name = "Linking_x(" + std::to_string(k) + "," + std::to_string(p) + "," + std::to_string(i) +"," + std::to_string(v) + ")";
-                    constraints.add(IloRange(env, -1, exp, 0, name.c_str()));
-                    exp.clear();
-                    exp.end();
-                }
-            }
-        }
-    }
-
-    /* linking variables x-z */
-    for (int k = 0; k < data.getNbDemands(); k++){
+    for (int p = 0; p < data.getNbPaths(k); p++){
         for (int i = 0; i < data.getDemand(k).getNbVNFs(); i++){
-            int f = data.getDemand(k).getVNF_i(i);
             for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
                 int v = data.getNodeId(n);
                 IloExpr exp(env);
-                
-                for (int p = 0; p < data.getNbPaths(k); p++){
-                    exp += x[k][v][i][p];
-                }
-                exp -= z[v][f];
-                std::string name = "Linking_z(" + std::to_string(k) + + "," + std::to_string(i) +"," + std::to_string(v) + ")";
-                constraints.add(IloRange(env, -1, exp, 0, name.c_str()));
+                exp += x[k][v][i][p];
+                exp -= y[k][v][p];
+                std::string name = "Linking_x(" + std::to_string(k) + "," + std::to_string(p) + "," + std::to_string(i) +"," + std::to_string(v) + ")";
+                demandRows[k].add(IloRange(env, -1, exp, 0, name.c_str()));
                 exp.clear();
                 exp.end();
             }
         }
     }
-}
 
-/* Add up the vnf disjunction constraints: a node cannot host more than one VNF for the same demand. */
-void Model::setDisjunctionConstraints(){
-    std::cout << "\t > Setting up vnf disjunction constraints. " << std::endl;
-    
-    for (int k = 0; k < data.getNbDemands(); k++){
+    /* linking variables x-z */
+    for (int i = 0; i < data.getDemand(k).getNbVNFs(); i++){
+        int f = data.getDemand(k).getVNF_i(i);
         for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
             int v = data.getNodeId(n);
             IloExpr exp(env);
+            
             for (int p = 0; p < data.getNbPaths(k); p++){
-                exp += y[k][v][p];
+                exp += x[k][v][i][p];
             }
-            std::string name = "Disjuction(" + std::to_string(k) + "," + std::to_string(v) + ")";
-            constraints.add(IloRange(env, 0, exp, 1, name.c_str()));
+            exp -= z[v][f];
+            std::string name = "Linking_z(" + std::to_string(k) + + "," + std::to_string(i) +"," + std::to_string(v) + ")";
+            demandRows[k].add(IloRange(env, -1, exp, 0, name.c_str()));
             exp.clear();
             exp.end();
         }
     }
 }
 
+/* Add up the vnf disjunction constraints: a node cannot host more than one VNF for the same demand. */
+void Model::setDisjunctionConstraints(){
+    buildLog << "\t > Setting up vnf disjunction constraints. " << std::endl;
+    
+    for (int k = 0; k < data.getNbDemands(); k++){
+        setDisjunctionConstraints(k);
+    }
+}
+
+/* Add up the vnf disjunction constraints of demand k. */
+void Model::setDisjunctionConstraints(const int k){
+    for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
+        int v = data.getNodeId(n);
+        IloExpr exp(env);
+        for (int p = 0; p < data.getNbPaths(k); p++){
+            exp += y[k][v][p];
+        }
+        std::string name = "Disjuction(" + std::to_string(k) + "," + std::to_string(v) + ")";
+        demandRows[k].add(IloRange(env, 0, exp, 1, name.c_str()));
+        exp.clear();
+        exp.end();
+    }
+}
+
 
 /*  */
 void Model::setSymmetryBreakingConstraints(){
-    std::cout << "\t > Setting up symmetry breaking constraints. " << std::endl;
+    buildLog << "\t > Setting up symmetry breaking constraints. " << std::endl;
     
     for (int k = 0; k < data.getNbDemands(); k++){
-        for (int p = 0; p < data.getNbPaths(k)-1; p++){
-            IloExpr exp(env);
-            exp += alpha[k][p+1];
-            exp -= alpha[k][p];
-            std::string name = "Symm(" + std::to_string(k) + "," + std::to_string(p) + ")";
-            constraints.add(IloRange(env, -1, exp, 0, name.c_str()));
-            exp.clear();
-            exp.end();
-        }
+        setSymmetryBreakingConstraints(k);
+    }
+}
+
+/* Add up the symmetry breaking constraints of demand k: paths are activated in order. */
+void Model::setSymmetryBreakingConstraints(const int k){
+    for (int p = 0; p < data.getNbPaths(k)-1; p++){
+        IloExpr exp(env);
+        exp += alpha[k][p+1];
+        exp -= alpha[k][p];
+        std::string name = "Symm(" + std::to_string(k) + "," + std::to_string(p) + ")";
+        demandRows[k].add(IloRange(env, -1, exp, 0, name.c_str()));
+        exp.clear();
+        exp.end();
     }
 }
 
@@ -797,74 +1022,119 @@ void Model::buildApproximationFunctionAvail(int k, IloNumArray &breakpoints, Ilo
     }
 }
 
-void Model::setPathAvailApproxConstraints(){
-    std::cout << "\t > Setting up approximated path availability constraints. " << std::endl;
-    
-    for (int k = 0; k < data.getNbDemands(); k++){
-        IloNumArray breakpoints(env);
-        IloNumArray slopes(env);
-        buildApproximationFunctionAvail(k, breakpoints, slopes);
-        // /** TEST WITH ANOTHER PIECEWISE DESCRIPTION **/
-        // IloNumArray coord_X(env);
-        // IloNumArray coord_Y(env);
-        // for (unsigned int i = 0; i < avail_breakpoints[k].size(); i++){
-        //     coord_X.add(avail_breakpoints[k][i]);
-        //     coord_Y.add(std::log(avail_breakpoints[k][i]));
-        // }
-        // double firstSlope = (1.0/avail_breakpoints[k][0]);
-        // double lastSlope = (1.0/avail_breakpoints[k][avail_breakpoints[k].size()-1]);
-        /***********************************************/
+/* Add up the piecewise linear rows approximating the log of the path availabilities of demand k. */
+void Model::setPathAvailApproxRows(const int k){
+    /* Secant through the extreme touches: a relaxation without binaries, completed by the callback cuts. */
+    if (data.getInput().isAvailabilityCutsOn()){
+        const double FIRST = avail_touch[k].front();
+        const double LAST  = avail_touch[k].back();
+        const double SLOPE = (std::log(LAST) - std::log(FIRST)) / (LAST - FIRST);
         for (int p = 0; p < data.getNbPaths(k); p++){
             IloExpr exp(env);
             exp += approx_log_avail[k][p];
-            exp -= IloPiecewiseLinear(avail[k][p], breakpoints, slopes, avail_touch[k][0], std::log(avail_touch[k][0]));
-            // exp -= IloPiecewiseLinear(avail[k][p], firstSlope, coord_X, coord_Y, lastSlope);
-            std::string name = "approx_avail(" + std::to_string(k) + "," + std::to_string(p) + ")";
-            constraints.add(IloRange(env, 0, exp, 0, name.c_str()));
-            exp.clear();
+            exp -= SLOPE * avail[k][p];
+            std::string name = "secant_avail(" + std::to_string(k) + "," + std::to_string(p) + ")";
+            IloRange row(env, std::log(FIRST) - SLOPE * FIRST, exp, IloInfinity, name.c_str());
+            approxRows[k].add(row);
+            model.add(row);
             exp.end();
         }
+        return;
     }
-
-    for (int k = 0; k < data.getNbDemands(); k++){
+    IloNumArray breakpoints(env);
+    IloNumArray slopes(env);
+    buildApproximationFunctionAvail(k, breakpoints, slopes);
+    if (data.getInput().getPwlEncoding() != Input::PWL_ENCODING_NATIVE){
+        Encoder encoder(env, data.getInput().getPwlEncoding(), breakpoints, slopes, avail_touch[k][0], std::log(avail_touch[k][0]), 0.0, 1.0);
         for (int p = 0; p < data.getNbPaths(k); p++){
-            IloExpr exp(env);
-            exp += approx_log_avail[k][p];
-            for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-                int v = data.getNodeId(n);
-                exp -= std::log(data.getNode(v).getAvailability()) * y[k][v][p];
-            }
-            std::string name = "avail(" + std::to_string(k) + "," + std::to_string(p) + ")";
-            constraints.add(IloRange(env, -IloInfinity, exp, 0, name.c_str()));
-            exp.clear();
-            exp.end();
+            std::string name = "approx_avail(" + std::to_string(k) + "," + std::to_string(p) + ")";
+            addEncodedRows(k, encoder, avail[k][p], approx_log_avail[k][p], name);
         }
+        breakpoints.end();
+        slopes.end();
+        return;
     }
+    // /** TEST WITH ANOTHER PIECEWISE DESCRIPTION **/
+    // IloNumArray coord_X(env);
+    // IloNumArray coord_Y(env);
+    // for (unsigned int i = 0; i < avail_breakpoints[k].size(); i++){
+    //     coord_X.add(avail_breakpoints[k][i]);
+    //     coord_Y.add(std::log(avail_breakpoints[k][i]));
+    // }
+    // double firstSlope = (1.0/avail_breakpoints[k][0]);
+    // double lastSlope = (1.0/avail_breakpoints[k][avail_breakpoints[k].size()-1]);
+    /***********************************************/
+    for (int p = 0; p < data.getNbPaths(k); p++){
+        IloExpr exp(env);
+        exp += approx_log_avail[k][p];
+        exp -= IloPiecewiseLinear(avail[k][p], breakpoints, slopes, avail_touch[k][0], std::log(avail_touch[k][0]));
+        // exp -= IloPiecewiseLinear(avail[k][p], firstSlope, coord_X, coord_Y, lastSlope);
+        std::string name = "approx_avail(" + std::to_string(k) + "," + std::to_string(p) + ")";
+        IloRange row(env, 0, exp, 0, name.c_str());
+        approxRows[k].add(row);
+        model.add(row);
+        exp.clear();
+        exp.end();
+    }
+}
 
-    for (int k = 0; k < data.getNbDemands(); k++){
-        for (int p = 0; p < data.getNbPaths(k); p++){
-            IloExpr exp(env);
-            double avail_ub = data.getChainAvailability(data.getNMostAvailableNodes(1));
-            exp += avail[k][p];
-            exp -= avail_ub*alpha[k][p];
-            std::string name = "availImposition(" + std::to_string(k) + "," + std::to_string(p) + ")";
-            constraints.add(IloRange(env, -IloInfinity, exp, 0, name.c_str()));
-            exp.clear();
-            exp.end();
-        }
+/* Adds the explicit encoding of y = f(x) to the model and to the approximation rows of demand k. */
+void Model::addEncodedRows(const int k, const Encoder& encoder, const IloNumVar& x, const IloNumVar& y, const std::string& name){
+    IloExtractableArray rows(env);
+    encoder.encode(x, y, name, rows);
+    for (int i = 0; i < rows.getSize(); i++){
+        approxRows[k].add(rows[i]);
+        model.add(rows[i]);
     }
+    rows.end();
+}
+
+void Model::setPathAvailApproxConstraints(){
+    buildLog << "\t > Setting up approximated path availability constraints. " << std::endl;
     
     for (int k = 0; k < data.getNbDemands(); k++){
-        for (int p = 0; p < data.getNbPaths(k); p++){
-            IloExpr exp(env);
-            double avail_lb = data.getChainAvailability(data.getNLeastAvailableNodes(data.getDemand(k).getNbVNFs()));
-            exp += avail[k][p];
-            exp -= avail_lb*alpha[k][p];
-            std::string name = "avail_lb(" + std::to_string(k) + "," + std::to_string(p) + ")";
-            constraints.add(IloRange(env, 0, exp, IloInfinity, name.c_str()));
-            exp.clear();
-            exp.end();
+        approxRows.push_back(IloExtractableArray(env));
+        setPathAvailApproxConstraints(k);
+    }
+}
+
+/* Add up the approximated path availability constraints of demand k. */
+void Model::setPathAvailApproxConstraints(const int k){
+    setPathAvailApproxRows(k);
+
+    for (int p = 0; p < data.getNbPaths(k); p++){
+        IloExpr exp(env);
+        exp += approx_log_avail[k][p];
+        for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
+            int v = data.getNodeId(n);
+            exp -= std::log(data.getNode(v).getAvailability()) * y[k][v][p];
         }
+        std::string name = "avail(" + std::to_string(k) + "," + std::to_string(p) + ")";
+        demandRows[k].add(IloRange(env, -IloInfinity, exp, 0, name.c_str()));
+        exp.clear();
+        exp.end();
+    }
+
+    for (int p = 0; p < data.getNbPaths(k); p++){
+        IloExpr exp(env);
+        double avail_ub = data.getChainAvailability(data.getNMostAvailableNodes(1));
+        exp += avail[k][p];
+        exp -= avail_ub*alpha[k][p];
+        std::string name = "availImposition(" + std::to_string(k) + "," + std::to_string(p) + ")";
+        demandRows[k].add(IloRange(env, -IloInfinity, exp, 0, name.c_str()));
+        exp.clear();
+        exp.end();
+    }
+    
+    for (int p = 0; p < data.getNbPaths(k); p++){
+        IloExpr exp(env);
+        double avail_lb = data.getChainAvailability(data.getNLeastAvailableNodes(data.getDemand(k).getNbVNFs()));
+        exp += avail[k][p];
+        exp -= avail_lb*alpha[k][p];
+        std::string name = "avail_lb(" + std::to_string(k) + "," + std::to_string(p) + ")";
+        demandRows[k].add(IloRange(env, 0, exp, IloInfinity, name.c_str()));
+        exp.clear();
+        exp.end();
     }
 }
 
@@ -893,99 +1163,806 @@ void Model::buildApproximationFunctionUnavail(int k, IloNumArray &breakpoints, I
     }
 }
 
-void Model::setConfigAvailApproxConstraints(){
-    /** avail[k][p] = 1 - unavail[k][p] ***/
-    std::cout << "\t > Setting up approximated config availability constraints. " << std::endl;
-    
-    for (int k = 0; k < data.getNbDemands(); k++){
-        IloNumArray breakpoints(env);
-        IloNumArray slopes(env);
-        buildApproximationFunctionUnavail(k, breakpoints, slopes);
-        // /** TEST WITH ANOTHER PIECEWISE DESCRIPTION **/
-        // IloNumArray coord_X(env);
-        // IloNumArray coord_Y(env);
-        // for (unsigned int i = 0; i < unavail_breakpoints[k].size(); i++){
-        //     coord_X.add(unavail_breakpoints[k][i]);
-        //     coord_Y.add(std::log(unavail_breakpoints[k][i]));
-        // }
-        // double firstSlope = (1.0/unavail_breakpoints[k][0]);
-        // double lastSlope = (1.0/unavail_breakpoints[k][unavail_breakpoints[k].size()-1]);
-        /***********************************************/
+/* Add up the piecewise linear rows approximating the log of the path unavailabilities of demand k. */
+void Model::setConfigAvailApproxRows(const int k){
+    if (data.getInput().isAvailabilityCutsOn()){
+        const double FIRST = unavail_touch[k].front();
+        const double SLOPE = -std::log(FIRST) / (1.0 - FIRST);
         for (int p = 0; p < data.getNbPaths(k); p++){
             IloExpr exp(env);
             exp += approx_log_unavail[k][p];
-            exp -= IloPiecewiseLinear(unavail[k][p], breakpoints, slopes, 1, 0);
-            // exp -= IloPiecewiseLinear(unavail[k][p], firstSlope, coord_X, coord_Y, lastSlope);
-            std::string name = "approx_unavail(" + std::to_string(k) + "," + std::to_string(p) + ")";
-            constraints.add(IloRange(env, 0, exp, 0, name.c_str()));
-            exp.clear();
+            exp -= SLOPE * unavail[k][p];
+            std::string name = "secant_unavail(" + std::to_string(k) + "," + std::to_string(p) + ")";
+            IloRange row(env, -SLOPE, exp, IloInfinity, name.c_str());
+            approxRows[k].add(row);
+            model.add(row);
             exp.end();
         }
+        return;
     }
-
-    for (int k = 0; k < data.getNbDemands(); k++){
+    IloNumArray breakpoints(env);
+    IloNumArray slopes(env);
+    buildApproximationFunctionUnavail(k, breakpoints, slopes);
+    if (data.getInput().getPwlEncoding() != Input::PWL_ENCODING_NATIVE){
+        Encoder encoder(env, data.getInput().getPwlEncoding(), breakpoints, slopes, 1, 0, 0.0, 1.0);
         for (int p = 0; p < data.getNbPaths(k); p++){
-            IloExpr exp(env);
-            exp += unavail[k][p];
-            exp += avail[k][p];
-            std::string name = "unavail(" + std::to_string(k) + "," + std::to_string(p) + ")";
-            constraints.add(IloRange(env, 1, exp, 1, name.c_str()));
-            exp.clear();
-            exp.end();
+            std::string name = "approx_unavail(" + std::to_string(k) + "," + std::to_string(p) + ")";
+            addEncodedRows(k, encoder, unavail[k][p], approx_log_unavail[k][p], name);
         }
+        breakpoints.end();
+        slopes.end();
+        return;
     }
+    // /** TEST WITH ANOTHER PIECEWISE DESCRIPTION **/
+    // IloNumArray coord_X(env);
+    // IloNumArray coord_Y(env);
+    // for (unsigned int i = 0; i < unavail_breakpoints[k].size(); i++){
+    //     coord_X.add(unavail_breakpoints[k][i]);
+    //     coord_Y.add(std::log(unavail_breakpoints[k][i]));
+    // }
+    // double firstSlope = (1.0/unavail_breakpoints[k][0]);
+    // double lastSlope = (1.0/unavail_breakpoints[k][unavail_breakpoints[k].size()-1]);
+    /***********************************************/
+    for (int p = 0; p < data.getNbPaths(k); p++){
+        IloExpr exp(env);
+        exp += approx_log_unavail[k][p];
+        exp -= IloPiecewiseLinear(unavail[k][p], breakpoints, slopes, 1, 0);
+        // exp -= IloPiecewiseLinear(unavail[k][p], firstSlope, coord_X, coord_Y, lastSlope);
+        std::string name = "approx_unavail(" + std::to_string(k) + "," + std::to_string(p) + ")";
+        IloRange row(env, 0, exp, 0, name.c_str());
+        approxRows[k].add(row);
+        model.add(row);
+        exp.clear();
+        exp.end();
+    }
+}
 
+void Model::setConfigAvailApproxConstraints(){
+    /** avail[k][p] = 1 - unavail[k][p] ***/
+    buildLog << "\t > Setting up approximated config availability constraints. " << std::endl;
+    
+    availabilityRows.resize(data.getNbDemands());
     for (int k = 0; k < data.getNbDemands(); k++){
+        setConfigAvailApproxConstraints(k);
+    }
+}
+
+/* Add up the approximated configuration availability constraints of demand k. */
+void Model::setConfigAvailApproxConstraints(const int k){
+    setConfigAvailApproxRows(k);
+
+    for (int p = 0; p < data.getNbPaths(k); p++){
         IloExpr exp(env);
-        for (int p = 0; p < data.getNbPaths(k); p++){
-            exp += approx_log_unavail[k][p];
-        }
-        std::string name = "ReqAvail(" + std::to_string(k) + ")";
-        double rhs = std::log(1.0 - data.getDemand(k).getAvailability());
-        constraints.add(IloRange(env, -IloInfinity, exp, rhs, name.c_str()));
+        exp += unavail[k][p];
+        exp += avail[k][p];
+        std::string name = "unavail(" + std::to_string(k) + "," + std::to_string(p) + ")";
+        demandRows[k].add(IloRange(env, 1, exp, 1, name.c_str()));
         exp.clear();
         exp.end();
     }
+
+    IloExpr exp(env);
+    for (int p = 0; p < data.getNbPaths(k); p++){
+        exp += approx_log_unavail[k][p];
+    }
+    std::string name = "ReqAvail(" + std::to_string(k) + ")";
+    double rhs = std::log(1.0 - data.getDemand(k).getAvailability());
+    availabilityRows[k] = IloRange(env, -IloInfinity, exp, rhs, name.c_str());
+    demandRows[k].add(availabilityRows[k]);
+    exp.clear();
+    exp.end();
 }
 
 void Model::run()
 {
-    cplex.exportModel("mip.lp");
-    time = cplex.getCplexTime();
-	cplex.solve();
+    exportModel();
+    try
+    {
+        /* Starts of earlier runs are stale: a resident model would otherwise retry them all. */
+        cplex.deleteMIPStarts(0, cplex.getNMIPStarts());
+        if (data.getInput().getInitialHeuristic() == Input::INITIAL_HEURISTIC_ON && !data.getInput().isRelaxation()){
+            setInitialSolution();
+        }
+        if (!data.getInput().isRelaxation()){
+            setWarmStart();
+        }
+        /* The refinement shortens the time limit of its successive solves. */
+        cplex.setParam(IloCplex::Param::TimeLimit, timeLimit);
+        if (data.getInput().getLns() == Input::LNS_ON && !data.getInput().isRelaxation()){
+            startLns();
+        }
+        time = cplex.getCplexTime();
+        if (data.getInput().isRefinementOn()){
+            solveWithRefinement();
+        }
+        else{
+            cplex.solve();
+        }
+
+        /* Get final execution time */
+        time = cplex.getCplexTime() - time;
+
+        /* The refinement already extracts the solution of each of its solves. */
+        if (!data.getInput().isRefinementOn() && (cplex.getStatus() == IloAlgorithm::Feasible || cplex.getStatus() == IloAlgorithm::Optimal)){
+            extractSolution();
+        }
+    }
+    catch (...)
+    {
+        /* Threads still joinable while unwinding would terminate the program. */
+        stopLns();
+        if (exportThread.joinable()){
+            exportThread.join();
+        }
+        throw;
+    }
+
+    stopLns();
+
+    if (exportThread.joinable()){
+        exportThread.join();
+    }
+}
+
+/* Solves the MIP from a coarse availability approximation, refining it around the availabilities used by violated demands. */
+void Model::solveWithRefinement()
+{
+    const double TIME_LIMIT = timeLimit;
+    int round = 0;
+    while (cplex.solve()){
+        extractSolution();
+        /* Refine the demands whose true availability is not met. */
+        int nbViolated = 0;
+        int nbRefined = 0;
+        for (int k = 0; k < data.getNbDemands(); k++){
+            if (solution.getPlacementAvailability(k) >= data.getDemand(k).getAvailability()){
+                continue;
+            }
+            nbViolated++;
+            if (round < data.getInput().getRefinementIterations()){
+                std::vector<double> pathAvail;
+                for (int p = 0; p < data.getNbPaths(k); p++){
+                    if (solution.isActive(k, p)){
+                        pathAvail.push_back(solution.getPathAvailability(k, p));
+                    }
+                }
+                if (refineApproximation(k, pathAvail)){
+                    nbRefined++;
+                }
+            }
+        }
+        round++;
+        std::cout << "\t Refinement round " << round << ": " << nbViolated << " demands violate availability, " << nbRefined << " were refined." << std::endl;
+        if (nbViolated == 0 || callback->isAvailabilityLazyRequired()){
+            return;
+        }
+        /* Nothing left to refine: let the callback enforce availability exactly. */
+        if (nbRefined == 0){
+            callback->setAvailabilityCheck(true);
+            cplex.use(callback, callback->getContextMask());
+        }
+
+        /* Warm start from the integer part of the previous solution. */
+        IloNumArray vals(env);
+        cplex.getValues(vals, solutionVars);
+        IloNumVarArray startVar(env);
+        IloNumArray startVal(env);
+        const int NB_INTEGER = demandVarRange.back().second + (int)(z.size() * z[0].size());
+        for (int j = 0; j < NB_INTEGER; j++){
+            startVar.add(solutionVars[j]);
+            startVal.add(std::round(vals[j]));
+        }
+        cplex.deleteMIPStarts(0, cplex.getNMIPStarts());
+        cplex.addMIPStart(startVar, startVal, IloCplex::MIPStartRepair, "refinement");
+        vals.end();
+        startVar.end();
+        startVal.end();
+
+        const double REMAINING = TIME_LIMIT - (cplex.getCplexTime() - time);
+        if (REMAINING <= 0.0){
+            break;
+        }
+        cplex.setParam(IloCplex::Param::TimeLimit, REMAINING);
+    }
+    /* The last solution found violates availability, or the last solve found none. */
+    solution.clear();
+}
+
+/* Adds touches at given path availabilities of a demand and rebuilds its approximation rows. */
+bool Model::refineApproximation(const int k, const std::vector<double>& pathAvail)
+{
+    bool inserted = false;
+    for (unsigned int j = 0; j < pathAvail.size(); j++){
+        inserted |= insertTouch(avail_touch[k], pathAvail[j]);
+        inserted |= insertTouch(unavail_touch[k], 1.0 - pathAvail[j]);
+    }
+    if (!inserted){
+        return false;
+    }
+    initialFormulation = false;
+    buildAvailBreakpoints(k);
+    buildUnavailBreakpoints(k);
+    model.remove(approxRows[k]);
+    approxRows[k].endElements();
+    approxRows[k].clear();
+    setPathAvailApproxRows(k);
+    setConfigAvailApproxRows(k);
+    return true;
+}
+
+/* Reads CPLEX's solution with a single bulk query and caches it. Values are decoded by walking the solution variables in the order they were flattened. */
+void Model::extractSolution()
+{
+    IloNumArray values(env);
+    cplex.getValues(values, solutionVars);
+    solution.clear();
 
-	/* Get final execution time */
-	time = cplex.getCplexTime() - time;
+    /* The integer values are kept to warm start the next solve, should the demands change. */
+    warmStart.resize(data.getNbDemands());
+    for (int k = 0; k < data.getNbDemands(); k++){
+        warmStart[k].clear();
+        for (int j = demandVarRange[k].first; j < demandVarRange[k].second; j++){
+            warmStart[k].push_back(values[j]);
+        }
+    }
+    warmPlacement.clear();
+    const int FIRST_PLACEMENT = demandVarRange.empty() ? 0 : demandVarRange.back().second;
+    for (int j = FIRST_PLACEMENT; j < FIRST_PLACEMENT + (int)(z.size() * z[0].size()); j++){
+        warmPlacement.push_back(values[j]);
+    }
+
+    int j = 0;
+    for (int k = 0; k < data.getNbDemands(); k++){
+        const int NB_PATHS    = (int)alpha[k].size();
+        const int NB_SECTIONS = data.getDemand(k).getNbVNFs() + 1;
+        for (int p = 0; p < NB_PATHS; p++){
+            solution.setActive(k, p, values[j++] > 1 - EPS);
+        }
+        /* sectionArcs[i][p] are the arcs used by section i of path p, in arc order. */
+        std::vector<std::vector<std::vector<int> > > sectionArcs(NB_SECTIONS, std::vector<std::vector<int> >(NB_PATHS));
+        for (unsigned int a = 0; a < f[k].size(); a++){
+            for (unsigned int i = 0; i < f[k][a].size(); i++){
+                for (unsigned int p = 0; p < f[k][a][i].size(); p++){
+                    if (values[j++] > 1 - EPS){
+                        sectionArcs[i][p].push_back(a);
+                    }
+                }
+            }
+        }
+        for (unsigned int v = 0; v < x[k].size(); v++){
+            for (unsigned int i = 0; i < x[k][v].size(); i++){
+                for (unsigned int p = 0; p < x[k][v][i].size(); p++){
+                    if (values[j++] > 1 - EPS){
+                        solution.setHost(k, p, i, v);
+                    }
+                }
+            }
+        }
+        for (unsigned int v = 0; v < y[k].size(); v++){
+            for (unsigned int p = 0; p < y[k][v].size(); p++){
+                if (values[j++] > 1 - EPS){
+                    solution.addUsedNode(k, p, v);
+                }
+            }
+        }
+        for (int p = 0; p < NB_PATHS && !f[k].empty(); p++){
+            for (int i = 0; i < NB_SECTIONS; i++){
+                solution.setSection(k, p, i, sectionArcs[i][p]);
+            }
+        }
+    }
+    for (unsigned int v = 0; v < z.size(); v++){
+        for (unsigned int vnf = 0; vnf < z[v].size(); vnf++){
+            solution.setPlacement(v, vnf, values[j++] > 1 - EPS);
+        }
+    }
+    /* avail and approx_log_avail come first among the continuous variables. */
+    int nbPathVars = 0;
+    for (unsigned int k = 0; k < avail.size(); k++){
+        nbPathVars += (int)avail[k].size();
+    }
+    for (unsigned int k = 0; k < avail.size(); k++){
+        for (unsigned int p = 0; p < avail[k].size(); p++){
+            solution.setAvailValues(k, p, values[j], values[j + nbPathVars]);
+            j++;
+        }
+    }
+    solution.setObjValue(cplex.getObjValue());
+    values.end();
+    validator.validate(solution);
+}
+
+/* Builds the variables and constraints of a demand added to the data. */
+void Model::addDemand(const int k)
+{
+    if (k != (int)alpha.size() || k >= data.getNbDemands()){
+        std::cerr << "ERROR: Demand " << k << " is not the next demand of the data." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (isRoutingDelegated()){
+        std::cerr << "ERROR: Demands cannot be added to the Benders master." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::cout << "=> Adding demand " << k << " ..." << std::endl;
+    f.resize(k+1);
+    x.resize(k+1);
+    y.resize(k+1);
+    alpha.resize(k+1);
+    if (data.getInput().isRelaxation() == false){
+        avail.resize(k+1);
+        approx_log_avail.resize(k+1);
+        unavail.resize(k+1);
+        approx_log_unavail.resize(k+1);
+    }
+    if (data.getInput().isBasic() == false){
+        avail_touch.resize(k+1);
+        avail_breakpoints.resize(k+1);
+        unavail_touch.resize(k+1);
+        unavail_breakpoints.resize(k+1);
+        approxRows.push_back(IloExtractableArray(env));
+        availabilityRows.resize(k+1);
+    }
+    demandRows.push_back(IloRangeArray(env));
+    warmStart.resize(k+1);
+
+    setDemand(k);
+    refreshDemands();
+}
+
+/* Removes the variables and constraints of a demand removed from the data. */
+void Model::removeDemand(const int k)
+{
+    if (!data.isDemandRemoved(k)){
+        std::cerr << "ERROR: Demand " << k << " must be removed from the data first." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::cout << "=> Removing demand " << k << " ..." << std::endl;
+    clearDemand(k);
+    refreshDemands();
+}
+
+/* Updates the requirement of a demand whose availability was changed in the data. */
+void Model::updateAvailabilityRequirement(const int k)
+{
+    std::cout << "=> Updating availability requirement of demand " << k << " ..." << std::endl;
+    initialFormulation = false;
+
+    /* A new bound on the number of paths changes every variable of the demand. */
+    if ((int)alpha[k].size() != data.getNbPaths(k)){
+        clearDemand(k);
+        setDemand(k);
+        refreshDemands();
+        return;
+    }
+
+    if (data.getInput().getNbPathsLowerBound() == Input::NB_PATHS_LOWER_BOUND_ON){
+        const int MIN_NB_PATHS = data.getMinNbNodes(data.getDemand(k).getAvailability());
+        for (unsigned int p = 0; p < alpha[k].size(); p++){
+            const double LB = ((int)p < MIN_NB_PATHS) ? 1.0 : 0.0;
+            alpha[k][p].setLB(LB);
+            /* alpha[k] comes first among the solution variables of demand k. */
+            solutionLB[demandVarRange[k].first + p] = LB;
+        }
+    }
+    if (data.getInput().isBasic() == false){
+        availabilityRows[k].setUB(std::log(1.0 - data.getDemand(k).getAvailability()));
+    }
+    /* Verdicts on the placements of demand k depend on its former requirement. */
+    callback->clearPlacementMemo();
+}
+
+/* Fixes the integer variables of a demand to given paths, until the demands are released. */
+void Model::fixDemand(const int k, const std::vector<ChainPath>& paths)
+{
+    IloNumVarArray vars(env);
+    IloNumArray vals(env);
+    std::vector<std::vector<bool> > placed(data.getNbNodes(), std::vector<bool>(data.getNbVnfs(), false));
+    addPathValues(k, paths, vars, vals, placed);
+    for (IloInt j = 0; j < vars.getSize(); j++){
+        vars[j].setBounds(vals[j], vals[j]);
+    }
+    vals.end();
+    vars.end();
+}
+
+/* Restores the bounds of the integer variables of every demand. */
+void Model::releaseDemands()
+{
+    for (int k = 0; k < data.getNbDemands(); k++){
+        for (int j = demandVarRange[k].first; j < demandVarRange[k].second; j++){
+            solutionVars[j].setBounds(solutionLB[j], solutionUB[j]);
+        }
+    }
+}
+
+/* Builds the approximation, the variables and the constraints of demand k, and adds its terms to the shared capacity constraints. */
+void Model::setDemand(const int k)
+{
+    if (data.getInput().isBasic() == false){
+        buildAvailVector_u(k);
+        buildAvailBreakpoints(k);
+        buildUnavailVector_u(k);
+        buildUnavailBreakpoints(k);
+    }
+    setFlowVariables(k);
+    setSectionPlacementVariables(k);
+    setPathPlacementVariables(k);
+    setPathActivationVariables(k);
+    if (data.getInput().isRelaxation() == false){
+        setPathVariables(avail, k, "avail", 0.0, 1.0);
+        setPathVariables(approx_log_avail, k, "approx_log_avail", -IloInfinity, 0.0);
+        setPathVariables(unavail, k, "unavail", 0.0, 1.0);
+        setPathVariables(approx_log_unavail, k, "approx_log_unavail", -IloInfinity, 0.0);
+    }
+    setDemandConstraints(k);
+    setCapacityTerms(k);
+}
+
+/* Ends the constraints and variables of demand k. Ending a variable also removes it from the shared capacity constraints. */
+void Model::clearDemand(const int k)
+{
+    if (k < (int)approxRows.size()){
+        model.remove(approxRows[k]);
+        approxRows[k].endElements();
+        approxRows[k].clear();
+    }
+    model.remove(demandRows[k]);
+    demandRows[k].endElements();
+    demandRows[k].clear();
+
+    for (unsigned int a = 0; a < f[k].size(); a++){
+        for (unsigned int i = 0; i < f[k][a].size(); i++){
+            for (unsigned int p = 0; p < f[k][a][i].size(); p++){
+                f[k][a][i][p].end();
+            }
+        }
+    }
+    for (unsigned int v = 0; v < x[k].size(); v++){
+        for (unsigned int i = 0; i < x[k][v].size(); i++){
+            for (unsigned int p = 0; p < x[k][v][i].size(); p++){
+                x[k][v][i][p].end();
+            }
+        }
+    }
+    for (unsigned int v = 0; v < y[k].size(); v++){
+        for (unsigned int p = 0; p < y[k][v].size(); p++){
+            y[k][v][p].end();
+        }
+    }
+    for (unsigned int p = 0; p < alpha[k].size(); p++){
+        alpha[k][p].end();
+    }
+    f[k].clear();
+    x[k].clear();
+    y[k].clear();
+    alpha[k].clear();
+
+    IloNumVarMatrix* continuous[] = { &avail, &approx_log_avail, &unavail, &approx_log_unavail };
+    for (int c = 0; c < 4; c++){
+        if (k < (int)continuous[c]->size()){
+            for (unsigned int p = 0; p < (*continuous[c])[k].size(); p++){
+                (*continuous[c])[k][p].end();
+            }
+            (*continuous[c])[k].clear();
+        }
+    }
+    if (k < (int)warmStart.size()){
+        warmStart[k].clear();
+    }
+}
+
+/* Refreshes what depends on the variables of every demand, once a demand was added, removed or rebuilt. */
+void Model::refreshDemands()
+{
+    initialFormulation = false;
+    setSolutionVariables();
+    callback->setAvailabilityVariables(avail);
+    /* Pooled and memoized cuts may refer to the variables of a rebuilt demand. */
+    callback->setCandidateVariables();
+    callback->setCutPool();
+    /* Rebuilt demands come with fresh variables. */
+    setBranchingPriorities();
+    callback->clearPlacementMemo();
+    solution.clear();
+}
+
+/* Gives the last solution to CPLEX as a MIP start, the demands changed since being left to CPLEX. */
+void Model::setWarmStart()
+{
+    if (warmPlacement.empty()){
+        return;
+    }
+    IloNumVarArray startVar(env);
+    IloNumArray startVal(env);
+    for (unsigned int k = 0; k < warmStart.size(); k++){
+        const int FIRST = demandVarRange[k].first;
+        if ((int)warmStart[k].size() != demandVarRange[k].second - FIRST){
+            continue;
+        }
+        for (unsigned int j = 0; j < warmStart[k].size(); j++){
+            startVar.add(solutionVars[FIRST + j]);
+            startVal.add(std::round(warmStart[k][j]));
+        }
+    }
+    const int FIRST_PLACEMENT = demandVarRange.empty() ? 0 : demandVarRange.back().second;
+    for (unsigned int j = 0; j < warmPlacement.size(); j++){
+        startVar.add(solutionVars[FIRST_PLACEMENT + j]);
+        startVal.add(std::round(warmPlacement[j]));
+    }
+    cplex.addMIPStart(startVar, startVal, IloCplex::MIPStartRepair, "previous");
+    startVal.end();
+    startVar.end();
+}
+
+/* Builds a solution with the constructive heuristic and gives it to CPLEX as a MIP start. */
+void Model::setInitialSolution()
+{
+    std::cout << "=> Building initial solution ..." << std::endl;
+    Constructive heuristic(data);
+    if (!heuristic.run()){
+        std::cout << "\t No initial solution was found." << std::endl;
+        return;
+    }
+    std::cout << "\t Initial solution cost: " << heuristic.getCost() << std::endl;
+
+    IloNumVarArray startVar(env);
+    IloNumArray startVal(env);
+    std::vector<std::vector<bool> > placed(data.getNbNodes(), std::vector<bool>(data.getNbVnfs(), false));
+    for (int k = 0; k < data.getNbDemands(); k++){
+        addPathValues(k, heuristic.getPaths(k), startVar, startVal, placed);
+    }
+    for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
+        int v = data.getNodeId(n);
+        for (int f = 0; f < data.getNbVnfs(); f++){
+            startVar.add(z[v][f]);
+            startVal.add(placed[v][f] ? 1.0 : 0.0);
+        }
+    }
+
+    cplex.addMIPStart(startVar, startVal, IloCplex::MIPStartAuto, "constructive");
+    startVal.end();
+    startVar.end();
+}
+
+/* Appends the values of the integer variables of a demand served by given paths. */
+void Model::addPathValues(const int k, const std::vector<ChainPath>& paths, IloNumVarArray& vars, IloNumArray& vals, std::vector<std::vector<bool> >& placed) const
+{
+    const int NB_SECTIONS = data.getDemand(k).getNbVNFs() + 1;
+    for (int p = 0; p < data.getNbPaths(k); p++){
+        const bool ACTIVE = (p < (int)paths.size());
+        std::vector<bool> usedArc;
+        vars.add(alpha[k][p]);
+        vals.add(ACTIVE ? 1.0 : 0.0);
+        for (int i = 0; i < NB_SECTIONS; i++){
+            usedArc.assign(data.getLinks().size(), false);
+            if (ACTIVE){
+                for (unsigned int j = 0; j < paths[p].sections[i].size(); j++){
+                    usedArc[paths[p].sections[i][j]] = true;
+                }
+            }
+            for (ArcIt it(data.getGraph()); it != lemon::INVALID && !f[k].empty(); ++it){
+                int a = data.getArcId(it);
+                vars.add(f[k][a][i][p]);
+                vals.add(usedArc[a] ? 1.0 : 0.0);
+            }
+        }
+        for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
+            int v = data.getNodeId(n);
+            bool host = false;
+            for (int i = 0; i < NB_SECTIONS - 1; i++){
+                bool hosted = (ACTIVE && paths[p].hosts[i] == v);
+                vars.add(x[k][v][i][p]);
+                vals.add(hosted ? 1.0 : 0.0);
+                if (hosted){
+                    host = true;
+                    placed[v][data.getDemand(k).getVNF_i(i)] = true;
+                }
+            }
+            vars.add(y[k][v][p]);
+            vals.add(host ? 1.0 : 0.0);
+        }
+    }
+}
+
+/* Solves the model with the integer variables of some demands fixed to their value in a given solution. */
+bool Model::solveNeighbourhood(const std::vector<bool>& freed, const IloNumVector& incumbent, const double timeLimit, const double cutoff, IloNumVector& values, IloNum& objValue)
+{
+    for (int k = 0; k < data.getNbDemands(); k++){
+        if (freed[k]){
+            continue;
+        }
+        for (int j = demandVarRange[k].first; j < demandVarRange[k].second; j++){
+            double value = std::round(incumbent[j]);
+            solutionVars[j].setBounds(value, value);
+        }
+    }
+
+    cplex.setOut(env.getNullStream());
+    cplex.setWarning(env.getNullStream());
+    cplex.setParam(IloCplex::Param::Threads, 1);
+    cplex.setParam(IloCplex::Param::TimeLimit, timeLimit);
+    cplex.setParam(IloCplex::Param::MIP::Tolerances::UpperCutoff, cutoff);
+    bool found = (cplex.solve() && cplex.getObjValue() < cutoff);
+    if (found){
+        IloNumArray vals(env);
+        cplex.getValues(vals, solutionVars);
+        values.resize(vals.getSize());
+        for (IloInt j = 0; j < vals.getSize(); j++){
+            values[j] = vals[j];
+        }
+        vals.end();
+        objValue = cplex.getObjValue();
+    }
+
+    /* Release the fixed variables. */
+    for (int k = 0; k < data.getNbDemands(); k++){
+        for (int j = demandVarRange[k].first; j < demandVarRange[k].second; j++){
+            solutionVars[j].setBounds(solutionLB[j], solutionUB[j]);
+        }
+    }
+    return found;
+}
+
+/* Solves the model with the placement costs and capacities priced by Lagrangian multipliers. */
+bool Model::solveLagrangianSubproblem(const std::vector<double>& nodePrice, const std::vector<double>& arcPrice, const IloNumMatrix& placementPrice, const double timeLimit, LagrangianSolution& solution)
+{
+    const int NB_NODES = data.getNbNodes();
+    const int NB_ARCS  = (int)data.getLinks().size();
+
+    IloExpr exp(env);
+    for (int v = 0; v < NB_NODES; v++){
+        for (int f = 0; f < data.getNbVnfs(); f++){
+            exp += placementPrice[v][f] * z[v][f];
+        }
+    }
+    for (int k = 0; k < data.getNbDemands(); k++){
+        const Demand& demand = data.getDemand(k);
+        for (int p = 0; p < data.getNbPaths(k); p++){
+            for (int i = 0; i < demand.getNbVNFs(); i++){
+                const double LOAD = demand.getBandwidth() * data.getVnf(demand.getVNF_i(i)).getConsumption();
+                for (int v = 0; v < NB_NODES; v++){
+                    exp += nodePrice[v] * LOAD * x[k][v][i][p];
+                }
+                for (unsigned int a = 0; a < f[k].size(); a++){
+                    exp += arcPrice[a] * demand.getBandwidth() * f[k][a][i][p];
+                }
+            }
+        }
+    }
+    obj.setExpr(exp);
+    exp.end();
+
+    cplex.setOut(env.getNullStream());
+    cplex.setWarning(env.getNullStream());
+    cplex.setParam(IloCplex::Param::Threads, 1);
+    cplex.setParam(IloCplex::Param::TimeLimit, timeLimit);
+    bool found = cplex.solve();
+    if (cplex.getStatus() == IloAlgorithm::Infeasible){
+        solution.bound = IloInfinity;
+    }
+    else{
+        solution.bound = cplex.getBestObjValue();
+    }
+
+    solution.nodeLoad.assign(NB_NODES, 0.0);
+    solution.arcLoad.assign(NB_ARCS, 0.0);
+    solution.placed.assign(NB_NODES, std::vector<double>(data.getNbVnfs(), 0.0));
+    solution.chains.assign(data.getNbDemands(), std::vector<ChainPath>());
+    if (!found){
+        return false;
+    }
+    extractSolution();
+    for (int v = 0; v < NB_NODES; v++){
+        for (int f = 0; f < data.getNbVnfs(); f++){
+            solution.placed[v][f] = this->solution.isPlaced(v, f) ? 1.0 : 0.0;
+        }
+    }
+    for (int k = 0; k < data.getNbDemands(); k++){
+        const Demand& demand = data.getDemand(k);
+        for (int p = 0; p < data.getNbPaths(k); p++){
+            if (!this->solution.isActive(k, p)){
+                continue;
+            }
+            const ChainPath& path = this->solution.getPath(k, p);
+            for (unsigned int i = 0; i < path.hosts.size(); i++){
+                solution.nodeLoad[path.hosts[i]] += demand.getBandwidth() * data.getVnf(demand.getVNF_i(i)).getConsumption();
+            }
+            /* As in the arc capacity constraints, the last section is not counted. */
+            for (unsigned int i = 0; i + 1 < path.sections.size(); i++){
+                for (unsigned int j = 0; j < path.sections[i].size(); j++){
+                    solution.arcLoad[path.sections[i][j]] += demand.getBandwidth();
+                }
+            }
+            solution.chains[k].push_back(path);
+        }
+    }
+    return true;
+}
+
+/* Starts the large neighbourhood search on its own thread and lets the callback exchange solutions with it. */
+void Model::startLns()
+{
+    std::cout << "=> Starting large neighbourhood search ..." << std::endl;
+    /* The search of a previous run is over, its thread being joined by stopLns. */
+    delete lns;
+    delete solutionPool;
+    solutionPool = new SolutionPool();
+    callback->setSolutionPool(solutionPool, solutionVars);
+
+    /* Incumbents are read on candidate context and improvements are posted on relaxation context. */
+    cplex.use(callback, callback->getContextMask());
+
+    lns = new Lns(data, *solutionPool);
+    lnsThread = std::thread(&Lns::run, lns);
+}
+
+/* Stops the large neighbourhood search and waits for its thread. */
+void Model::stopLns()
+{
+    if (solutionPool == NULL){
+        return;
+    }
+    solutionPool->close();
+    if (lnsThread.joinable()){
+        lnsThread.join();
+    }
+}
+
+/* Starts writing the model export file on a background thread, if an export format is set. */
+void Model::exportModel()
+{
+    if (data.getInput().getExportFormat() == Input::EXPORT_FORMAT_OFF){
+        return;
+    }
+    /* The snapshot is rebuilt from the data: it would miss what the live model gained since. */
+    if (!initialFormulation){
+        std::cout << "=> Model export skipped: the formulation changed since it was built." << std::endl;
+        return;
+    }
+    std::string file = data.getInput().getExportFile();
+    std::cout << "=> Exporting model to " << file << " in background ..." << std::endl;
+    exportThread = std::thread(&Model::writeSnapshot, std::cref(data), file);
+}
+
+/* Builds a snapshot of the model in its own environment and writes it to a file. */
+void Model::writeSnapshot(const Data& data, const std::string file)
+{
+    /* Concert environments are not thread safe: the snapshot never touches the solving environment. */
+    IloEnv snapshotEnv;
+    try
+    {
+        Model snapshot(snapshotEnv, data, BUILD_MODE_FORMULATION);
+        snapshot.cplex.exportModel(file.c_str());
+    }
+    catch (const IloException& e) { std::cerr << "ERROR: Unable to export model to " << file << ": " << e << std::endl; }
+    catch (...) { std::cerr << "ERROR: Unable to export model to " << file << "." << std::endl; }
+    snapshotEnv.end();
 }
 
 void Model::printResult(){
     
     const int NB_DEMANDS = data.getNbDemands();
     std::cout << "=> Printing solution ..." << std::endl;
+    if (!solution.isLoaded()){
+        std::cout << "No solution found." << std::endl;
+        return;
+    }
     for (int k = 0; k < NB_DEMANDS; k++) {
         std::cout << std::endl << "----------------------------------------------------" << std::endl << std::endl;
         std::cout << "k=" << k+1 << " : From " << data.getDemand(k).getSource() << " to " << data.getDemand(k).getTarget() << std::endl;
-        double placementAv = getPlacementAvailability(k);
+        double placementAv = solution.getPlacementAvailability(k);
         std::cout << "\t Placement Avail: " << placementAv << std::endl;
         std::cout << "\t Required Avail : " << data.getDemand(k).getAvailability() << std::endl;
         if (placementAv < data.getDemand(k).getAvailability()){
             std::cout << "\t ==> UNFEASIBLE BY " << data.getDemand(k).getAvailability() - placementAv << std::endl;
         }
         for (int p = 0; p < data.getNbPaths(k); p++){
-            if (cplex.getValue(alpha[k][p]) > 1 - EPS){
+            if (solution.isActive(k, p)){
                 std::cout << "\t Path " << p+1 << std::endl;
-                double path_availability = 1.0;
-                double log_path_availability = 0.0;
-                for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-                    int v = data.getNodeId(n);
-                    if (cplex.getValue(y[k][v][p]) > 1 - EPS){
-                        path_availability *= data.getNode(v).getAvailability();
-                        log_path_availability += std::log(data.getNode(v).getAvailability());
-                    }
-                }
+                double path_availability = solution.getPathAvailability(k, p);
                 std::cout << "\t\t Real Path avail : " << std::setprecision(9) << path_availability << std::endl;
-                std::cout << "\t\t Var avail       : " << std::setprecision(9) << cplex.getValue(avail[k][p]) << std::endl;
-                if (path_availability - cplex.getValue(avail[k][p]) < 0.0){
+                std::cout << "\t\t Var avail       : " << std::setprecision(9) << solution.getAvailValue(k, p) << std::endl;
+                if (path_availability - solution.getAvailValue(k, p) < 0.0){
                     std::cout << "\t\t (N)" << std::endl;
                 }
                 else{
@@ -993,7 +1970,7 @@ void Model::printResult(){
                 }
                 
                 std::cout << "\t\t log avail      : " << std::setprecision(9) << std::log(path_availability) << std::endl;
-                std::cout << "\t\t approx(avail)  : " << std::setprecision(9) << cplex.getValue(approx_log_avail[k][p])  << std::endl;
+                std::cout << "\t\t approx(avail)  : " << std::setprecision(9) << solution.getApproxLogAvailValue(k, p)  << std::endl;
                 // std::cout << "  Var unavail : " << cplex.getValue(unavail[k][p]) << std::endl;
                 // std::cout << "  Real unavail : " << 1.0 - path_availability << std::endl;
                 // for (int r = 0; r < CONFIG_NB_BREAKS; r++){
@@ -1009,7 +1986,7 @@ void Model::printResult(){
             }
             else{
                 std::cout << "\t\t Path " << p+1 << " not used." << std::endl;
-                std::cout << "\t\t Var avail : " << cplex.getValue(avail[k][p]) << std::endl;
+                std::cout << "\t\t Var avail : " << solution.getAvailValue(k, p) << std::endl;
                 // std::cout << "  Var unavail : " << cplex.getValue(unavail[k][p]) << std::endl;
                 // for (int r = 0; r < CONFIG_NB_BREAKS; r++){
                 //     if (cplex.getValue(c_lambda[k][p][r]) >  EPS){
@@ -1021,96 +1998,69 @@ void Model::printResult(){
     }
 
 
-    std::cout << "Objective value: " << cplex.getValue(obj) << std::endl;
+    if (!data.getInput().isRelaxation()){
+        validator.print();
+    }
+    std::cout << "Objective value: " << solution.getObjValue() << std::endl;
     std::cout << "Nodes evaluated: " << cplex.getNnodes() << std::endl;
     std::cout << "User cuts added: " << callback->getNbUserCuts() << std::endl;
     std::cout << "Lazy constraints added: " << callback->getNbLazyConstraints() << std::endl;
     std::cout << "Time on cuts: " << callback->getTime() << std::endl;
+    if (data.getInput().getBranchingCallback() == Input::BRANCHING_CALLBACK_ON){
+        std::cout << "Branchings decided by callback: " << callback->getNbBranches() << std::endl;
+    }
+    if (data.getInput().getPropagation() == Input::PROPAGATION_ON){
+        std::cout << "Local bounds propagated: " << callback->getNbLocalBounds() << std::endl;
+        std::cout << "Nodes pruned by propagation: " << callback->getNbPrunedNodes() << std::endl;
+    }
+    if (lns != NULL){
+        std::cout << "LNS neighbourhoods solved: " << lns->getNbIterations() << std::endl;
+        std::cout << "LNS improvements found: " << lns->getNbImprovements() << std::endl;
+    }
+    if (lns != NULL || data.getInput().getRepairHeuristic() == Input::REPAIR_HEURISTIC_ON){
+        std::cout << "Heuristic solutions posted: " << callback->getNbPostedSolutions() << std::endl;
+    }
     std::cout << "Total time: " << time << std::endl << std::endl;
     //testRelaxationAvail();
 }
 
-/* Returns the path availability induced by CPLEX's solution */
-double Model::getPathAvailability(int k, int p){
-     if (cplex.getValue(alpha[k][p]) > 1 - EPS){
-        double path_availability = 1.0;
-        for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-            int v = data.getNodeId(n);
-            if (cplex.getValue(y[k][v][p]) > 1 - EPS){
-                path_availability *= data.getNode(v).getAvailability();
+/* Returns which demands have a VNF placed on a given set of nodes within a solution. */
+std::vector<bool> Model::getDemandsHostedIn(const std::vector<bool>& region, const IloNumVector& solution) const
+{
+    std::vector<bool> hosted(data.getNbDemands(), false);
+    for (int k = 0; k < data.getNbDemands(); k++){
+        for (unsigned int v = 0; v < yIndex[k].size() && !hosted[k]; v++){
+            if (!region[v]){
+                continue;
+            }
+            for (unsigned int p = 0; p < yIndex[k][v].size(); p++){
+                if (solution[yIndex[k][v][p]] > 1 - EPS){
+                    hosted[k] = true;
+                }
             }
         }
-        return path_availability;
-     }
-     return 0;
-}
-
-/* Returns the placement availability induced by CPLEX's solution */
-double Model::getPlacementAvailability(int k){
-    double prob_all_paths_fail = 1.0;
-    for (unsigned int p = 0; p < alpha[k].size(); p++){
-        double path_failure = 1.0;
-        if (cplex.getValue(alpha[k][p]) > 1 - EPS){
-            double path_availability = getPathAvailability(k, p);
-            path_failure = 1.0 - path_availability;
-        }
-        prob_all_paths_fail *= path_failure;
     }
-    return (1.0 - prob_all_paths_fail);
+    return hosted;
 }
 
+/* Displays the routing of demand k through the i-th section of path p. */
 void Model::printSectionPath(const int k, const int p, const int i){
-    /*identify source and destinations*/
-    Graph::Node sourceNode = lemon::INVALID;
-    Graph::Node targetNode = lemon::INVALID;
-    if (i == 0){
-        for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-            if (data.getNodeId(n) == data.getDemand(k).getSource()){
-                sourceNode = n;
-            }
-        }
-    }
-    else{
-        for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-            int v = data.getNodeId(n);
-            if (cplex.getValue(x[k][v][i-1][p]) > 1 - EPS){
-                sourceNode = n;
-            }
-        }
-    }
-    
-    if (i == data.getDemand(k).getNbVNFs()){
-        for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-            if (data.getNodeId(n) == data.getDemand(k).getTarget()){
-                targetNode = n;
-            }
-        }
-    }
-    else{
-        for (NodeIt n(data.getGraph()); n != lemon::INVALID; ++n){
-            int v = data.getNodeId(n);
-            if (cplex.getValue(x[k][v][i][p]) > 1 - EPS){
-                targetNode = n;
-            }
-        }
+    const int SOURCE = solution.getSectionSource(k, p, i);
+    const int TARGET = solution.getSectionTarget(k, p, i);
+
+    /* In the Benders master, sections are routed by the subproblems. */
+    if (f[k].empty()){
+        std::cout << SOURCE << " ~~ " << TARGET << "." << std::endl;
+        return;
     }
 
     /* build path */
-    std::cout << data.getNodeId(sourceNode) << " -- ";
-    Graph::Node v = sourceNode;
-    while( data.getGraph().id(v) != data.getGraph().id(targetNode)){
-        for (Graph::OutArcIt it(data.getGraph(), v); it != lemon::INVALID; ++it){
-            int a = data.getArcId(it);
-            if (cplex.getValue(f[k][a][i][p]) > 1 - EPS){
-                v = data.getGraph().target(it);
-                if (data.getGraph().id(v) != data.getGraph().id(targetNode)){
-                    std::cout << data.getNodeId(v) << " -- ";
-                }
-                break;
-            }
-        }
+    const std::vector<int>& section = solution.getPath(k, p).sections[i];
+    std::cout << SOURCE << " -- ";
+    for (unsigned int j = 0; j + 1 < section.size(); j++){
+        std::cout << data.getLink(section[j]).getTarget() << " -- ";
     }
-    std::cout << data.getNodeId(targetNode) << "." << std::endl; 
+    std::cout << TARGET << "." << std::endl; 
 }
 
 void Model::output(){
@@ -1127,15 +2077,13 @@ void Model::output(){
         exit(EXIT_FAILURE);
     }
 
-    std::string demand_name = getInBetweenString(data.getInput().getDemandFile(), "/", ".");
-    std::string node_name = getInBetweenString(data.getInput().getNodeFile(), "/", ".");
-    std::string instance_name = node_name + "_" + demand_name;
+    std::string instance_name = data.getInput().getInstanceName();
 
     fileReport << instance_name << ";"
     		   << time << ";"
-    		   << cplex.getObjValue() << ";"
+    		   << (solution.isLoaded() ? solution.getObjValue() : IloInfinity) << ";"
     		   << cplex.getBestObjValue() << ";"
-    		   << cplex.getMIPRelativeGap()*100 << ";"
+    		   << (solution.isLoaded() ? cplex.getMIPRelativeGap()*100 : IloInfinity) << ";"
     		   << cplex.getNnodes() << ";"
     		   << cplex.getNnodesLeft()*0.001 << ";" 
                << callback->getNbLazyConstraints() << ";" 
@@ -1148,6 +2096,31 @@ void Model::output(){
 
 }
 
+/* Frees the CPLEX problem and the Concert objects of the model, so that its environment can host the next one. */
+void Model::end(){
+    stopLns();
+    if (exportThread.joinable()){
+        exportThread.join();
+    }
+    cplex.end();
+    for (unsigned int k = 0; k < approxRows.size(); k++){
+        approxRows[k].endElements();
+        approxRows[k].end();
+    }
+    for (unsigned int k = 0; k < demandRows.size(); k++){
+        demandRows[k].endElements();
+        demandRows[k].end();
+    }
+    constraints.endElements();
+    constraints.end();
+    nodeCapacityRows.end();
+    arcCapacityRows.end();
+    obj.end();
+    solutionVars.endElements();
+    solutionVars.end();
+    model.end();
+}
+
 /****************************************************************************************/
 /*										   Tests  										*/
 /****************************************************************************************/
@@ -1162,19 +2135,19 @@ void Model::testRelaxationAvail(){
     for (int k = 0; k < NB_DEMANDS; k++) {
         std::cout << "Demand " << k+1 << " : From " << data.getDemand(k).getSource() << " to " << data.getDemand(k).getTarget() << std::endl;
         for (int p = 0; p < data.getNbPaths(k); p++){
-            if (cplex.getValue(alpha[k][p]) > 1 - EPS){
-                const double PATH_AVAIL    = getPathAvailability(k, p);
-                const double VAR_AVAIL     = cplex.getValue(avail[k][p]);
+            if (solution.isActive(k, p)){
+                const double PATH_AVAIL    = solution.getPathAvailability(k, p);
+                const double VAR_AVAIL     = solution.getAvailValue(k, p);
                 std::cout << "\t Path " << p+1 << std::endl;
                 std::cout << "\t\t Avail induced by y variables : " << std::setprecision(9) << PATH_AVAIL << std::endl;
                 std::cout << "\t\t Value of variable avail :      " << std::setprecision(9) << VAR_AVAIL  << std::endl;
                 if (PATH_AVAIL >= VAR_AVAIL + 0.00000001){
-                    std::cout << "\t\t\t ====> ERROR : " << std::setprecision(9) << PATH_AVAIL - cplex.getValue(avail[k][p]) << ". Negative approx !!!" << std::endl; 
+                    std::cout << "\t\t\t ====> ERROR : " << std::setprecision(9) << PATH_AVAIL - VAR_AVAIL << ". Negative approx !!!" << std::endl; 
                 }
             }
             else{
                 std::cout << "\t Path " << p+1 << " not used." << std::endl;
-                std::cout << "\t\t Value of variable avail : " << cplex.getValue(avail[k][p]) << std::endl;
+                std::cout << "\t\t Value of variable avail : " << solution.getAvailValue(k, p) << std::endl;
             }
         }
     }
@@ -1183,5 +2156,11 @@ void Model::testRelaxationAvail(){
 /*										Destructors 									*/
 /****************************************************************************************/
 Model::~Model(){
+    if (exportThread.joinable()){
+        exportThread.join();
+    }
+    stopLns();
+    delete lns;
+    delete solutionPool;
     delete callback;
 }
\ No newline at end of file
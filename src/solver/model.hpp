@@ -6,8 +6,21 @@
 /*										LIBRARIES										*/
 /****************************************************************************************/
 
+/*** C++ Libraries ***/
+#include <thread>
+
 /*** Own Libraries ***/
 #include "callback.hpp"
+#include "constructive.hpp"
+#include "solutionpool.hpp"
+#include "encoder.hpp"
+#include "validator.hpp"
+
+/****************************************************************************************/
+/*										DEFINES			    							*/
+/****************************************************************************************/
+#define REFINEMENT_NB_TOUCHS 2 			// Number of touches per demand the breakpoint refinement starts from
+#define REFINEMENT_MIN_DISTANCE 1e-9 	// Distance under which a new touch is considered already present
 
 /****************************************************************************************/
 /*										TYPEDEFS										*/
@@ -26,6 +39,19 @@ typedef std::vector<IloNumMatrix>      IloNum3DMatrix;
 typedef std::vector<IloNum3DMatrix>    IloNum4DMatrix;
 typedef std::vector<IloNum4DMatrix>    IloNum5DMatrix;
 
+/********************************************************************************************
+ * The solution of a Lagrangian subproblem: a bound on its value, the resources it uses in
+ * the dualized constraints and the paths of each demand.
+********************************************************************************************/
+struct LagrangianSolution {
+	double 								bound; 		/**< A lower bound on the subproblem value, infinite if it is infeasible. **/
+	std::vector<double> 				nodeLoad; 	/**< nodeLoad[v] is the capacity used on node v. **/
+	std::vector<double> 				arcLoad; 	/**< arcLoad[a] is the bandwidth used on arc a. **/
+	std::vector<std::vector<double> > 	placed; 	/**< placed[v][f] is the value of z[v][f]. **/
+	std::vector<std::vector<ChainPath> > chains; 	/**< chains[k] are the paths of demand k, empty if no solution was found. **/
+};
+
+class Lns;
 
 /********************************************************************************************
  * This class models the MIP formulation and solves it using CPLEX. 											
@@ -42,8 +68,14 @@ class Model
 		/*** Formulation specific ***/
 		const Data&     data;   		/**< Data read in data.hpp **/
 		IloObjective    obj;            /**< Objective function **/
-		IloRangeArray   constraints;    /**< Set of constraints **/
+		IloRangeArray   constraints;    /**< Set of constraints shared by every demand **/
+		IloRangeArray 	nodeCapacityRows; 	/**< nodeCapacityRows[v] is the capacity constraint of node v, also held by constraints. **/
+		IloRangeArray 	arcCapacityRows; 	/**< arcCapacityRows[a] is the capacity constraint of arc a, also held by constraints. **/
+		std::vector<IloRangeArray> demandRows; 	/**< demandRows[k] are the constraints involving demand k only, but its approximation rows. **/
+		std::vector<IloRange> availabilityRows; /**< availabilityRows[k] is the availability requirement of demand k, also held by demandRows[k]. **/
 		Callback* 		callback; 		/**< User generic callback **/
+		Solution 		solution; 		/**< The last solution read from CPLEX. **/
+		Validator 		validator; 		/**< Checks the solutions read from CPLEX against the original problem. **/
 
 		/*** Formulation variables ***/
 		IloNumVar4DMatrix 	f;              /**< Flow variables **/
@@ -63,62 +95,125 @@ class Model
 		IloNumMatrix 		avail_breakpoints; 		/**< the vector of points where the availability approximation function changes its slope */
 		IloNumMatrix 		unavail_touch; 			/**< same as avail_breakpoints but related with the unavailability approx **/
 		IloNumMatrix 		unavail_breakpoints; 	/**< same as avail_touch but related with the unavailability approx **/
+		std::vector<IloExtractableArray> approxRows; 	/**< approxRows[k] are the piecewise linear rows approximating the availability of demand k, with their encoding constraints. **/
+
+		/*** Solution exchange features ***/
+		IloNumVarArray 		solutionVars; 		/**< All variables, flattened in a fixed order so that solutions can be passed between models. Integer variables of each demand come first, then z, then the continuous ones. **/
+		IloNumVector 		solutionLB; 		/**< The original lower bound of each solution variable. **/
+		IloNumVector 		solutionUB; 		/**< The original upper bound of each solution variable. **/
+		std::vector<std::pair<int, int> > demandVarRange; 	/**< The range [first, last) of the integer solution variables of each demand. **/
+		std::vector<std::vector<std::vector<int> > > yIndex; /**< yIndex[k][v][p] is the position of y[k][v][p] among the solution variables. **/
+		IloNumMatrix 		warmStart; 			/**< warmStart[k] are the values of the integer variables of demand k in the last solution, emptied when the demand changes. **/
+		IloNumVector 		warmPlacement; 		/**< The values of the placement variables z in the last solution. **/
 
 		/*** Manage execution and control ***/
 		IloNum time;
+		IloNum 				timeLimit; 		/**< Time limit in seconds of each run. **/
+		std::ostream 		buildLog; 		/**< Where the build steps are reported: std::cout, or nowhere for a formulation only model. **/
+		bool 				initialFormulation; /**< True until the formulation is refined or its demands are updated. **/
+		std::thread 		exportThread; 	/**< Background thread writing the model export file. **/
+		SolutionPool* 		solutionPool; 	/**< Pool exchanging solutions with the large neighbourhood search. **/
+		Lns* 				lns; 			/**< Large neighbourhood search running alongside CPLEX. **/
+		std::thread 		lnsThread; 		/**< Thread running the large neighbourhood search. **/
 
 	public:
+		/** Defines what is built along with the formulation. **/
+		enum Build_Mode {
+			BUILD_MODE_FULL = 0, 			/**< Reported build, callback and CPLEX parameters. **/
+			BUILD_MODE_NEIGHBOURHOOD = 1, 	/**< Silent build, with a callback only checking candidates. **/
+			BUILD_MODE_FORMULATION = 2 		/**< Silent build of the formulation only, as for an export snapshot. **/
+		};
+
 	/****************************************************************************************/
 	/*										Constructors									*/
 	/****************************************************************************************/
 		/** Constructor. Builds the model (variables, objective function, constraints and further parameters). **/
 		Model(const IloEnv& env, const Data& data);
 		Model(const IloEnv& env, const Data&&) = delete;
+		/** Constructor. @param mode What is built along with the variables, objective function and constraints. **/
+		Model(const IloEnv& env, const Data& data, const Build_Mode mode);
 		Model() = delete;
 
 	/****************************************************************************************/
 	/*									    Formulation  									*/
 	/****************************************************************************************/
-        /** Set up the Cplex parameters. **/
-        void setCplexParameters();
+        /** Set up the Cplex parameters. @param candidateOnly True if the callback only checks candidates. **/
+        void setCplexParameters(const bool candidateOnly);
         /** Set up the variables. **/
         void setVariables();
+		/** Set up the flow variables of demand k. **/
+		void setFlowVariables(const int k);
+		/** Set up the VNF section placement variables of demand k. **/
+		void setSectionPlacementVariables(const int k);
+		/** Set up the VNF path placement variables of demand k. **/
+		void setPathPlacementVariables(const int k);
+		/** Set up the path activation variables of demand k. **/
+		void setPathActivationVariables(const int k);
+		/** Set up one continuous variable per path of demand k. @param vars The family of path variables. @param k The demand id. @param prefix The prefix of the variable names. @param lb The lower bound. @param ub The upper bound. **/
+		void setPathVariables(IloNumVarMatrix& vars, const int k, const std::string& prefix, const double lb, const double ub);
         /** Set up the objective function. **/
         void setObjective();
         /** Set up the constraints. **/
         void setConstraints();
+        /** Set up the flattened array of solution variables. **/
+        void setSolutionVariables();
+        /** Set up the branching priorities of each variable family, as given in the parameters file. **/
+        void setBranchingPriorities();
+		
+		/** Set up the constraints involving demand k only. **/
+		void setDemandConstraints(const int k);
+		/** Adds the terms of demand k to the node and arc capacity constraints. **/
+		void setCapacityTerms(const int k);
 		
 		/** Add up the routing constraints: flow conservation constraints among sections **/
 		void setRoutingConstraints();
+		void setRoutingConstraints(const int k);
         /** Add up the node capacity constraints: the bandwidth treated in a node must respect its capacity. **/
         void setNodeCapacityConstraints();
         /** Add up the arc capacity constraints: the bandwidth routed within an arc must respect its capacity. **/
         void setArcCapacityConstraints();
         /** Add up the latency constraints: the path lengths must respect latency. **/
         void setLatencyConstraints();
+        void setLatencyConstraints(const int k);
         /** Add up the linking constraints. **/
         void setLinkingConstraints();
+        void setLinkingConstraints(const int k);
         /** Add up the vnf disjunction constraints. **/
         void setDisjunctionConstraints();
+        void setDisjunctionConstraints(const int k);
 
 		/* Add up the strong node capacity constraints. */
 		void setStrongNodeCapacityConstraints();
 		/* Add up the degree constraints. */
 		void setDegreeConstraints();
+		void setDegreeConstraints(const int k);
 		/* Add up the symmetry breaking constraints. */
 		void setSymmetryBreakingConstraints();
+		void setSymmetryBreakingConstraints(const int k);
 
 
 		/* Add up the approximated path availability constraints. */
 		void setPathAvailApproxConstraints();
+		void setPathAvailApproxConstraints(const int k);
 		/* Add up the approximated configuration availability constraints. */
 		void setConfigAvailApproxConstraints();
+		void setConfigAvailApproxConstraints(const int k);
+		/* Add up the piecewise linear rows approximating the log of the path availabilities of demand k. */
+		void setPathAvailApproxRows(const int k);
+		/* Add up the piecewise linear rows approximating the log of the path unavailabilities of demand k. */
+		void setConfigAvailApproxRows(const int k);
+		/* Add up the explicit encoding of y = f(x) to the approximation rows of demand k, when CPLEX is not left to pick its own. */
+		void addEncodedRows(const int k, const Encoder& encoder, const IloNumVar& x, const IloNumVar& y, const std::string& name);
 
 		/* Set up the breakpoints for approximating log(avail). */
 		void buildAvailVector_u();
+		void buildAvailVector_u(const int k);
     	void buildAvailBreakpoints();
+    	void buildAvailBreakpoints(const int k);
     	void buildUnavailVector_u();
+    	void buildUnavailVector_u(const int k);
     	void buildUnavailBreakpoints();
+    	void buildUnavailBreakpoints(const int k);
 		void buildPiecewiseLinearApproximation();
 		void buildApproximationFunctionAvail(int k, IloNumArray &breakpoints, IloNumArray &slopes);
 		void buildApproximationFunctionUnavail(int k, IloNumArray &breakpoints, IloNumArray &slopes);
@@ -129,14 +224,82 @@ class Model
 	/****************************************************************************************/
 	/*										   Getters  									*/
 	/****************************************************************************************/
-		double getPlacementAvailability(int k);
-		double getPathAvailability(int k, int p);
+		/** Returns true if routing is left to the Benders subproblems, in which case the model is the placement master. **/
+		bool isRoutingDelegated() const { return (data.getInput().getSolverEngine() == Input::SOLVER_ENGINE_BENDERS); }
+		/** Returns the flattened array of solution variables. **/
+		const IloNumVarArray& getSolutionVariables() const { return solutionVars; }
+		/** Returns the last solution read from CPLEX. **/
+		const Solution& getSolution() const { return solution; }
+		/** Returns the violations of the last solution read from CPLEX. **/
+		const std::vector<Validator::Violation>& getViolations() const { return validator.getViolations(); }
+		/** Returns which demands have a VNF placed on a given set of nodes within a solution. @param region The set of nodes. @param solution The solution values, indexed as the solution variables. **/
+		std::vector<bool> getDemandsHostedIn(const std::vector<bool>& region, const IloNumVector& solution) const;
 	/****************************************************************************************/
 	/*										   Methods  									*/
 	/****************************************************************************************/
 		/** Solves the MIP. **/
 		void run();
 
+		/** Reads CPLEX's solution with a single bulk query and caches it, with its routed paths, in the solution object. The solution is then validated against the original problem. **/
+		void extractSolution();
+
+		/** Solves the MIP from a coarse availability approximation, refining it around the availabilities used by violated demands between solves. @note Once the rounds are exhausted, the exact availability check of the callback is turned on. **/
+		void solveWithRefinement();
+
+		/** Adds touches at given path availabilities of a demand and rebuilds its approximation rows. Returns false if every touch was already present. @param k The demand id. @param pathAvail The availabilities of its active paths. **/
+		bool refineApproximation(const int k, const std::vector<double>& pathAvail);
+
+		/** Builds the variables and constraints of a demand added to the data, and links them to the shared capacity constraints. @param k The demand id, as returned by Data::addDemand. @note The last solution is kept as a warm start for the other demands. **/
+		void addDemand(const int k);
+
+		/** Ends the variables and constraints of a demand removed from the data. The ids of the other demands are kept. @param k The demand id. **/
+		void removeDemand(const int k);
+
+		/** Updates the requirement of a demand whose availability was changed in the data. Only its requirement row and path activation bounds change, unless its bound on the number of paths changed, in which case the demand is rebuilt. @param k The demand id. **/
+		void updateAvailabilityRequirement(const int k);
+
+		/** Fixes the integer variables of a demand to given paths, until the demands are released. @param k The demand id. @param paths The paths serving the demand, set on its first path indexes. **/
+		void fixDemand(const int k, const std::vector<ChainPath>& paths);
+
+		/** Restores the bounds of the integer variables of every demand fixed since the last release. **/
+		void releaseDemands();
+
+		/** Builds the approximation, the variables and the constraints of demand k, and adds its terms to the shared capacity constraints. **/
+		void setDemand(const int k);
+
+		/** Ends the constraints and variables of demand k, which then has none. **/
+		void clearDemand(const int k);
+
+		/** Refreshes the solution variables and what depends on them once a demand was added, removed or rebuilt. **/
+		void refreshDemands();
+
+		/** Gives the last solution read from CPLEX as a MIP start. Demands changed since are left for CPLEX to complete. **/
+		void setWarmStart();
+
+		/** Builds a solution with the constructive heuristic and gives it to CPLEX as a MIP start. @note Variables not set (availability approximations) are completed by CPLEX. **/
+		void setInitialSolution();
+
+		/** Appends the values of the integer variables of a demand served by given paths. @param k The demand id. @param paths The paths serving the demand, set on its first path indexes. @param vars The variables. @param vals Their values. @param placed Set to true for every VNF f placed on node v, as placed[v][f]. **/
+		void addPathValues(const int k, const std::vector<ChainPath>& paths, IloNumVarArray& vars, IloNumArray& vals, std::vector<std::vector<bool> >& placed) const;
+
+		/** Solves the model with the integer variables of some demands fixed to their value in a given solution. Returns true if a solution better than the cutoff was found. @param freed The demands whose variables are not fixed. @param incumbent The solution values, indexed as the solution variables. @param timeLimit The time limit in seconds. @param cutoff The value a solution must improve. @param values The solution found. @param objValue The objective value of the solution found. @note The variables are released before returning. **/
+		bool solveNeighbourhood(const std::vector<bool>& freed, const IloNumVector& incumbent, const double timeLimit, const double cutoff, IloNumVector& values, IloNum& objValue);
+
+		/** Solves the model with the placement costs and capacities priced by Lagrangian multipliers. Returns true if a solution was found. @param nodePrice The price of a unit of capacity of each node. @param arcPrice The price of a unit of bandwidth of each arc. @param placementPrice placementPrice[v][f] replaces the cost of z[v][f]. @param timeLimit The time limit in seconds. @param solution The bound and solution found. @note The capacity constraints are kept, which is valid when the model only holds part of the demands. **/
+		bool solveLagrangianSubproblem(const std::vector<double>& nodePrice, const std::vector<double>& arcPrice, const IloNumMatrix& placementPrice, const double timeLimit, LagrangianSolution& solution);
+
+		/** Starts the large neighbourhood search on its own thread and lets the callback exchange solutions with it. **/
+		void startLns();
+
+		/** Stops the large neighbourhood search and waits for its thread. **/
+		void stopLns();
+
+		/** Starts writing the model export file on a background thread, if an export format is set. @note The file holds the initial formulation, rebuilt from the data in a separate environment so that it overlaps with the solve. It is not written once the live model has diverged from it (refined breakpoints, updated demands), nor is the live model itself written. **/
+		void exportModel();
+
+		/** Builds a snapshot of the model in its own environment and writes it to a file. @param data The data the model is built from. @param file The export file, whose extension defines the format. **/
+		static void writeSnapshot(const Data& data, const std::string file);
+
 		/** Displays the obtained results **/
 		void printResult();
 
@@ -145,6 +308,18 @@ class Model
 
 		/** Outputs the obtained results **/
 		void output();
+
+		/** Changes the time limit of the next runs. @param limit The time limit in seconds. **/
+		void setTimeLimit(const double limit) { timeLimit = limit; }
+
+		/** Limits the number of threads CPLEX uses to solve the model. @param nbThreads The number of threads. **/
+		void setThreads(const int nbThreads) { cplex.setParam(IloCplex::Param::Threads, nbThreads); callback->setNbThreads(nbThreads); }
+
+		/** Changes the number of threads sharing the per-demand separation work of the callback. @param nbThreads The number of threads, 1 or less separating serially. **/
+		void setSeparationThreads(const int nbThreads) { callback->setSeparationThreads(nbThreads); }
+
+		/** Frees the CPLEX problem and the Concert objects of the model, so that its environment can host the next one. @note The model cannot be used afterwards. **/
+		void end();
 	/****************************************************************************************/
 	/*										   Tests  										*/
 	/****************************************************************************************/
@@ -0,0 +1,218 @@
+#include "pricing.hpp"
+
+/****************************************************************************************/
+/*										CONSTRUCTOR										*/
+/****************************************************************************************/
+
+Pricing::Pricing(const Data& data_, const int k_, const PricingCosts& costs_, const int maxLabels_) :
+                data(data_), k(k_), costs(costs_), maxLabels(maxLabels_), truncated(false)
+{
+    outArcs.resize(data.getNbNodes());
+    for (unsigned int a = 0; a < data.getLinks().size(); a++){
+        outArcs[data.getLink(a).getSource()].push_back(a);
+    }
+    const int NB_LAYERS = data.getDemand(k).getNbVNFs() + 1;
+    bucket.resize(NB_LAYERS, std::vector<std::vector<int> >(data.getNbNodes()));
+}
+
+/****************************************************************************************/
+/*									MAIN OPERATIONS        								*/
+/****************************************************************************************/
+
+/* Builds the chains of most negative reduced cost. */
+void Pricing::run(const int maxColumns, const double threshold, std::vector<ChainPath>& columns, std::vector<double>& reducedCosts)
+{
+    const Demand& demand    = data.getDemand(k);
+    const int     NB_VNFS   = demand.getNbVNFs();
+    const double  BANDWIDTH = demand.getBandwidth();
+
+    columns.clear();
+    reducedCosts.clear();
+    computeMinDelay();
+    if (minDelay[demand.getSource()] > demand.getMaxLatency() + PRICING_EPS){
+        return;
+    }
+
+    Label start;
+    start.node = demand.getSource();
+    start.layer = 0;
+    start.cost = 0.0;
+    start.latency = 0.0;
+    start.logAvail = 0.0;
+    start.pred = -1;
+    start.arc = -1;
+    std::deque<int> worklist;
+    if (insert(start)){
+        worklist.push_back((int)labels.size() - 1);
+    }
+
+    for (int i = 0; i <= NB_VNFS; i++){
+        routeLayer(i, worklist);
+        if (i == NB_VNFS){
+            break;
+        }
+
+        /* Place the i-th VNF on the node each label sits on. */
+        const double LOAD = BANDWIDTH * data.getVnf(demand.getVNF_i(i)).getConsumption();
+        std::deque<int> next;
+        for (int v = 0; v < data.getNbNodes(); v++){
+            if (data.getNode(v).getCapacity() < LOAD){
+                continue;
+            }
+            const std::vector<int>& slot = bucket[i][v];
+            for (unsigned int j = 0; j < slot.size(); j++){
+                if (!labels[slot[j]].alive){
+                    continue;
+                }
+                Label label = labels[slot[j]];
+                label.layer = i + 1;
+                label.pred = slot[j];
+                label.arc = -1;
+                label.cost += costs.placeCost[v][i];
+                std::vector<int>::iterator it = std::lower_bound(label.hosts.begin(), label.hosts.end(), v);
+                if (it == label.hosts.end() || *it != v){
+                    label.hosts.insert(it, v);
+                    label.cost += costs.hostCost[v];
+                    label.logAvail += std::log(data.getNode(v).getAvailability());
+                }
+                if (insert(label)){
+                    next.push_back((int)labels.size() - 1);
+                }
+            }
+        }
+        worklist.swap(next);
+    }
+
+    /* Keep the complete chains of most negative reduced cost. */
+    std::vector<double> candidateCost;
+    std::vector<int> candidate;
+    const std::vector<int>& complete = bucket[NB_VNFS][demand.getTarget()];
+    for (unsigned int j = 0; j < complete.size(); j++){
+        if (labels[complete[j]].alive){
+            double reducedCost = getReducedCost(labels[complete[j]]);
+            if (reducedCost < threshold){
+                candidateCost.push_back(reducedCost);
+                candidate.push_back(complete[j]);
+            }
+        }
+    }
+    std::vector<int> order = getSortedIndexes_Asc(candidateCost);
+    for (unsigned int j = 0; j < order.size() && (int)j < maxColumns; j++){
+        columns.push_back(getChain(candidate[order[j]]));
+        reducedCosts.push_back(candidateCost[order[j]]);
+    }
+}
+
+/* Computes the smallest delay from every node to the demand target. */
+void Pricing::computeMinDelay()
+{
+    const double BANDWIDTH = data.getDemand(k).getBandwidth();
+    minDelay.assign(data.getNbNodes(), DBL_MAX);
+    minDelay[data.getDemand(k).getTarget()] = 0.0;
+    bool updated = true;
+    for (int iter = 0; iter < data.getNbNodes() && updated; iter++){
+        updated = false;
+        for (unsigned int a = 0; a < data.getLinks().size(); a++){
+            const Link& link = data.getLink(a);
+            if (link.getBandwidth() < BANDWIDTH || minDelay[link.getTarget()] == DBL_MAX){
+                continue;
+            }
+            if (minDelay[link.getTarget()] + link.getDelay() < minDelay[link.getSource()]){
+                minDelay[link.getSource()] = minDelay[link.getTarget()] + link.getDelay();
+                updated = true;
+            }
+        }
+    }
+}
+
+/* Extends the labels of a layer through arcs until no new label appears. */
+void Pricing::routeLayer(const int i, std::deque<int>& worklist)
+{
+    const double BANDWIDTH   = data.getDemand(k).getBandwidth();
+    const double MAX_LATENCY = data.getDemand(k).getMaxLatency();
+    const bool   LAST_LAYER  = (i == data.getDemand(k).getNbVNFs());
+    while (!worklist.empty()){
+        const int index = worklist.front();
+        worklist.pop_front();
+        if (!labels[index].alive){
+            continue;
+        }
+        const int v = labels[index].node;
+        for (unsigned int j = 0; j < outArcs[v].size(); j++){
+            const int a = outArcs[v][j];
+            const Link& link = data.getLink(a);
+            const int w = link.getTarget();
+            const double latency = labels[index].latency + link.getDelay();
+            if (link.getBandwidth() < BANDWIDTH || latency + minDelay[w] > MAX_LATENCY + PRICING_EPS){
+                continue;
+            }
+            Label label = labels[index];
+            label.node = w;
+            label.latency = latency;
+            if (!LAST_LAYER){
+                label.cost += costs.arcCost[a];
+            }
+            label.pred = index;
+            label.arc = a;
+            if (insert(label)){
+                worklist.push_back((int)labels.size() - 1);
+            }
+        }
+    }
+}
+
+/* Inserts a label in its bucket unless it is dominated, removing the labels it dominates. */
+bool Pricing::insert(const Label& label)
+{
+    if ((int)labels.size() >= maxLabels){
+        truncated = true;
+        return false;
+    }
+    std::vector<int>& slot = bucket[label.layer][label.node];
+    for (unsigned int j = 0; j < slot.size(); j++){
+        const Label& other = labels[slot[j]];
+        if (other.alive && other.hosts == label.hosts &&
+            other.cost <= label.cost + PRICING_EPS && other.latency <= label.latency + PRICING_EPS && other.logAvail >= label.logAvail - PRICING_EPS){
+            return false;
+        }
+    }
+    for (unsigned int j = 0; j < slot.size(); j++){
+        Label& other = labels[slot[j]];
+        if (other.alive && other.hosts == label.hosts &&
+            label.cost <= other.cost + PRICING_EPS && label.latency <= other.latency + PRICING_EPS && label.logAvail >= other.logAvail - PRICING_EPS){
+            other.alive = false;
+        }
+    }
+    labels.push_back(label);
+    labels.back().alive = true;
+    slot.push_back((int)labels.size() - 1);
+    return true;
+}
+
+/* Returns the reduced cost of a complete label. */
+double Pricing::getReducedCost(const Label& label) const
+{
+    const double availability = std::min(std::exp(label.logAvail), 1.0 - 1e-12);
+    return (costs.fixed + label.cost + costs.availWeight * std::log(1.0 - availability));
+}
+
+/* Rebuilds the chain of a complete label. */
+ChainPath Pricing::getChain(const int index) const
+{
+    const int NB_VNFS = data.getDemand(k).getNbVNFs();
+    ChainPath path;
+    path.hosts.assign(NB_VNFS, -1);
+    path.sections.assign(NB_VNFS + 1, std::vector<int>());
+    for (int j = index; labels[j].pred != -1; j = labels[j].pred){
+        if (labels[j].arc == -1){
+            path.hosts[labels[j].layer - 1] = labels[j].node;
+        }
+        else {
+            path.sections[labels[j].layer].push_back(labels[j].arc);
+        }
+    }
+    for (int i = 0; i <= NB_VNFS; i++){
+        std::reverse(path.sections[i].begin(), path.sections[i].end());
+    }
+    return path;
+}
@@ -0,0 +1,113 @@
+#ifndef __pricing__hpp
+#define __pricing__hpp
+
+/****************************************************************************************/
+/*										LIBRARIES										*/
+/****************************************************************************************/
+
+/*** C++ Libraries ***/
+#include <vector>
+#include <deque>
+#include <cmath>
+
+/*** Own Libraries ***/
+#include "constructive.hpp"
+
+/****************************************************************************************/
+/*										DEFINES			    							*/
+/****************************************************************************************/
+#define PRICING_EPS 1e-9 // Tolerance used when comparing label resources
+
+/********************************************************************************************
+ * The reduced cost of a column of a given demand, split into the parts a label can
+ * accumulate along the layered section graph. The reduced cost of a chain c is
+ *      fixed + sum of arc, placement and host costs along c + availWeight * log(1 - a_c),
+ * where a_c is the product of the availabilities of the distinct hosts of c.
+********************************************************************************************/
+struct PricingCosts {
+	double 								fixed; 			/**< Cost paid by every column. **/
+	double 								availWeight; 	/**< Weight of log(1 - a_c). Must be non-negative. **/
+	std::vector<double> 				arcCost; 		/**< arcCost[a] is paid each time arc a is used. **/
+	std::vector<std::vector<double> > 	placeCost; 		/**< placeCost[v][i] is paid if the i-th VNF is placed on node v. **/
+	std::vector<double> 				hostCost; 		/**< hostCost[v] is paid once if node v hosts any VNF. **/
+};
+
+/********************************************************************************************
+ * A partial chain in the layered section graph: it sits on a node after having placed the
+ * first 'layer' VNFs of the demand.
+********************************************************************************************/
+struct Label {
+	int 				node; 			/**< The network node the label sits on. **/
+	int 				layer; 			/**< The number of VNFs already placed. **/
+	double 				cost; 			/**< The additive part of the reduced cost. **/
+	double 				latency; 		/**< The delay of the arcs used. **/
+	double 				logAvail; 		/**< The log of the availability of the distinct hosts. **/
+	std::vector<int> 	hosts; 			/**< The distinct hosts, sorted. **/
+	int 				pred; 			/**< The label it was extended from, or -1. **/
+	int 				arc; 			/**< The arc used from its predecessor, or -1 if the extension placed a VNF. **/
+	bool 				alive; 			/**< False once the label is dominated. **/
+};
+
+/********************************************************************************************
+ * This class solves the pricing subproblem of the path-based formulation for one demand. It
+ * is a resource-constrained shortest path over the layered section graph: layer i holds the
+ * routing of section i, and moving from layer i to layer i+1 places the i-th VNF on the
+ * current node. Latency is the constrained resource. Labels are compared only when they
+ * share the same set of hosts, since the availability of a chain depends on it.
+********************************************************************************************/
+class Pricing {
+
+private:
+	const Data& 		data; 			/**< Data read in data.hpp **/
+	const int 			k; 				/**< The demand id. **/
+	const PricingCosts& costs; 			/**< The reduced cost components. **/
+	const int 			maxLabels; 		/**< The maximum number of labels created. **/
+
+	std::vector<std::vector<int> > 				outArcs; 		/**< outArcs[v] lists the arcs leaving node v. **/
+	std::vector<double> 						minDelay; 		/**< minDelay[v] is the smallest delay from node v to the demand target. **/
+	std::vector<Label> 							labels; 		/**< Every label created. **/
+	std::vector<std::vector<std::vector<int> > > bucket; 		/**< bucket[i][v] lists the labels of layer i sitting on node v. **/
+	bool 										truncated; 		/**< True if the label limit was reached. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. @param data The instance data. @param k The demand id. @param costs The reduced cost components. @param maxLabels The maximum number of labels created. **/
+	Pricing(const Data& data, const int k, const PricingCosts& costs, const int maxLabels);
+
+	/****************************************************************************************/
+	/*									Main operations  									*/
+	/****************************************************************************************/
+	/** Builds the chains of most negative reduced cost. @param maxColumns The maximum number of chains returned. @param threshold Only chains whose reduced cost is below it are returned. @param columns The chains found. @param reducedCosts Their reduced costs. **/
+	void run(const int maxColumns, const double threshold, std::vector<ChainPath>& columns, std::vector<double>& reducedCosts);
+
+	/** Computes the smallest delay from every node to the demand target. **/
+	void computeMinDelay();
+
+	/** Extends the labels of a layer through arcs until no new label appears. @param i The layer. @param worklist The labels to be extended. **/
+	void routeLayer(const int i, std::deque<int>& worklist);
+
+	/** Inserts a label in its bucket unless it is dominated, removing the labels it dominates. Returns true if it was inserted. @param label The label. **/
+	bool insert(const Label& label);
+
+	/** Returns the reduced cost of a complete label. **/
+	double getReducedCost(const Label& label) const;
+
+	/** Rebuilds the chain of a complete label. **/
+	ChainPath getChain(const int index) const;
+
+	/****************************************************************************************/
+	/*								      Query Methods	    	    	    				*/
+	/****************************************************************************************/
+	/** Returns true if the label limit was reached, in which case pricing is not exact. **/
+	const bool isTruncated() const { return truncated; }
+
+	/****************************************************************************************/
+	/*										Destructors			    						*/
+	/****************************************************************************************/
+	/** Destructor **/
+	~Pricing() {}
+};
+
+#endif
@@ -0,0 +1,238 @@
+#include "routing.hpp"
+
+/****************************************************************************************/
+/*										CONSTRUCTOR										*/
+/****************************************************************************************/
+
+Routing::Routing(const Data& data_) : data(data_)
+{
+    outArcs.resize(data.getNbNodes());
+    inArcs.resize(data.getNbNodes());
+    for (unsigned int a = 0; a < data.getLinks().size(); a++){
+        outArcs[data.getLink(a).getSource()].push_back(a);
+        inArcs[data.getLink(a).getTarget()].push_back(a);
+    }
+
+    /* Demands sharing the same bandwidth share the same usable arcs. */
+    std::vector<double> classBandwidth;
+    demandClass.resize(data.getNbDemands());
+    for (int k = 0; k < data.getNbDemands(); k++){
+        const double BANDWIDTH = data.getDemand(k).getBandwidth();
+        std::vector<double>::iterator it = std::find(classBandwidth.begin(), classBandwidth.end(), BANDWIDTH);
+        demandClass[k] = (int)(it - classBandwidth.begin());
+        if (it == classBandwidth.end()){
+            classBandwidth.push_back(BANDWIDTH);
+            computeShortestPaths(BANDWIDTH);
+        }
+    }
+}
+
+/****************************************************************************************/
+/*									MAIN OPERATIONS        								*/
+/****************************************************************************************/
+
+/* Computes the all-pairs delay shortest paths among arcs with at least a given bandwidth. */
+void Routing::computeShortestPaths(const double bandwidth)
+{
+    const int NB_NODES = data.getNbNodes();
+    std::vector<std::vector<double> > dist(NB_NODES, std::vector<double>(NB_NODES, DBL_MAX));
+    std::vector<std::vector<int> > next(NB_NODES, std::vector<int>(NB_NODES, -1));
+    for (int v = 0; v < NB_NODES; v++){
+        dist[v][v] = 0.0;
+    }
+    for (unsigned int a = 0; a < data.getLinks().size(); a++){
+        const Link& link = data.getLink(a);
+        if (link.getBandwidth() >= bandwidth && link.getDelay() < dist[link.getSource()][link.getTarget()]){
+            dist[link.getSource()][link.getTarget()] = link.getDelay();
+            next[link.getSource()][link.getTarget()] = a;
+        }
+    }
+    for (int m = 0; m < NB_NODES; m++){
+        for (int u = 0; u < NB_NODES; u++){
+            if (dist[u][m] == DBL_MAX){
+                continue;
+            }
+            for (int v = 0; v < NB_NODES; v++){
+                if (dist[m][v] != DBL_MAX && dist[u][m] + dist[m][v] < dist[u][v]){
+                    dist[u][v] = dist[u][m] + dist[m][v];
+                    next[u][v] = next[u][m];
+                }
+            }
+        }
+    }
+    delay.push_back(dist);
+    nextArc.push_back(next);
+}
+
+/* Looks for the shortest window of consecutive sections whose delay exceeds the demand latency. */
+bool Routing::findLatencyWindow(const int k, const std::vector<int>& hosts, int& first, int& last) const
+{
+    const Demand& demand      = data.getDemand(k);
+    const int     NB_VNFS     = (int)hosts.size();
+    const double  MAX_LATENCY = demand.getMaxLatency();
+
+    /* Section i goes from sequence[i] to sequence[i+1]. */
+    std::vector<int> sequence;
+    sequence.push_back(demand.getSource());
+    sequence.insert(sequence.end(), hosts.begin(), hosts.end());
+    sequence.push_back(demand.getTarget());
+    std::vector<double> sectionDelay(NB_VNFS + 1);
+    double total = 0.0;
+    for (int i = 0; i <= NB_VNFS; i++){
+        sectionDelay[i] = getDelay(k, sequence[i], sequence[i+1]);
+        total = std::min(DBL_MAX, total + sectionDelay[i]);
+    }
+    if (total <= MAX_LATENCY){
+        return false;
+    }
+
+    for (int length = 1; length <= NB_VNFS + 1; length++){
+        for (int a = 0; a + length - 1 <= NB_VNFS; a++){
+            const int b = a + length - 1;
+            double window = 0.0;
+            for (int i = a; i <= b; i++){
+                window = std::min(DBL_MAX, window + sectionDelay[i]);
+            }
+            if (window > MAX_LATENCY){
+                /* Sections a to b touch sequence[a] to sequence[b+1], that is, hosts a-1 to b. */
+                first = std::max(a, 1) - 1;
+                last  = std::min(b + 1, NB_VNFS) - 1;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* Checks the latency of every active path, demands being shared among the threads of a pool. */
+void Routing::separateLatency(const std::vector<std::vector<PathPlacement> >& placement, std::vector<LatencyCut>& cuts, TaskPool& pool) const
+{
+    const int NB_DEMANDS = (int)placement.size();
+    std::vector<std::vector<LatencyCut> > found(NB_DEMANDS);
+    pool.run(NB_DEMANDS, [&](int k){
+        for (unsigned int j = 0; j < placement[k].size(); j++){
+            LatencyCut cut;
+            cut.k = k;
+            cut.p = placement[k][j].p;
+            if (findLatencyWindow(k, placement[k][j].hosts, cut.first, cut.last)){
+                found[k].push_back(cut);
+            }
+        }
+    });
+
+    cuts.clear();
+    for (int k = 0; k < NB_DEMANDS; k++){
+        cuts.insert(cuts.end(), found[k].begin(), found[k].end());
+    }
+}
+
+/* Returns true if routing every section through its delay shortest path respects arc capacities. */
+bool Routing::isArcCapacityRespected(const std::vector<std::vector<PathPlacement> >& placement) const
+{
+    std::vector<double> load(data.getLinks().size(), 0.0);
+    for (unsigned int k = 0; k < placement.size(); k++){
+        const Demand& demand = data.getDemand(k);
+        for (unsigned int j = 0; j < placement[k].size(); j++){
+            const std::vector<int>& hosts = placement[k][j].hosts;
+            /* As in the compact model, the last section does not consume arc capacity. */
+            for (unsigned int i = 0; i < hosts.size(); i++){
+                const int source = (i == 0) ? demand.getSource() : hosts[i-1];
+                std::vector<int> route = getRoute(k, source, hosts[i]);
+                for (unsigned int r = 0; r < route.size(); r++){
+                    load[route[r]] += demand.getBandwidth();
+                }
+            }
+        }
+    }
+    for (unsigned int a = 0; a < load.size(); a++){
+        if (load[a] > data.getLink(a).getBandwidth() + 1e-6){
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Returns true if a joint routing MIP proves that no routing respects latencies and arc capacities. */
+bool Routing::isJointRoutingInfeasible(const std::vector<std::vector<PathPlacement> >& placement) const
+{
+    const int NB_ARCS = (int)data.getLinks().size();
+    bool infeasible = false;
+
+    /* Concert environments are not thread safe: each call builds its own. */
+    IloEnv routingEnv;
+    try
+    {
+        IloModel model(routingEnv);
+        std::vector<IloExpr> load;
+        for (int a = 0; a < NB_ARCS; a++){
+            load.push_back(IloExpr(routingEnv));
+        }
+        for (unsigned int k = 0; k < placement.size(); k++){
+            const Demand& demand = data.getDemand(k);
+            for (unsigned int j = 0; j < placement[k].size(); j++){
+                const std::vector<int>& hosts = placement[k][j].hosts;
+                const int NB_SECTIONS = (int)hosts.size() + 1;
+                IloExpr latency(routingEnv);
+                for (int i = 0; i < NB_SECTIONS; i++){
+                    const int source = (i == 0) ? demand.getSource() : hosts[i-1];
+                    const int target = (i == NB_SECTIONS - 1) ? demand.getTarget() : hosts[i];
+                    IloNumVarArray f(routingEnv, NB_ARCS, 0.0, 1.0, ILOINT);
+                    for (int v = 0; v < data.getNbNodes(); v++){
+                        IloExpr out(routingEnv);
+                        IloExpr flow(routingEnv);
+                        for (unsigned int r = 0; r < outArcs[v].size(); r++){
+                            out += f[outArcs[v][r]];
+                            flow += f[outArcs[v][r]];
+                        }
+                        for (unsigned int r = 0; r < inArcs[v].size(); r++){
+                            flow -= f[inArcs[v][r]];
+                        }
+                        double rhs = (v == source ? 1.0 : 0.0) - (v == target ? 1.0 : 0.0);
+                        model.add(IloRange(routingEnv, rhs, flow, rhs));
+                        model.add(IloRange(routingEnv, 0.0, out, 1.0));
+                        out.end();
+                        flow.end();
+                    }
+                    for (int a = 0; a < NB_ARCS; a++){
+                        latency += data.getLink(a).getDelay() * f[a];
+                        if (i < NB_SECTIONS - 1){
+                            load[a] += demand.getBandwidth() * f[a];
+                        }
+                    }
+                }
+                model.add(IloRange(routingEnv, 0.0, latency, demand.getMaxLatency()));
+                latency.end();
+            }
+        }
+        for (int a = 0; a < NB_ARCS; a++){
+            model.add(IloRange(routingEnv, 0.0, load[a], data.getLink(a).getBandwidth()));
+            load[a].end();
+        }
+
+        IloCplex cplex(model);
+        cplex.setOut(routingEnv.getNullStream());
+        cplex.setWarning(routingEnv.getNullStream());
+        cplex.setParam(IloCplex::Param::Threads, 1);
+        cplex.setParam(IloCplex::Param::TimeLimit, ROUTING_TIME_LIMIT);
+        cplex.solve();
+        infeasible = (cplex.getStatus() == IloAlgorithm::Infeasible);
+    }
+    catch (const IloException& e) { std::cerr << "ERROR: Joint routing failed: " << e << std::endl; }
+    routingEnv.end();
+    return infeasible;
+}
+
+/****************************************************************************************/
+/*									QUERY METHODS        								*/
+/****************************************************************************************/
+
+/* Returns the ordered list of arcs of the delay shortest path from u to v usable by a given demand. */
+std::vector<int> Routing::getRoute(const int k, const int u, const int v) const
+{
+    std::vector<int> route;
+    const int c = demandClass[k];
+    for (int w = u; w != v && nextArc[c][w][v] != -1; w = data.getLink(nextArc[c][w][v]).getTarget()){
+        route.push_back(nextArc[c][w][v]);
+    }
+    return route;
+}
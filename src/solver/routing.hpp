@@ -0,0 +1,104 @@
+#ifndef __routing__hpp
+#define __routing__hpp
+
+/****************************************************************************************/
+/*										LIBRARIES										*/
+/****************************************************************************************/
+
+/*** C++ Libraries ***/
+#include <vector>
+
+/*** CPLEX Libraries ***/
+#include <ilcplex/ilocplex.h>
+ILOSTLBEGIN
+
+/*** Own Libraries ***/
+#include "../instance/data.hpp"
+#include "../tools/taskpool.hpp"
+
+/****************************************************************************************/
+/*										DEFINES			    							*/
+/****************************************************************************************/
+#define ROUTING_TIME_LIMIT 1 // Time limit in seconds of a joint routing MIP, which blocks a callback thread
+
+/********************************************************************************************
+ * The hosts of an active path within a placement: hosts[i] is the node hosting the i-th VNF
+ * of the demand on path p.
+********************************************************************************************/
+struct PathPlacement {
+	int 				p; 			/**< The path index. **/
+	std::vector<int> 	hosts; 		/**< hosts[i] is the node hosting the i-th VNF. **/
+};
+
+/********************************************************************************************
+ * A set of consecutive VNFs of a path whose placement alone violates the demand latency:
+ * the VNFs first to last cannot be hosted by the same nodes on any path. If first > last,
+ * the demand cannot be routed at all.
+********************************************************************************************/
+struct LatencyCut {
+	int 	k; 			/**< The demand id. **/
+	int 	p; 			/**< The path where the violation was found. **/
+	int 	first; 		/**< The first VNF index of the window. **/
+	int 	last; 		/**< The last VNF index of the window. **/
+};
+
+/********************************************************************************************
+ * This class solves the routing subproblems of the Benders decomposition, where the master
+ * only decides the placement. Given the hosts of every active path, sections are routed
+ * through delay shortest paths, which is an exact latency check for each demand taken
+ * alone. Demands are checked on the separation threads of the callback. Since routing is coupled across demands
+ * through arc capacities, a joint routing MIP is solved whenever the shortest routes
+ * overload an arc.
+********************************************************************************************/
+class Routing {
+
+private:
+	const Data& 	data; 			/**< Data read in data.hpp **/
+
+	std::vector<std::vector<int> > 					outArcs; 		/**< outArcs[v] lists the arcs leaving node v. **/
+	std::vector<std::vector<int> > 					inArcs; 		/**< inArcs[v] lists the arcs entering node v. **/
+	std::vector<int> 								demandClass; 	/**< demandClass[k] indexes the delay matrices usable by demand k. **/
+	std::vector<std::vector<std::vector<double> > > delay; 			/**< delay[c][u][v] is the smallest delay from u to v among arcs fitting class c. **/
+	std::vector<std::vector<std::vector<int> > > 	nextArc; 		/**< nextArc[c][u][v] is the first arc of that shortest path, or -1. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. Computes the all-pairs delay shortest paths for each distinct demand bandwidth. @param data The instance data. **/
+	Routing(const Data& data);
+
+	/****************************************************************************************/
+	/*									Main operations  									*/
+	/****************************************************************************************/
+	/** Computes the all-pairs delay shortest paths among arcs with at least a given bandwidth. @param bandwidth The bandwidth. **/
+	void computeShortestPaths(const double bandwidth);
+
+	/** Looks for the shortest window of consecutive sections whose delay exceeds the demand latency. Returns false if the path respects latency. @param k The demand id. @param hosts The hosts of the path. @param first The first VNF index of the window. @param last The last VNF index of the window. **/
+	bool findLatencyWindow(const int k, const std::vector<int>& hosts, int& first, int& last) const;
+
+	/** Checks the latency of every active path, demands being shared among the threads of a pool. @param placement The active paths of each demand. @param cuts The violations found, sorted by demand. @param pool The threads sharing the demands. **/
+	void separateLatency(const std::vector<std::vector<PathPlacement> >& placement, std::vector<LatencyCut>& cuts, TaskPool& pool) const;
+
+	/** Returns true if routing every section through its delay shortest path respects arc capacities. @param placement The active paths of each demand. **/
+	bool isArcCapacityRespected(const std::vector<std::vector<PathPlacement> >& placement) const;
+
+	/** Returns true if a joint routing MIP proves that no routing respects latencies and arc capacities. @param placement The active paths of each demand. @note The MIP is built in its own environment. When it neither finds a routing nor proves there is none within ROUTING_TIME_LIMIT seconds, or fails, false is returned: the placement is then accepted rather than cut off by a no-good that could remove a routable placement, its routing being left unproven. **/
+	bool isJointRoutingInfeasible(const std::vector<std::vector<PathPlacement> >& placement) const;
+
+	/****************************************************************************************/
+	/*								      Query Methods	    	    	    				*/
+	/****************************************************************************************/
+	/** Returns the smallest delay from u to v usable by a given demand. **/
+	const double getDelay(const int k, const int u, const int v) const { return delay[demandClass[k]][u][v]; }
+	/** Returns the ordered list of arcs of the delay shortest path from u to v usable by a given demand. **/
+	std::vector<int> getRoute(const int k, const int u, const int v) const;
+
+	/****************************************************************************************/
+	/*										Destructors			    						*/
+	/****************************************************************************************/
+	/** Destructor **/
+	~Routing() {}
+};
+
+#endif
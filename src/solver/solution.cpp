@@ -0,0 +1,109 @@
+#include "solution.hpp"
+
+/****************************************************************************************/
+/*										CONSTRUCTOR										*/
+/****************************************************************************************/
+
+Solution::Solution(const Data& data_) : data(data_)
+{
+    successor.assign(data.getNbNodes(), -1);
+    clear();
+}
+
+/****************************************************************************************/
+/*									MAIN OPERATIONS        								*/
+/****************************************************************************************/
+
+/* Empties the solution, every path being unused. */
+void Solution::clear()
+{
+    const int NB_DEMANDS = data.getNbDemands();
+    loaded = false;
+    objValue = 0.0;
+    active.assign(NB_DEMANDS, std::vector<bool>());
+    paths.assign(NB_DEMANDS, std::vector<ChainPath>());
+    usedNodes.assign(NB_DEMANDS, std::vector<std::vector<int> >());
+    strayArcs.assign(NB_DEMANDS, std::vector<std::vector<int> >());
+    availValue.assign(NB_DEMANDS, std::vector<double>());
+    approxLogAvailValue.assign(NB_DEMANDS, std::vector<double>());
+    for (int k = 0; k < NB_DEMANDS; k++){
+        const int NB_PATHS = data.getNbPaths(k);
+        const int NB_VNFS  = data.getDemand(k).getNbVNFs();
+        ChainPath empty;
+        empty.hosts.assign(NB_VNFS, -1);
+        empty.sections.assign(NB_VNFS + 1, std::vector<int>());
+        active[k].assign(NB_PATHS, false);
+        paths[k].assign(NB_PATHS, empty);
+        usedNodes[k].assign(NB_PATHS, std::vector<int>());
+        strayArcs[k].assign(NB_PATHS, std::vector<int>(NB_VNFS + 1, 0));
+        availValue[k].assign(NB_PATHS, 0.0);
+        approxLogAvailValue[k].assign(NB_PATHS, 0.0);
+    }
+    placement.assign(data.getNbNodes(), std::vector<bool>(data.getNbVnfs(), false));
+}
+
+/* Orders the arcs routing a section by following the successor of each node from the section source. */
+void Solution::setSection(const int k, const int p, const int i, const std::vector<int>& arcs)
+{
+    std::vector<int>& section = paths[k][p].sections[i];
+    section.clear();
+    const int SOURCE = getSectionSource(k, p, i);
+    const int TARGET = getSectionTarget(k, p, i);
+    strayArcs[k][p][i] = (int)arcs.size();
+    if (SOURCE == -1 || TARGET == -1){
+        return;
+    }
+    for (unsigned int j = 0; j < arcs.size(); j++){
+        successor[data.getLink(arcs[j]).getSource()] = arcs[j];
+    }
+    int node = SOURCE;
+    while (node != TARGET && successor[node] != -1 && section.size() < arcs.size()){
+        section.push_back(successor[node]);
+        node = data.getLink(successor[node]).getTarget();
+    }
+    for (unsigned int j = 0; j < arcs.size(); j++){
+        successor[data.getLink(arcs[j]).getSource()] = -1;
+    }
+    strayArcs[k][p][i] = (int)(arcs.size() - section.size());
+}
+
+/****************************************************************************************/
+/*									QUERY METHODS        								*/
+/****************************************************************************************/
+
+/* Returns the source of the i-th section of path p of demand k. */
+const int Solution::getSectionSource(const int k, const int p, const int i) const
+{
+    return (i == 0) ? data.getDemand(k).getSource() : paths[k][p].hosts[i-1];
+}
+
+/* Returns the target of the i-th section of path p of demand k. */
+const int Solution::getSectionTarget(const int k, const int p, const int i) const
+{
+    return (i == (int)paths[k][p].hosts.size()) ? data.getDemand(k).getTarget() : paths[k][p].hosts[i];
+}
+
+/* Returns the availability of path p of demand k, 0 if it is not used. */
+const double Solution::getPathAvailability(const int k, const int p) const
+{
+    if (!active[k][p]){
+        return 0.0;
+    }
+    double path_availability = 1.0;
+    for (unsigned int j = 0; j < usedNodes[k][p].size(); j++){
+        path_availability *= data.getNode(usedNodes[k][p][j]).getAvailability();
+    }
+    return path_availability;
+}
+
+/* Returns the placement availability of demand k. */
+const double Solution::getPlacementAvailability(const int k) const
+{
+    double prob_all_paths_fail = 1.0;
+    for (unsigned int p = 0; p < active[k].size(); p++){
+        if (active[k][p]){
+            prob_all_paths_fail *= (1.0 - getPathAvailability(k, p));
+        }
+    }
+    return (1.0 - prob_all_paths_fail);
+}
@@ -0,0 +1,105 @@
+#ifndef __solution__hpp
+#define __solution__hpp
+
+/****************************************************************************************/
+/*										LIBRARIES										*/
+/****************************************************************************************/
+
+/*** C++ Libraries ***/
+#include <vector>
+
+/*** Own Libraries ***/
+#include "constructive.hpp"
+
+/********************************************************************************************
+ * This class caches a solution of the compact formulation once it has been read from CPLEX,
+ * so that reporting does not query CPLEX variable by variable. Each active path is kept as
+ * its hosts, its used nodes and the ordered arcs of its sections, the latter being chained
+ * through a successor array when the section is set. Queries then run in the size of the
+ * solution rather than the size of the model.
+********************************************************************************************/
+class Solution {
+
+private:
+	const Data& 						data; 				/**< Data read in data.hpp **/
+	bool 								loaded; 			/**< True once a solution has been stored. **/
+	double 								objValue; 			/**< The objective value. **/
+	std::vector<std::vector<bool> > 	active; 			/**< active[k][p] is true if path p of demand k is used. **/
+	std::vector<std::vector<ChainPath> > paths; 			/**< paths[k][p] are the hosts and routed sections of path p of demand k. **/
+	std::vector<std::vector<std::vector<int> > > usedNodes; /**< usedNodes[k][p] lists the nodes hosting a VNF of path p of demand k. **/
+	std::vector<std::vector<std::vector<int> > > strayArcs; /**< strayArcs[k][p][i] is the number of arcs of section i not chained from its source. **/
+	std::vector<std::vector<bool> > 	placement; 			/**< placement[v][f] is true if VNF f is installed on node v. **/
+	std::vector<std::vector<double> > 	availValue; 		/**< availValue[k][p] is the value of the availability variable of path p of demand k. **/
+	std::vector<std::vector<double> > 	approxLogAvailValue; /**< approxLogAvailValue[k][p] is the value of its approximated log. **/
+	std::vector<int> 					successor; 			/**< successor[v] is the arc leaving v in the section being set, -1 otherwise. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. The solution starts empty. @param data The instance data. **/
+	Solution(const Data& data);
+
+	/****************************************************************************************/
+	/*									Main operations  									*/
+	/****************************************************************************************/
+	/** Empties the solution, every path being unused. **/
+	void clear();
+
+	/** Orders the arcs routing the i-th section of path p of demand k from the section source. @param k The demand id. @param p The path index. @param i The section index. @param arcs The arcs used by the section, in any order. @note The hosts of the path must be set beforehand. **/
+	void setSection(const int k, const int p, const int i, const std::vector<int>& arcs);
+
+	/****************************************************************************************/
+	/*										   Setters  									*/
+	/****************************************************************************************/
+	/** Marks the solution as stored, with its objective value. **/
+	void setObjValue(const double value) { objValue = value; loaded = true; }
+	/** Sets whether path p of demand k is used. **/
+	void setActive(const int k, const int p, const bool value) { active[k][p] = value; }
+	/** Sets the node hosting the i-th VNF of path p of demand k. **/
+	void setHost(const int k, const int p, const int i, const int v) { paths[k][p].hosts[i] = v; }
+	/** Adds a node hosting a VNF of path p of demand k. **/
+	void addUsedNode(const int k, const int p, const int v) { usedNodes[k][p].push_back(v); }
+	/** Sets whether VNF f is installed on node v. **/
+	void setPlacement(const int v, const int f, const bool value) { placement[v][f] = value; }
+	/** Sets the value of the availability variable of path p of demand k and of its approximated log. **/
+	void setAvailValues(const int k, const int p, const double avail, const double approxLogAvail) { availValue[k][p] = avail; approxLogAvailValue[k][p] = approxLogAvail; }
+
+	/****************************************************************************************/
+	/*								      Query Methods	    	    	    				*/
+	/****************************************************************************************/
+	/** Returns true once a solution has been stored. **/
+	const bool isLoaded() const { return loaded; }
+	/** Returns the objective value. **/
+	const double getObjValue() const { return objValue; }
+	/** Returns true if path p of demand k is used. **/
+	const bool isActive(const int k, const int p) const { return active[k][p]; }
+	/** Returns the hosts and routed sections of path p of demand k. @note Sections are left empty if routing is delegated. **/
+	const ChainPath& getPath(const int k, const int p) const { return paths[k][p]; }
+	/** Returns the number of arcs used by the i-th section of path p of demand k that are not chained from its source. **/
+	const int getNbStrayArcs(const int k, const int p, const int i) const { return strayArcs[k][p][i]; }
+	/** Returns the nodes hosting a VNF of path p of demand k. **/
+	const std::vector<int>& getUsedNodes(const int k, const int p) const { return usedNodes[k][p]; }
+	/** Returns true if VNF f is installed on node v. **/
+	const bool isPlaced(const int v, const int f) const { return placement[v][f]; }
+	/** Returns the value of the availability variable of path p of demand k. **/
+	const double getAvailValue(const int k, const int p) const { return availValue[k][p]; }
+	/** Returns the value of the approximated log of the availability of path p of demand k. **/
+	const double getApproxLogAvailValue(const int k, const int p) const { return approxLogAvailValue[k][p]; }
+	/** Returns the source of the i-th section of path p of demand k. **/
+	const int getSectionSource(const int k, const int p, const int i) const;
+	/** Returns the target of the i-th section of path p of demand k. **/
+	const int getSectionTarget(const int k, const int p, const int i) const;
+	/** Returns the availability of path p of demand k, 0 if it is not used. **/
+	const double getPathAvailability(const int k, const int p) const;
+	/** Returns the placement availability of demand k. **/
+	const double getPlacementAvailability(const int k) const;
+
+	/****************************************************************************************/
+	/*										Destructors			    						*/
+	/****************************************************************************************/
+	/** Destructor **/
+	~Solution() {}
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "solutionpool.hpp"
+
+/****************************************************************************************/
+/*										CONSTRUCTOR										*/
+/****************************************************************************************/
+
+SolutionPool::SolutionPool() : incumbentObj(0.0), version(0), improvementObj(0.0), hasImprovement(false), closed(false)
+{
+}
+
+/****************************************************************************************/
+/*									MAIN OPERATIONS        								*/
+/****************************************************************************************/
+
+/* Publishes a solution found by the main search. */
+bool SolutionPool::offerIncumbent(const std::vector<double>& values, const double obj)
+{
+    std::lock_guard<std::mutex> lock(thread_flag);
+    if (version > 0 && obj >= incumbentObj){
+        return false;
+    }
+    incumbent = values;
+    incumbentObj = obj;
+    ++version;
+    updated.notify_all();
+    return true;
+}
+
+/* Retrieves the incumbent if it changed since a given version, waiting at most a given time for it. */
+bool SolutionPool::waitIncumbent(std::vector<double>& values, double& obj, int& knownVersion, const double seconds)
+{
+    std::unique_lock<std::mutex> lock(thread_flag);
+    if (version == knownVersion && !closed && seconds > 0.0){
+        updated.wait_for(lock, std::chrono::duration<double>(seconds));
+    }
+    if (version == knownVersion){
+        return false;
+    }
+    values = incumbent;
+    obj = incumbentObj;
+    knownVersion = version;
+    return true;
+}
+
+/* Publishes a solution found by a heuristic. */
+void SolutionPool::pushImprovement(const std::vector<double>& values, const double obj)
+{
+    std::lock_guard<std::mutex> lock(thread_flag);
+    if (hasImprovement && obj >= improvementObj){
+        return;
+    }
+    improvement = values;
+    improvementObj = obj;
+    hasImprovement = true;
+}
+
+/* Retrieves and removes the pending improvement. */
+bool SolutionPool::popImprovement(std::vector<double>& values, double& obj)
+{
+    std::lock_guard<std::mutex> lock(thread_flag);
+    if (!hasImprovement){
+        return false;
+    }
+    values.swap(improvement);
+    obj = improvementObj;
+    hasImprovement = false;
+    return true;
+}
+
+/* Closes the pool, waking up every heuristic waiting on it. */
+void SolutionPool::close()
+{
+    std::lock_guard<std::mutex> lock(thread_flag);
+    closed = true;
+    updated.notify_all();
+}
+
+/****************************************************************************************/
+/*									QUERY METHODS        								*/
+/****************************************************************************************/
+
+/* Returns true once the pool is closed. */
+bool SolutionPool::isClosed()
+{
+    std::lock_guard<std::mutex> lock(thread_flag);
+    return closed;
+}
@@ -0,0 +1,75 @@
+#ifndef __solutionpool__hpp
+#define __solutionpool__hpp
+
+/****************************************************************************************/
+/*										LIBRARIES										*/
+/****************************************************************************************/
+
+/*** C++ Libraries ***/
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+/********************************************************************************************
+ * This class exchanges solutions between the main search and the improvement heuristics
+ * running on their own threads. Solutions are plain vectors of values, indexed as the
+ * solution variables of a Model, so that they can be passed between environments. The main
+ * search publishes its incumbent and the heuristics publish their improvements. All methods
+ * are thread safe.
+********************************************************************************************/
+class SolutionPool {
+
+private:
+    std::mutex              thread_flag;        /**< A mutex for synchronizing multi-thread operations. **/
+    std::condition_variable updated;            /**< Notified when a new incumbent is published or the pool is closed. **/
+
+    std::vector<double>     incumbent;          /**< The best solution known by the main search. **/
+    double                  incumbentObj;       /**< The objective value of the incumbent. **/
+    int                     version;            /**< Number of incumbents published so far. **/
+
+    std::vector<double>     improvement;        /**< The best improving solution not yet posted to the main search. **/
+    double                  improvementObj;     /**< The objective value of the pending improvement. **/
+    bool                    hasImprovement;     /**< True if an improvement is pending. **/
+
+    bool                    closed;             /**< True once the main search is over. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+    /** Constructor. The pool starts empty and open. **/
+    SolutionPool();
+
+	/****************************************************************************************/
+	/*									Main operations  									*/
+	/****************************************************************************************/
+    /** Publishes a solution found by the main search. Returns true if it is better than the known incumbent. @param values The solution values. @param obj The solution objective value. **/
+    bool offerIncumbent(const std::vector<double>& values, const double obj);
+
+    /** Retrieves the incumbent if it changed since a given version, waiting at most a given time for it. Returns true if the incumbent was copied. @param values The incumbent values. @param obj The incumbent objective value. @param knownVersion The version already known, updated on return. @param seconds The maximum waiting time. **/
+    bool waitIncumbent(std::vector<double>& values, double& obj, int& knownVersion, const double seconds);
+
+    /** Publishes a solution found by a heuristic. It replaces the pending improvement only if it is better. @param values The solution values. @param obj The solution objective value. **/
+    void pushImprovement(const std::vector<double>& values, const double obj);
+
+    /** Retrieves and removes the pending improvement. Returns false if there is none. @param values The solution values. @param obj The solution objective value. **/
+    bool popImprovement(std::vector<double>& values, double& obj);
+
+    /** Closes the pool, waking up every heuristic waiting on it. **/
+    void close();
+
+	/****************************************************************************************/
+	/*								      Query Methods	    	    	    				*/
+	/****************************************************************************************/
+    /** Returns true once the pool is closed. **/
+    bool isClosed();
+
+	/****************************************************************************************/
+	/*										Destructors			    						*/
+	/****************************************************************************************/
+    /** Destructor **/
+    ~SolutionPool() {}
+};
+
+#endif
@@ -0,0 +1,192 @@
+#include "validator.hpp"
+
+/****************************************************************************************/
+/*										CONSTRUCTOR										*/
+/****************************************************************************************/
+
+Validator::Validator(const Data& data_, const bool checkRouting_) : data(data_), checkRouting(checkRouting_)
+{
+    nodeLoad.assign(data.getNbNodes(), 0.0);
+    arcLoad.assign(data.getLinks().size(), 0.0);
+    nodeOwner.assign(data.getNbNodes(), -1);
+}
+
+/****************************************************************************************/
+/*									MAIN OPERATIONS        								*/
+/****************************************************************************************/
+
+/* Checks a solution. Returns true if it is feasible. */
+bool Validator::validate(const Solution& solution)
+{
+    violations.clear();
+    for (int k = 0; k < data.getNbDemands(); k++){
+        std::vector<int> owned;
+        for (int p = 0; p < data.getNbPaths(k); p++){
+            if (!solution.isActive(k, p)){
+                continue;
+            }
+            validatePath(solution, k, p);
+
+            /* Disjunction: a node hosts VNFs of at most one path of the demand. */
+            const std::vector<int>& nodes = solution.getUsedNodes(k, p);
+            for (unsigned int j = 0; j < nodes.size(); j++){
+                if (nodeOwner[nodes[j]] != -1 && nodeOwner[nodes[j]] != p){
+                    addViolation(VIOLATION_DISJUNCTION, k, p, -1, nodes[j], 1.0);
+                }
+                else if (nodeOwner[nodes[j]] == -1){
+                    nodeOwner[nodes[j]] = p;
+                    owned.push_back(nodes[j]);
+                }
+            }
+        }
+        for (unsigned int j = 0; j < owned.size(); j++){
+            nodeOwner[owned[j]] = -1;
+        }
+
+        /* Exact placement availability, regardless of the approximation. */
+        const double MISSING = data.getDemand(k).getAvailability() - solution.getPlacementAvailability(k);
+        if (MISSING > VALIDATOR_EPS){
+            addViolation(VIOLATION_AVAILABILITY, k, -1, -1, -1, MISSING);
+        }
+    }
+    validateCapacities();
+    return violations.empty();
+}
+
+/* Checks the hosts and the routing of path p of demand k, and accumulates its loads. */
+void Validator::validatePath(const Solution& solution, const int k, const int p)
+{
+    const Demand&    demand  = data.getDemand(k);
+    const ChainPath& path    = solution.getPath(k, p);
+    const int        NB_VNFS = demand.getNbVNFs();
+
+    for (int i = 0; i < NB_VNFS; i++){
+        const int HOST = path.hosts[i];
+        if (HOST == -1){
+            addViolation(VIOLATION_UNPLACED_VNF, k, p, i, -1, 1.0);
+            continue;
+        }
+        const int VNF = demand.getVNF_i(i);
+        if (!solution.isPlaced(HOST, VNF)){
+            addViolation(VIOLATION_UNINSTALLED_VNF, k, p, i, HOST, 1.0);
+        }
+        if (nodeLoad[HOST] == 0.0){
+            touchedNodes.push_back(HOST);
+        }
+        nodeLoad[HOST] += demand.getBandwidth() * data.getVnf(VNF).getConsumption();
+    }
+    if (!checkRouting){
+        return;
+    }
+
+    /* Section i must be a path from the host of VNF i-1 to the host of VNF i. */
+    double latency = 0.0;
+    for (int i = 0; i <= NB_VNFS; i++){
+        const int SOURCE = solution.getSectionSource(k, p, i);
+        const int TARGET = solution.getSectionTarget(k, p, i);
+        const std::vector<int>& section = path.sections[i];
+        if (SOURCE == -1 || TARGET == -1){
+            continue;
+        }
+        const int END = section.empty() ? SOURCE : data.getLink(section.back()).getTarget();
+        if (END != TARGET || solution.getNbStrayArcs(k, p, i) > 0){
+            addViolation(VIOLATION_FLOW, k, p, i, END, 1.0);
+        }
+        for (unsigned int j = 0; j < section.size(); j++){
+            latency += data.getLink(section[j]).getDelay();
+            /* As in the compact model, the last section does not consume arc capacity. */
+            if (i < NB_VNFS){
+                if (arcLoad[section[j]] == 0.0){
+                    touchedArcs.push_back(section[j]);
+                }
+                arcLoad[section[j]] += demand.getBandwidth();
+            }
+        }
+    }
+    if (latency > demand.getMaxLatency() + VALIDATOR_EPS){
+        addViolation(VIOLATION_LATENCY, k, p, -1, -1, latency - demand.getMaxLatency());
+    }
+}
+
+/* Checks the loads accumulated on nodes and arcs, and resets them. */
+void Validator::validateCapacities()
+{
+    for (unsigned int j = 0; j < touchedNodes.size(); j++){
+        const int v = touchedNodes[j];
+        const double EXCESS = nodeLoad[v] - data.getNode(v).getCapacity();
+        if (EXCESS > VALIDATOR_EPS){
+            addViolation(VIOLATION_NODE_CAPACITY, -1, -1, -1, v, EXCESS);
+        }
+        nodeLoad[v] = 0.0;
+    }
+    for (unsigned int j = 0; j < touchedArcs.size(); j++){
+        const int a = touchedArcs[j];
+        const double EXCESS = arcLoad[a] - data.getLink(a).getBandwidth();
+        if (EXCESS > VALIDATOR_EPS){
+            addViolation(VIOLATION_ARC_CAPACITY, -1, -1, -1, a, EXCESS);
+        }
+        arcLoad[a] = 0.0;
+    }
+    touchedNodes.clear();
+    touchedArcs.clear();
+}
+
+/* Records a violation. */
+void Validator::addViolation(const Violation_Type type, const int k, const int p, const int i, const int element, const double excess)
+{
+    Violation violation;
+    violation.type    = type;
+    violation.k       = k;
+    violation.p       = p;
+    violation.i       = i;
+    violation.element = element;
+    violation.excess  = excess;
+    violations.push_back(violation);
+}
+
+/* Displays the violations found by the last validation. */
+void Validator::print() const
+{
+    if (violations.empty()){
+        std::cout << "Validation: solution is feasible." << std::endl;
+        return;
+    }
+    std::cout << "Validation: " << violations.size() << " violations found." << std::endl;
+    for (unsigned int j = 0; j < violations.size(); j++){
+        const Violation& violation = violations[j];
+        std::cout << "\t " << getTypeName(violation.type);
+        if (violation.k != -1){
+            std::cout << " k=" << violation.k+1;
+        }
+        if (violation.p != -1){
+            std::cout << " p=" << violation.p+1;
+        }
+        if (violation.i != -1){
+            std::cout << " i=" << violation.i+1;
+        }
+        if (violation.element != -1){
+            std::cout << " at " << violation.element;
+        }
+        std::cout << " by " << violation.excess << std::endl;
+    }
+}
+
+/****************************************************************************************/
+/*									QUERY METHODS        								*/
+/****************************************************************************************/
+
+/* Returns the name of a violation type. */
+std::string Validator::getTypeName(const Violation_Type type)
+{
+    switch (type){
+        case VIOLATION_UNPLACED_VNF:    return "UNPLACED VNF";
+        case VIOLATION_UNINSTALLED_VNF: return "UNINSTALLED VNF";
+        case VIOLATION_FLOW:            return "FLOW";
+        case VIOLATION_LATENCY:         return "LATENCY";
+        case VIOLATION_NODE_CAPACITY:   return "NODE CAPACITY";
+        case VIOLATION_ARC_CAPACITY:    return "ARC CAPACITY";
+        case VIOLATION_DISJUNCTION:     return "DISJUNCTION";
+        case VIOLATION_AVAILABILITY:    return "AVAILABILITY";
+        default:                        return "UNKNOWN";
+    }
+}
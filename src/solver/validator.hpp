@@ -0,0 +1,105 @@
+#ifndef __validator__hpp
+#define __validator__hpp
+
+/****************************************************************************************/
+/*										LIBRARIES										*/
+/****************************************************************************************/
+
+/*** C++ Libraries ***/
+#include <vector>
+#include <string>
+
+/*** Own Libraries ***/
+#include "solution.hpp"
+
+/****************************************************************************************/
+/*										DEFINES			    							*/
+/****************************************************************************************/
+#define VALIDATOR_EPS 1e-6 		// Excess above which a constraint is reported as violated
+
+/********************************************************************************************
+ * This class checks a solution against the original problem, independently of the MIP and
+ * of its availability approximation. Sections must route each VNF to the next one, capacity,
+ * latency and disjunction constraints must hold and the exact placement availability must
+ * meet the demand requirement. Violations are returned as data rather than printed. Loads
+ * are accumulated in buffers whose touched entries are reset after each call, so that a
+ * validation runs in the size of the solution and may be repeated on every incumbent.
+********************************************************************************************/
+class Validator {
+
+public:
+	/** Defines the constraint a violation refers to.**/
+	enum Violation_Type {
+		VIOLATION_UNPLACED_VNF = 0,
+		VIOLATION_UNINSTALLED_VNF = 1,
+		VIOLATION_FLOW = 2,
+		VIOLATION_LATENCY = 3,
+		VIOLATION_NODE_CAPACITY = 4,
+		VIOLATION_ARC_CAPACITY = 5,
+		VIOLATION_DISJUNCTION = 6,
+		VIOLATION_AVAILABILITY = 7
+	};
+
+	/** A violated constraint. Indexes that do not apply are set to -1. **/
+	struct Violation {
+		Violation_Type 	type; 		/**< The violated constraint. **/
+		int 			k; 			/**< The demand id. **/
+		int 			p; 			/**< The path index. **/
+		int 			i; 			/**< The VNF or section index. **/
+		int 			element; 	/**< The node or arc id. **/
+		double 			excess; 	/**< The amount by which the constraint is violated. **/
+	};
+
+private:
+	const Data& 			data; 			/**< Data read in data.hpp **/
+	bool 					checkRouting; 	/**< False if sections are not routed by the solution, as in the Benders master. **/
+	std::vector<Violation> 	violations; 	/**< The violations found by the last validation. **/
+
+	std::vector<double> 	nodeLoad; 		/**< nodeLoad[v] is the capacity used on node v. **/
+	std::vector<double> 	arcLoad; 		/**< arcLoad[a] is the bandwidth used on arc a. **/
+	std::vector<int> 		nodeOwner; 		/**< nodeOwner[v] is the path of the current demand using node v, -1 otherwise. **/
+	std::vector<int> 		touchedNodes; 	/**< The nodes whose load is non zero. **/
+	std::vector<int> 		touchedArcs; 	/**< The arcs whose load is non zero. **/
+
+	/** Records a violation. **/
+	void addViolation(const Violation_Type type, const int k, const int p, const int i, const int element, const double excess);
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. @param data The instance data. @param checkRouting False if sections are not routed by the solutions. **/
+	Validator(const Data& data, const bool checkRouting);
+
+	/****************************************************************************************/
+	/*									Main operations  									*/
+	/****************************************************************************************/
+	/** Checks a solution. Returns true if it is feasible. @param solution The solution. **/
+	bool validate(const Solution& solution);
+
+	/** Checks the hosts and the routing of path p of demand k, and accumulates its loads. **/
+	void validatePath(const Solution& solution, const int k, const int p);
+
+	/** Checks the loads accumulated on nodes and arcs, and resets them. **/
+	void validateCapacities();
+
+	/** Displays the violations found by the last validation. **/
+	void print() const;
+
+	/****************************************************************************************/
+	/*								      Query Methods	    	    	    				*/
+	/****************************************************************************************/
+	/** Returns the violations found by the last validation. **/
+	const std::vector<Violation>& getViolations() const { return violations; }
+
+	/** Returns the name of a violation type. **/
+	static std::string getTypeName(const Violation_Type type);
+
+	/****************************************************************************************/
+	/*										Destructors			    						*/
+	/****************************************************************************************/
+	/** Destructor **/
+	~Validator() {}
+};
+
+#endif
@@ -13,7 +13,7 @@ void greetingMessage(){
 std::string getParameter(int argc, char *argv[]){
     std::string param;
     if (argc != 2){
-		throw std::invalid_argument("A parameter file is required in the arguments.\n Please run the executable file in the following way: ./exec parameterFile.txt\n" );
+		throw std::invalid_argument("A parameter file is required in the arguments.\n Please run the executable file in the following way: ./exec parameterFile.txt\n or, for a batch of instances: ./exec -batch manifest.csv [threads [memoryMB]]\n or, as an admission service: ./exec -service parameterFile.txt [socketPath]\n" );
 	}
 	else{
 		param = argv[1];
@@ -0,0 +1,112 @@
+#include "taskpool.hpp"
+
+/****************************************************************************************/
+/*										Constructors									*/
+/****************************************************************************************/
+
+/* Constructor. Starts the worker threads. */
+TaskPool::TaskPool(const int nbThreads) : task(NULL), nbTasks(0), nextTask(0), nbBusy(0), batch(0), closed(false)
+{
+    for (int t = 1; t < nbThreads; t++){
+        workers.push_back(std::thread(&TaskPool::loop, this));
+    }
+}
+
+/****************************************************************************************/
+/*									Main operations  									*/
+/****************************************************************************************/
+
+/* Runs tasks 0 to n-1 and returns once all are done. */
+void TaskPool::run(const int n, const std::function<void(int)>& f)
+{
+    /* Without workers, or while they run another batch, the caller runs its tasks alone. */
+    std::unique_lock<std::mutex> batchLock(batch_flag, std::try_to_lock);
+    if (workers.empty() || n <= 1 || !batchLock.owns_lock()){
+        for (int i = 0; i < n; i++){
+            f(i);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(thread_flag);
+    task = &f;
+    nbTasks = n;
+    nextTask = 0;
+    failure = std::exception_ptr();
+    batch++;
+    started.notify_all();
+    work(lock);
+
+    /* The batch is over once every task was taken and no worker is still running one. */
+    finished.wait(lock, [this]{ return nbBusy == 0; });
+    task = NULL;
+    std::exception_ptr error = failure;
+    failure = std::exception_ptr();
+    lock.unlock();
+    if (error){
+        std::rethrow_exception(error);
+    }
+}
+
+/* Takes and runs the tasks of the running batch until none is left. */
+void TaskPool::work(std::unique_lock<std::mutex>& lock)
+{
+    while (nextTask < nbTasks){
+        const int TASK = nextTask++;
+        const std::function<void(int)>& f = *task;
+        lock.unlock();
+        try {
+            f(TASK);
+        }
+        catch (...) {
+            lock.lock();
+            if (!failure){
+                failure = std::current_exception();
+            }
+            /* The remaining tasks are skipped. */
+            nextTask = nbTasks;
+            continue;
+        }
+        lock.lock();
+    }
+}
+
+/* The loop of a worker thread, which waits for batches until the pool is closed. */
+void TaskPool::loop()
+{
+    int knownBatch = 0;
+    std::unique_lock<std::mutex> lock(thread_flag);
+    while (true){
+        started.wait(lock, [this, &knownBatch]{ return closed || batch != knownBatch; });
+        if (closed){
+            return;
+        }
+        knownBatch = batch;
+        if (task == NULL){
+            continue;
+        }
+        nbBusy++;
+        work(lock);
+        nbBusy--;
+        if (nbBusy == 0){
+            finished.notify_all();
+        }
+    }
+}
+
+/****************************************************************************************/
+/*										Destructors			    						*/
+/****************************************************************************************/
+
+/* Destructor. Stops and joins the worker threads. */
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(thread_flag);
+        closed = true;
+    }
+    started.notify_all();
+    for (unsigned int t = 0; t < workers.size(); t++){
+        workers[t].join();
+    }
+}
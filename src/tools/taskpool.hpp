@@ -0,0 +1,71 @@
+#ifndef __taskpool__hpp
+#define __taskpool__hpp
+
+/****************************************************************************************/
+/*										LIBRARIES										*/
+/****************************************************************************************/
+
+/*** C++ Libraries ***/
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+/********************************************************************************************
+ * This class runs batches of independent tasks, identified by their index, on a fixed set
+ * of worker threads. The calling thread takes part in each batch and returns once every task
+ * is done. A single batch runs at a time: while the workers are busy, a batch submitted from
+ * another thread is run by that thread alone, so that the pool never oversubscribes cores.
+ * Tasks must not call back into CPLEX, whose callback context is bound to the calling thread.
+********************************************************************************************/
+class TaskPool {
+
+private:
+    std::vector<std::thread>        workers;        /**< The worker threads. **/
+    std::mutex                      thread_flag;    /**< A mutex for synchronizing multi-thread operations. **/
+    std::mutex                      batch_flag;     /**< Held by the thread whose batch is running on the workers. **/
+    std::condition_variable         started;        /**< Notified when a batch is submitted or the pool is closed. **/
+    std::condition_variable         finished;       /**< Notified when a worker leaves the running batch. **/
+
+    const std::function<void(int)>* task;           /**< The task of the running batch, NULL if none. **/
+    int                             nbTasks;        /**< Number of tasks of the running batch. **/
+    int                             nextTask;       /**< Index of the next task to be taken. **/
+    int                             nbBusy;         /**< Number of workers within the running batch. **/
+    int                             batch;          /**< Number of batches submitted so far. **/
+    std::exception_ptr              failure;        /**< The first exception thrown by a task of the running batch. **/
+    bool                            closed;         /**< True once the pool is being destroyed. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+    /** Constructor. Starts the worker threads. @param nbThreads The number of threads running each batch, the calling one included. 1 or less runs every batch serially. **/
+    TaskPool(const int nbThreads);
+
+	/****************************************************************************************/
+	/*									Main operations  									*/
+	/****************************************************************************************/
+    /** Runs tasks 0 to n-1 and returns once all are done. The first exception thrown by a task is thrown again once the batch is over. @param n The number of tasks. @param f The task, called with the task index. **/
+    void run(const int n, const std::function<void(int)>& f);
+
+    /** Returns the number of threads running each batch, the calling one included. **/
+    int getNbThreads() const { return (int)workers.size() + 1; }
+
+private:
+    /** Takes and runs the tasks of the running batch until none is left. @note Should only be called with thread_flag locked, which is released while a task runs. **/
+    void work(std::unique_lock<std::mutex>& lock);
+
+    /** The loop of a worker thread, which waits for batches until the pool is closed. **/
+    void loop();
+
+public:
+	/****************************************************************************************/
+	/*										Destructors			    						*/
+	/****************************************************************************************/
+    /** Destructor. Stops and joins the worker threads. **/
+    ~TaskPool();
+};
+
+#endif